@@ -30,6 +30,13 @@ void FRANKLYBOOT_Init(void);
  */
 void FRANKLYBOOT_Run(void);
 
+/**
+ * @brief Determines the CAN node ID (stored assignment or default node ID)
+ *
+ * Called before the CAN filters are set up.
+ */
+uint32_t FRANKLYBOOT_loadCANNodeID(void);
+
 /**
  * @brief Returns the system tick frequency in Hz
  */
@@ -40,6 +47,18 @@ uint32_t FRANKLYBOOT_getDevSysTickHz(void);
  */
 void FRANKLYBOOT_autoStartISR(void);
 
+/**
+ * @brief Called by CAN TX mailbox empty ISR to send the next queued responses
+ */
+void FRANKLYBOOT_canTxISR(void);
+
+/**
+ * @brief Called by CAN RX FIFO 0 and 1 ISRs to move received frames into the RX ring buffer
+ *
+ * Located in RAM, so frames are received while the flash is busy.
+ */
+void FRANKLYBOOT_canRxISR(void);
+
 #ifdef __cplusplus
 };
 #endif
@@ -20,7 +20,8 @@
 
 namespace device {
 
-constexpr uint32_t SYS_TICK = {16000000U};
+constexpr uint32_t SYS_TICK = {16000000U};       // HSI16 after reset
+constexpr uint32_t SYS_TICK_BOOST = {80000000U};  // PLL during update sessions
 
 constexpr uint32_t VENDOR_ID = {0x45445541U};
 constexpr uint32_t PRODUCT_ID = {0x00000001U};
@@ -31,6 +32,10 @@ constexpr uint32_t FLASH_APP_FIRST_PAGE = {4U};
 constexpr uint32_t FLASH_SIZE = {128 * 1024U};
 constexpr uint32_t FLASH_PAGE_SIZE = {2048U};
 constexpr uint32_t FLASH_APP_START_ADDR = FLASH_START_ADDR + FLASH_APP_FIRST_PAGE * FLASH_PAGE_SIZE;
+
+// Node ID assignments are stored in the last 256 bytes of the OTP area (1 KB at 0x1FFF7000, FRANKLYBOOT_NODE_ID_OTP)
+constexpr uint32_t OTP_NODE_ID_ADDR = {0x1FFF7300U};
+constexpr uint32_t OTP_NODE_ID_NUM_RECORDS = {32U};
 };  // namespace device
 
 #endif /* __cplusplus */
@@ -38,6 +43,22 @@ constexpr uint32_t FLASH_APP_START_ADDR = FLASH_START_ADDR + FLASH_APP_FIRST_PAG
 // Defines ------------------------------------------------------------------------------------------------------------
 
 #define CAN_BROADCAST_ID (uint16_t)(0x780U)
+#define CAN_BROADCAST_DATA_ID (uint16_t)(0x77FU)
 #define CAN_NODE_ID (uint16_t)(1)
 
+// Node IDs can be assigned at runtime (see FRANKLYBOOT_loadCANNodeID()). Node n receives requests on
+// CAN_NODE_REQ_ID(n) and responds on CAN_NODE_REQ_ID(n) + 1, so 63 node IDs fit below 0x800.
+#define CAN_NUM_NODE_IDS (uint16_t)(63U)
+#define CAN_NODE_REQ_ID(node_id) (uint16_t)(CAN_BROADCAST_ID + 1U + ((node_id) << 1U))
+
+// Default node ID without stored assignment: CAN_NODE_ID (0) or derived from the unique ID (1)
+#ifndef FRANKLYBOOT_NODE_ID_FROM_UID
+#define FRANKLYBOOT_NODE_ID_FROM_UID 0
+#endif
+
+// Assignments are kept until reset (0) or stored in the OTP area (1, write once: 32 records)
+#ifndef FRANKLYBOOT_NODE_ID_OTP
+#define FRANKLYBOOT_NODE_ID_OTP 0
+#endif
+
 #endif /* DEVICE_DEFINES_H_ */
\ No newline at end of file
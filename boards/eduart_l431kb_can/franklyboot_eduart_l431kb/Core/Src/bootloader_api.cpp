@@ -13,23 +13,188 @@
 #include "bootloader_api.h"
 
 #include <francor/franklyboot/handler.h>
+#include <string.h>
 
+#include "bcast_update.h"
+#include "can_bit_timing.h"
 #include "device_defines.h"
+#include "discovery.h"
+#include "isr_queue.h"
+#include "node_id.h"
+#include "page_patch.h"
+#include "page_skip.h"
+#include "page_stream.h"
+#include "req_window.h"
 #include "stm32l4xx.h"
 
 using namespace franklyboot;
+
 // Defines ------------------------------------------------------------------------------------------------------------
 
 constexpr uint32_t AUTOBOOT_DISABLE_OVERRIDE_KEY = {0xDEADBEEFU};
-constexpr uint32_t MSG_TIMEOUT_CNT = {device::SYS_TICK / 2000U};
 constexpr uint32_t MSG_SIZE = {8U};
 
+using BootloaderHandler =
+    Handler<device::FLASH_START_ADDR, device::FLASH_APP_FIRST_PAGE, device::FLASH_SIZE, device::FLASH_PAGE_SIZE>;
+using BootloaderPageStream = ext::PageStream<BootloaderHandler, device::FLASH_PAGE_SIZE>;
+
+// Page erase is deferred until the page is written, pages which hold the data already are skipped
+using FlashPageSkip = ext::PageSkip<device::FLASH_START_ADDR, device::FLASH_PAGE_SIZE, 8U>;
+
+// Delta patches are applied in a separate page buffer
+using BootloaderPagePatch = ext::PagePatch<device::FLASH_START_ADDR, device::FLASH_APP_FIRST_PAGE, device::FLASH_SIZE,
+                                           device::FLASH_PAGE_SIZE>;
+
+// Identical nodes are updated together with broadcast page data, status responses are sent in the slot
+// of the node
+using BootloaderBroadcastUpdate = ext::BroadcastUpdate<device::FLASH_START_ADDR, device::FLASH_APP_FIRST_PAGE,
+                                                       device::FLASH_SIZE, device::FLASH_PAGE_SIZE>;
+
+// Node ID assigned at runtime, optionally stored in the OTP area (build options in device_defines.h)
+using BootloaderNodeID = ext::NodeID<CAN_NUM_NODE_IDS, device::OTP_NODE_ID_NUM_RECORDS>;
+constexpr bool NODE_ID_FROM_UID = {FRANKLYBOOT_NODE_ID_FROM_UID != 0};
+constexpr bool NODE_ID_OTP = {FRANKLYBOOT_NODE_ID_OTP != 0};
+static_assert(CAN_NODE_ID < CAN_NUM_NODE_IDS, "CAN_NODE_ID is not a valid node ID");
+
+// Outstanding requests granted to the host (RX ring buffer holds 1024 frames)
+constexpr uint32_t REQ_WINDOW_SIZE = {16U};
+
+// CRC unit is fed by DMA in one transfer (channel is only used by hwi::calculateCRC(), 16 bit transfer counter)
+static_assert((device::FLASH_SIZE / 4U) <= 0xFFFFU, "Flash does not fit into one CRC DMA transfer");
+
+// Flash programming: rows of 32 double words in fast programming mode, otherwise double words
+constexpr uint32_t FLASH_ROW_SIZE = {256U};
+constexpr uint32_t FLASH_SR_ERRORS = {FLASH_SR_OPERR | FLASH_SR_PROGERR | FLASH_SR_WRPERR | FLASH_SR_PGAERR |
+                                      FLASH_SR_SIZERR | FLASH_SR_PGSERR | FLASH_SR_MISERR | FLASH_SR_FASTERR};
+// Program complete rows in fast programming mode (interrupts are masked for each row). The CAN RX FIFOs
+// (2 x 3 frames) are not emptied during a row, so rows are only programmed while the host waits for every
+// response: request window closed, no broadcast update streaming and no backlog in the RX ring buffer.
+// Otherwise the page is programmed in double words.
+constexpr bool FLASH_FAST_PROGRAMMING = {true};
+
+/**
+ * Flash programming statistics (read via debugger)
+ */
+struct FlashStats {
+  uint32_t num_rows;                  //!< Number of rows programmed in fast programming mode
+  uint32_t num_double_words;          //!< Number of double words programmed in standard mode
+  uint32_t num_skipped_double_words;  //!< Number of double words not programmed (flash equal to data)
+  uint32_t num_errors;                //!< Number of failed erase or programming operations
+  uint32_t op_cycles_last;            //!< CPU cycles from start to end of the last erase or programming operation
+  uint32_t write_cycles_last;         //!< CPU cycles the last hwi::writeDataBufferToFlash() blocked the main loop
+};
+
+/**
+ * Asynchronous flash operation, started by the hardware interface and advanced by flashPoll()
+ */
+struct FlashJob {
+  bool active;                       //!< Operation in progress
+  bool erase;                        //!< Page erase (otherwise programming)
+  bool erase_pending;                //!< Erase command is issued by the next flashPoll()
+  bool program_after_erase;          //!< Range is programmed when the erase is finished (same job)
+  bool error;                        //!< Last operation failed (reported by the next operation)
+  bool fast_rows;                    //!< Complete rows may be programmed in fast programming mode
+  uint32_t* dst_word_ptr;            //!< Next flash word to program
+  const uint32_t* dst_word_max_ptr;  //!< End of flash range to program
+  const uint32_t* src_word_ptr;      //!< Next word of the program buffer
+  uint32_t erase_page_id;            //!< Page of a pending erase command
+  uint32_t start_cycles;             //!< Cycle counter at start of the operation
+};
+
+/**
+ * CRC calculation statistics (read via debugger)
+ */
+struct CRCStats {
+  uint32_t num_bytes_last;    //!< Number of bytes of the last calculation
+  uint32_t cycles_last;       //!< CPU cycles of the last calculation
+  uint32_t bytes_per_s_last;  //!< Throughput of the last calculation
+};
+
+// Software TX queue in front of the three CAN TX mailboxes (size must be a power of two)
+constexpr uint32_t TX_QUEUE_SIZE = {8U};
+
+// RAM ring buffer in SRAM2 filled by the CAN RX FIFO ISR (size must be a power of two). Broadcast frames
+// (FIFO 1) are moved first, so a broadcast received before a node request is processed before it.
+constexpr uint32_t RX_RING_SIZE = {1024U};
+
+// Bit rate on the bus. The bit timing is derived from the kernel clock (PCLK1 = system clock) with the
+// sample point of the initial configuration in main.c.
+constexpr uint32_t CAN_BIT_RATE = {500000U};
+constexpr uint32_t CAN_SAMPLE_POINT = {875U};
+
+// Vector table copy in RAM (16 core + 83 device vectors, rounded up to the VTOR alignment)
+constexpr uint32_t VECTOR_TABLE_SIZE = {128U};
+
+// Code executed while the flash is busy must not be fetched from flash
+#define RAM_FUNC __attribute__((section(".RamFunc")))
+
+// Uninitialized buffers placed in SRAM2
+#define RAM2_NOINIT __attribute__((section(".ram2")))
+
+/**
+ * Encoded CAN frame data
+ */
+struct CANFrameData {
+  uint32_t low;
+  uint32_t high;
+};
+
+/**
+ * Received CAN frame
+ */
+struct CANRxFrame {
+  CANFrameData data;
+  uint32_t std_id;  //!< Standard identifier (broadcast, broadcast data or node ID)
+};
+
 // Private Variables --------------------------------------------------------------------------------------------------
 static volatile bool autostart_possible = {false};
 static volatile bool req_autostart = {false};
 
+static ext::RequestWindow<REQ_WINDOW_SIZE> req_window;
+
+static volatile CRCStats crc_stats;
+static volatile FlashStats flash_stats;
+
+// Second page buffer: the page is programmed from this copy while the handler fills its page buffer
+static FlashJob flash_job;
+static uint32_t flash_program_buffer[device::FLASH_PAGE_SIZE / 4U];
+static FlashPageSkip page_skip;
+static BootloaderPagePatch page_patch;
+static BootloaderBroadcastUpdate bcast_update(0U, device::SYS_TICK);
+static ext::Discovery discovery(device::SYS_TICK);
+static BootloaderNodeID node_id;
+
+// TX queue. Pushed by the main loop, popped when a frame is moved into a free TX mailbox (main loop with
+// TX IRQ disabled or TX mailbox empty ISR).
+static ext::IsrQueue<CANFrameData, TX_QUEUE_SIZE> tx_queue;
+
+// TX diagnostic counters (read via debugger)
+static volatile uint32_t tx_drop_cnt = {0U};
+static volatile uint32_t tx_abort_cnt = {0U};
+
+// System clock (SYS_TICK after reset, SYS_TICK_BOOST during update sessions) and settings derived from it
+static uint32_t sys_clock_hz = {device::SYS_TICK};
+static uint32_t stream_timeout_cnt = {device::SYS_TICK / 200U};
+static uint32_t tx_timeout_cnt = {device::SYS_TICK / 100U};
+
+// RX ring buffer. Pushed by the RX FIFO ISR, popped by the main loop. Counters are reset by initCANRx().
+static ext::IsrQueue<CANRxFrame, RX_RING_SIZE> rx_ring RAM2_NOINIT;
+
+// RX diagnostic counters (read via debugger)
+static volatile uint32_t rx_ring_overrun_cnt = {0U};
+static volatile uint32_t rx_fifo_overrun_cnt[2U] = {0U, 0U};
+
+// Vector table copy, so interrupts are served while the flash is erased or programmed
+static uint32_t ram_vector_table[VECTOR_TABLE_SIZE] __attribute__((aligned(VECTOR_TABLE_SIZE * 4U))) RAM2_NOINIT;
+
 // Private Function Prototypes ----------------------------------------------------------------------------------------
 
+static RAM_FUNC void flashPoll(void);
+static RAM_FUNC void flashFinish(void);
+static bool storeNodeIDRecord(const uint32_t record_idx, const ext::NodeIDRecord& record);
+static void transmitResponse(const msg::Msg& response);
+
 /**
  * @brief Checks if autostart shall be aborted by ping message request
  */
@@ -43,38 +208,100 @@ static void checkAutoStartAbort(msg::Msg& request) {
 }
 
 /**
- * @brief Block until message is received via CAN
+ * @brief Relocate vector table to RAM and enable CAN RX FIFO interrupts
+ */
+static void initCANRx(void) {
+  const uint32_t* flash_vector_table = (uint32_t*)(SCB->VTOR);
+  for (uint32_t idx = 0U; idx < VECTOR_TABLE_SIZE; idx++) {
+    ram_vector_table[idx] = flash_vector_table[idx];
+  }
+  __DSB();
+  SCB->VTOR = (uint32_t)(ram_vector_table);
+  __DSB();
+
+  rx_ring.reset();
+  SET_BIT(CAN1->IER, CAN_IER_FMPIE0 | CAN_IER_FOVIE0 | CAN_IER_FMPIE1 | CAN_IER_FOVIE1);
+  NVIC_SetPriority(CAN1_RX0_IRQn, 1);
+  NVIC_SetPriority(CAN1_RX1_IRQn, 1);
+  NVIC_EnableIRQ(CAN1_RX0_IRQn);
+  NVIC_EnableIRQ(CAN1_RX1_IRQn);
+}
+
+/**
+ * @brief Stop CAN RX interrupts before handing over to the application
  */
-static void waitForMessage(msg::Msg& request) {
-  std::array<std::uint8_t, MSG_SIZE> buffer;
+static void deinitCANRx(void) {
+  NVIC_DisableIRQ(CAN1_RX0_IRQn);
+  NVIC_DisableIRQ(CAN1_RX1_IRQn);
+  CLEAR_BIT(CAN1->IER, CAN_IER_FMPIE0 | CAN_IER_FOVIE0 | CAN_IER_FMPIE1 | CAN_IER_FOVIE1);
+  NVIC_ClearPendingIRQ(CAN1_RX0_IRQn);
+  NVIC_ClearPendingIRQ(CAN1_RX1_IRQn);
+}
 
+/**
+ * @brief Read frame from RX ring buffer
+ */
+static inline bool rxRingPop(CANRxFrame& frame) {
+  if (!rx_ring.isEmpty()) {
+    frame = rx_ring.front();
+    rx_ring.pop();
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Block until message is received via CAN
+ *
+ * Data blocks of a broadcast update are consumed and status and discovery responses are sent in the slot of
+ * the node while waiting. An open page stream is aborted if no frame is received within stream_timeout_cnt loops.
+ *
+ * @return Standard identifier of the received frame
+ */
+static uint32_t waitForMessage(std::array<std::uint8_t, MSG_SIZE>& buffer, BootloaderPageStream& page_stream) {
   for (;;) {
+    // Advance erase or programming of the previous page while waiting
+    flashPoll();
+
+    msg::Msg slot_response;
+    if (bcast_update.poll(DWT->CYCCNT, slot_response) || discovery.poll(DWT->CYCCNT, slot_response)) {
+      transmitResponse(slot_response);
+    }
+
     // Check for autostart override
     if (req_autostart) {
       hwi::startApp(device::FLASH_APP_START_ADDR);
     } else {
       // Otherwise wait for data
-      const uint8_t rx_msg_pending = ((CAN1->RF0R & CAN_RF0R_FMP0_Msk) != 0);
-      if (rx_msg_pending) {
+      CANRxFrame frame;
+      if (rxRingPop(frame)) {
         // Copy data to buffer
-        buffer[0U] = static_cast<uint8_t>(CAN1->sFIFOMailBox[0].RDLR);
-        buffer[1U] = static_cast<uint8_t>(CAN1->sFIFOMailBox[0].RDLR >> 8U);
-        buffer[2U] = static_cast<uint8_t>(CAN1->sFIFOMailBox[0].RDLR >> 16U);
-        buffer[3U] = static_cast<uint8_t>(CAN1->sFIFOMailBox[0].RDLR >> 24U);
-        buffer[4U] = static_cast<uint8_t>(CAN1->sFIFOMailBox[0].RDHR);
-        buffer[5U] = static_cast<uint8_t>(CAN1->sFIFOMailBox[0].RDHR >> 8U);
-        buffer[6U] = static_cast<uint8_t>(CAN1->sFIFOMailBox[0].RDHR >> 16U);
-        buffer[7U] = static_cast<uint8_t>(CAN1->sFIFOMailBox[0].RDHR >> 24U);
-
-        // Release data from RX FIFO
-        CAN1->RF0R = CAN1->RF0R | CAN_RF0R_RFOM0;
-
-        break;
+        buffer[0U] = static_cast<uint8_t>(frame.data.low);
+        buffer[1U] = static_cast<uint8_t>(frame.data.low >> 8U);
+        buffer[2U] = static_cast<uint8_t>(frame.data.low >> 16U);
+        buffer[3U] = static_cast<uint8_t>(frame.data.low >> 24U);
+        buffer[4U] = static_cast<uint8_t>(frame.data.high);
+        buffer[5U] = static_cast<uint8_t>(frame.data.high >> 8U);
+        buffer[6U] = static_cast<uint8_t>(frame.data.high >> 16U);
+        buffer[7U] = static_cast<uint8_t>(frame.data.high >> 24U);
+
+        if (frame.std_id != CAN_BROADCAST_DATA_ID) {
+          return frame.std_id;
+        }
+
+        bcast_update.feed(buffer.data());
+        continue;
       }
+
+      page_stream.checkTimeout(stream_timeout_cnt);
     }
   }
+}
 
-  /* Decode message */
+/**
+ * @brief Decodes request from received message buffer
+ */
+static void decodeMessage(const std::array<std::uint8_t, MSG_SIZE>& buffer, msg::Msg& request) {
   const uint16_t rx_request_raw = static_cast<uint16_t>(buffer[0U]) | static_cast<uint16_t>(buffer[1U] << 8U);
   request.request = static_cast<msg::RequestType>(rx_request_raw);
   request.result = static_cast<msg::ResultType>(buffer[2U]);
@@ -86,7 +313,47 @@ static void waitForMessage(msg::Msg& request) {
 }
 
 /**
- * @brief Transmit response over CAN
+ * @brief Move queued frames into all empty TX mailboxes
+ *
+ * Must be called from the CAN TX ISR or with the CAN TX interrupt disabled.
+ */
+static void txQueueFillMailboxes(void) {
+  while (!tx_queue.isEmpty() && ((CAN1->TSR & CAN_TSR_TME) != 0U)) {
+    // Code field holds the number of the next empty mailbox
+    const uint32_t mailbox_idx = (CAN1->TSR & CAN_TSR_CODE_Msk) >> CAN_TSR_CODE_Pos;
+    const CANFrameData& frame = tx_queue.front();
+
+    CAN1->sTxMailBox[mailbox_idx].TDLR = frame.low;
+    CAN1->sTxMailBox[mailbox_idx].TDHR = frame.high;
+    CAN1->sTxMailBox[mailbox_idx].TIR |= CAN_TI0R_TXRQ;
+
+    tx_queue.pop();
+  }
+}
+
+/**
+ * @brief Wait until all queued frames are transmitted (bounded if nobody acknowledges the frames)
+ */
+static void txQueueFlush(void) {
+  uint32_t timeout_cnt = 0U;
+
+  while ((!tx_queue.isEmpty() || ((CAN1->TSR & CAN_TSR_TME) != CAN_TSR_TME)) &&
+         (timeout_cnt < tx_timeout_cnt)) {
+    timeout_cnt++;
+  }
+}
+
+/**
+ * @brief Stop CAN TX interrupt before handing over to the application
+ */
+static void deinitCANTx(void) {
+  NVIC_DisableIRQ(CAN1_TX_IRQn);
+  CLEAR_BIT(CAN1->IER, CAN_IER_TMEIE);
+  NVIC_ClearPendingIRQ(CAN1_TX_IRQn);
+}
+
+/**
+ * @brief Queue response for transmission over CAN
  */
 static void transmitResponse(const msg::Msg& response) {
   /* Encode message */
@@ -99,20 +366,245 @@ static void transmitResponse(const msg::Msg& response) {
   tx_data_h |= (static_cast<uint32_t>(response.data.at(2)) << 16U);
   tx_data_h |= (static_cast<uint32_t>(response.data.at(3)) << 24U);
 
-  CAN1->sTxMailBox[0].TDLR = tx_data_l;
-  CAN1->sTxMailBox[0].TDHR = tx_data_h;
+  /* Wait for free slot in TX queue, drop response if the bus does not accept frames */
+  uint32_t timeout_cnt = 0U;
+  while (tx_queue.isFull()) {
+    timeout_cnt++;
+    if (timeout_cnt >= tx_timeout_cnt) {
+      tx_drop_cnt++;
+      return;
+    }
+  }
+
+  tx_queue.push({tx_data_l, tx_data_h});
 
   /* Transmit message */
-  CAN1->sTxMailBox[0].TIR |= CAN_TI0R_TXRQ;
+  NVIC_DisableIRQ(CAN1_TX_IRQn);
+  txQueueFillMailboxes();
+  NVIC_EnableIRQ(CAN1_TX_IRQn);
+}
+
+/**
+ * @brief Enable the DWT cycle counter used for CRC instrumentation
+ */
+static void initCycleCounter(void) {
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Switch system clock between HSI16 (SYS_TICK) and PLL (SYS_TICK_BOOST)
+ *
+ * PLL: HSI16 / 1 * 10 / 2 = 80 MHz in range 1 with 4 flash wait states.
+ */
+static void switchSysClock(const bool boost) {
+  if (boost) {
+    MODIFY_REG(FLASH->ACR, FLASH_ACR_LATENCY, FLASH_ACR_LATENCY_4WS);
+    SET_BIT(FLASH->ACR, FLASH_ACR_PRFTEN);
+    while ((FLASH->ACR & FLASH_ACR_LATENCY) != FLASH_ACR_LATENCY_4WS) {
+      __NOP();
+    }
+
+    RCC->PLLCFGR = RCC_PLLCFGR_PLLSRC_HSI | (0U << RCC_PLLCFGR_PLLM_Pos) | (10U << RCC_PLLCFGR_PLLN_Pos) |
+                   RCC_PLLCFGR_PLLREN;
+    SET_BIT(RCC->CR, RCC_CR_PLLON);
+    while ((RCC->CR & RCC_CR_PLLRDY) != RCC_CR_PLLRDY) {
+      __NOP();
+    }
+
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_SW, RCC_CFGR_SW_PLL);
+    while ((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL) {
+      __NOP();
+    }
+  } else {
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_SW, RCC_CFGR_SW_HSI);
+    while ((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_HSI) {
+      __NOP();
+    }
+    CLEAR_BIT(RCC->CR, RCC_CR_PLLON);
+
+    CLEAR_BIT(FLASH->ACR, FLASH_ACR_PRFTEN);
+    MODIFY_REG(FLASH->ACR, FLASH_ACR_LATENCY, FLASH_ACR_LATENCY_0WS);
+  }
+}
+
+static constexpr bool isCANClockValid(const uint32_t clock_hz) {
+  ext::CanBitTiming timing = {};
+  return ext::calcCanBitTiming(clock_hz, CAN_BIT_RATE, CAN_SAMPLE_POINT, 1024U, 16U, 8U, timing);
+}
+static_assert(isCANClockValid(device::SYS_TICK) && isCANClockValid(device::SYS_TICK_BOOST),
+              "CAN bit rate not reachable with the system clock");
+
+/**
+ * @brief Enter initialization mode, the node stops taking part in bus communication (bounded if the bus is not idle)
+ */
+static void enterCANInit(void) {
+  uint32_t timeout_cnt = 0U;
+  SET_BIT(CAN1->MCR, CAN_MCR_INRQ);
+  while (((CAN1->MSR & CAN_MSR_INAK) != CAN_MSR_INAK) && (timeout_cnt < tx_timeout_cnt)) {
+    timeout_cnt++;
+  }
+}
+
+/**
+ * @brief Derive CAN bit timing from the kernel clock and leave initialization mode (bounded if the bus is not idle)
+ */
+static void setCANBitTiming(const uint32_t clock_hz) {
+  ext::CanBitTiming timing = {};
+  ext::calcCanBitTiming(clock_hz, CAN_BIT_RATE, CAN_SAMPLE_POINT, 1024U, 16U, 8U, timing);
+
+  enterCANInit();
+
+  CAN1->BTR = ((timing.tseg2 - 1U) << CAN_BTR_TS2_Pos) | ((timing.tseg1 - 1U) << CAN_BTR_TS1_Pos) |
+              ((timing.prescaler - 1U) << CAN_BTR_BRP_Pos);
+
+  // Leaving initialization mode waits for 11 recessive bits
+  uint32_t timeout_cnt = 0U;
+  CLEAR_BIT(CAN1->MCR, CAN_MCR_INRQ);
+  while (((CAN1->MSR & CAN_MSR_INAK) == CAN_MSR_INAK) && (timeout_cnt < tx_timeout_cnt)) {
+    timeout_cnt++;
+  }
+}
+
+/**
+ * @brief Change system clock and derive the clock dependent settings
+ *
+ * Must only be called while the host waits for a response.
+ */
+static void setSysClock(const uint32_t clock_hz) {
+  if (clock_hz == sys_clock_hz) {
+    return;
+  }
+
+  flashFinish();
+  txQueueFlush();
+
+  // Bit timing is invalid while the kernel clock changes, stay off the bus until it is derived again
+  enterCANInit();
+  switchSysClock(clock_hz == device::SYS_TICK_BOOST);
+  sys_clock_hz = clock_hz;
+  stream_timeout_cnt = clock_hz / 200U;
+  tx_timeout_cnt = clock_hz / 100U;
+  setCANBitTiming(clock_hz);
+  bcast_update.setClock(clock_hz);
+  discovery.setClock(clock_hz);
+}
+
+/**
+ * @brief Reprograms node filter (bank 1) and TX identifier of all mailboxes for the node ID
+ *
+ * Frames still pending (TX queue and mailboxes, e.g. nobody acknowledges them) belong to the previous node ID,
+ * they are dropped and their mailboxes aborted before the identifiers are rewritten.
+ */
+static void setCANNodeFilter(const uint32_t node) {
+  const uint32_t msg_node_id = CAN_NODE_REQ_ID(node);
+  const uint32_t msg_mask = 0x7FFU;
+
+  // TX ISR must not refill the mailboxes meanwhile
+  NVIC_DisableIRQ(CAN1_TX_IRQn);
+  tx_queue.clear();
+
+  const uint32_t pending = ~CAN1->TSR & CAN_TSR_TME;
+  if (pending != 0U) {
+    tx_abort_cnt = tx_abort_cnt + 1U;
+    CAN1->TSR = ((pending & CAN_TSR_TME0) ? CAN_TSR_ABRQ0 : 0U) | ((pending & CAN_TSR_TME1) ? CAN_TSR_ABRQ1 : 0U) |
+                ((pending & CAN_TSR_TME2) ? CAN_TSR_ABRQ2 : 0U);
+
+    // Mailbox is empty after the abort or the end of a transmission in progress
+    uint32_t timeout_cnt = 0U;
+    while (((CAN1->TSR & CAN_TSR_TME) != CAN_TSR_TME) && (timeout_cnt < tx_timeout_cnt)) {
+      timeout_cnt++;
+    }
+  }
+
+  // Filter bank must be inactive while it is modified
+  SET_BIT(CAN1->FMR, CAN_FMR_FINIT);
+  CLEAR_BIT(CAN1->FA1R, 1U << 1U);
+  CAN1->sFilterRegister[1].FR1 = (msg_mask << 21U) | (msg_node_id << 5U);
+  CAN1->sFilterRegister[1].FR2 = (msg_mask << 21U) | (msg_node_id << 5U);
+  SET_BIT(CAN1->FA1R, 1U << 1U);
+  CLEAR_BIT(CAN1->FMR, CAN_FMR_FINIT);
+
+  for (uint32_t mailbox_idx = 0U; mailbox_idx < 3U; mailbox_idx++) {
+    CAN1->sTxMailBox[mailbox_idx].TIR = ((msg_node_id + 1U) << CAN_TI0R_STID_Pos);
+  }
+
+  NVIC_EnableIRQ(CAN1_TX_IRQn);
+}
+
+/**
+ * @brief Processes broadcast node ID assignment
+ *
+ * The addressed node applies (and optionally stores) the assignment and answers with the new node ID.
+ * Responses queued before are sent with the previous node ID.
+ *
+ * @return true if the request was a node ID assignment
+ */
+static bool processNodeIDAssign(const msg::Msg& request) {
+  const auto action = node_id.processBroadcast(request);
+  if (action == BootloaderNodeID::ASSIGN_NONE) {
+    return false;
+  }
+  if (action == BootloaderNodeID::ASSIGN_IGNORE) {
+    return true;
+  }
+
+  bool applied = (action == BootloaderNodeID::ASSIGN_APPLY);
+  if (NODE_ID_OTP && (action == BootloaderNodeID::ASSIGN_STORE)) {
+    uint32_t record_idx = 0U;
+    ext::NodeIDRecord record = {};
+    node_id.getRecord(record_idx, record);
+    applied = storeNodeIDRecord(record_idx, record);
+  }
+
+  const uint32_t prev_node = node_id.getNodeID();
+  const msg::Msg response = node_id.finishAssignment(applied);
+
+  txQueueFlush();
+  if (node_id.getNodeID() != prev_node) {
+    setCANNodeFilter(node_id.getNodeID());
+    bcast_update.setSlot(node_id.getNodeID());
+  }
+  transmitResponse(response);
+  return true;
+}
+
+/**
+ * @brief Returns hash of the unique ID (node ID derivation and discovery)
+ */
+static uint32_t getUniqueIDHash(void) {
+  return ext::hashUniqueID(hwi::getUniqueIDWord(0U), hwi::getUniqueIDWord(1U), hwi::getUniqueIDWord(2U));
+}
+
+/**
+ * @brief Returns the bootloader version reported by the handler
+ */
+static uint32_t getBootloaderVersion(BootloaderHandler& handler) {
+  msg::Msg request = {};
+  request.request = msg::REQ_DEV_INFO_BOOTLOADER_VERSION;
+  request.result = msg::RES_NONE;
+  handler.processRequest(request);
+  return ext::getDataWord(handler.getResponse());
 }
 
 // Public Functions ---------------------------------------------------------------------------------------------------
 
-extern "C" void FRANKLYBOOT_Init(void) {}
+extern "C" void FRANKLYBOOT_Init(void) {
+  initCycleCounter();
+
+  // Drain RX FIFOs into RX ring buffer
+  initCANRx();
+
+  // Refill TX mailboxes from TX queue as soon as a mailbox gets empty
+  SET_BIT(CAN1->IER, CAN_IER_TMEIE);
+  NVIC_SetPriority(CAN1_TX_IRQn, 1);
+  NVIC_EnableIRQ(CAN1_TX_IRQn);
+}
 
 extern "C" void FRANKLYBOOT_Run(void) {
-  Handler<device::FLASH_START_ADDR, device::FLASH_APP_FIRST_PAGE, device::FLASH_SIZE, device::FLASH_PAGE_SIZE>
-      hBootloader;
+  BootloaderHandler hBootloader;
+  BootloaderPageStream page_stream(hBootloader);
 
   // Check if autostart shall be disabled by app firmware via backup register
   const bool autostart_disable = (RTC->BKP0R == AUTOBOOT_DISABLE_OVERRIDE_KEY);
@@ -121,19 +613,70 @@ extern "C" void FRANKLYBOOT_Run(void) {
   // Autostart is possible if a valid app in flash is available
   autostart_possible = hBootloader.isAppValid() && !autostart_disable;
 
+  // Answer of broadcast discovery requests
+  discovery.setDeviceInfo(hwi::getVendorID(), hwi::getProductID(), getBootloaderVersion(hBootloader),
+                          getUniqueIDHash());
+
   // TODO init sys tick in main.c!
 
   for (;;) {
-    msg::Msg request;
+    std::array<std::uint8_t, MSG_SIZE> buffer;
     hBootloader.processBufferedCmds();
-    waitForMessage(request);
-    checkAutoStartAbort(request);
-    hBootloader.processRequest(request);
-    const auto response = hBootloader.getResponse();
-    transmitResponse(response);
+    const uint32_t std_id = waitForMessage(buffer, page_stream);
+    const bool broadcast = (std_id == CAN_BROADCAST_ID);
+
+    msg::Msg response;
+    if (page_stream.isActive() && !broadcast) {
+      // Raw data frame of bulk page stream (8 data bytes per frame), acknowledged once per page
+      if (page_stream.feed(buffer.data(), response)) {
+        transmitResponse(response);
+      }
+    } else {
+      msg::Msg request;
+      decodeMessage(buffer, request);
+      checkAutoStartAbort(request);
+
+      // Update session has started, run it with the PLL clock
+      if (!autostart_possible) {
+        setSysClock(device::SYS_TICK_BOOST);
+      }
+
+      // Broadcast update, discovery and node ID requests are not answered directly (responses are sent in
+      // the slot of the node or by the addressed node only)
+      if (broadcast && (bcast_update.processBroadcast(request, DWT->CYCCNT) ||
+                        discovery.processBroadcast(request, DWT->CYCCNT) || processNodeIDAssign(request))) {
+        continue;
+      }
+
+      // Process request directly or in order of the request window
+      const auto process = [&](const msg::Msg& req) {
+        msg::Msg resp;
+        if (!page_stream.processRequest(req, resp) && !page_skip.processRequest(req, resp) &&
+            !page_patch.processRequest(req, resp) && !bcast_update.processRequest(req, resp)) {
+          hBootloader.processRequest(req);
+          resp = hBootloader.getResponse();
+        }
+        return resp;
+      };
+
+      if (!req_window.processRequest(request, process, transmitResponse)) {
+        transmitResponse(process(request));
+      }
+    }
   }
 }
 
+extern "C" uint32_t FRANKLYBOOT_loadCANNodeID(void) {
+  const uint32_t uid_hash = getUniqueIDHash();
+  const uint32_t default_node = NODE_ID_FROM_UID ? (uid_hash % CAN_NUM_NODE_IDS) : CAN_NODE_ID;
+  const volatile ext::NodeIDRecord* records =
+      NODE_ID_OTP ? (const volatile ext::NodeIDRecord*)(device::OTP_NODE_ID_ADDR) : nullptr;
+
+  const uint32_t node = node_id.load(records, uid_hash, default_node);
+  bcast_update.setSlot(node);
+  return node;
+}
+
 extern "C" uint32_t FRANKLYBOOT_getDevSysTickHz(void) { return device::SYS_TICK; }
 
 extern "C" void FRANKLYBOOT_autoStartISR(void) {
@@ -143,9 +686,57 @@ extern "C" void FRANKLYBOOT_autoStartISR(void) {
   }
 }
 
+extern "C" void FRANKLYBOOT_canTxISR(void) {
+  // Clear request completed flags of all mailboxes
+  CAN1->TSR = CAN_TSR_RQCP0 | CAN_TSR_RQCP1 | CAN_TSR_RQCP2;
+
+  // Refill empty mailboxes
+  txQueueFillMailboxes();
+}
+
+extern "C" RAM_FUNC void FRANKLYBOOT_canRxISR(void) {
+  for (uint32_t idx = 0U; idx < 2U; idx++) {
+    // FIFO 1 (broadcast) first, register layout of RF0R and RF1R is identical
+    const uint32_t fifo_idx = 1U - idx;
+    volatile uint32_t& rfr_reg = (fifo_idx == 0U) ? CAN1->RF0R : CAN1->RF1R;
+
+    // Count frames lost in the hardware FIFO
+    if ((rfr_reg & CAN_RF0R_FOVR0) != 0U) {
+      rx_fifo_overrun_cnt[fifo_idx] = rx_fifo_overrun_cnt[fifo_idx] + 1U;
+      rfr_reg = CAN_RF0R_FOVR0;
+    }
+
+    // Move all pending frames into the RX ring buffer
+    while ((rfr_reg & CAN_RF0R_FMP0_Msk) != 0U) {
+      if (!rx_ring.isFull()) {
+        CANRxFrame& frame = rx_ring.back();
+        frame.data.low = CAN1->sFIFOMailBox[fifo_idx].RDLR;
+        frame.data.high = CAN1->sFIFOMailBox[fifo_idx].RDHR;
+        frame.std_id = (CAN1->sFIFOMailBox[fifo_idx].RIR & CAN_RI0R_STID_Msk) >> CAN_RI0R_STID_Pos;
+        rx_ring.push();
+      } else {
+        rx_ring_overrun_cnt = rx_ring_overrun_cnt + 1U;
+      }
+
+      // Release output mailbox and wait until the FIFO has advanced
+      rfr_reg = CAN_RF0R_RFOM0;
+      while ((rfr_reg & CAN_RF0R_RFOM0) != 0U) {
+      }
+    }
+  }
+}
+
 // Hardware Interface -------------------------------------------------------------------------------------------------
 
-void hwi::resetDevice() { NVIC_SystemReset(); }
+void hwi::resetDevice() {
+  /* Finish pending flash operation */
+  flashFinish();
+
+  /* Finish pending responses */
+  txQueueFlush();
+
+  NVIC_SystemReset();
+}
 
 [[nodiscard]] uint32_t hwi::getVendorID() { return device::VENDOR_ID; }
 
@@ -166,29 +757,148 @@ void hwi::resetDevice() { NVIC_SystemReset(); }
   return uid_value;
 }
 
+/**
+ * @brief Feeds words to the CRC unit by DMA (memory to memory mode, no DMA request needed)
+ *
+ * hwi::calculateCRC() returns the result, so the main loop waits for the transfer. The DMA frees the CPU
+ * from the load/store loop only, the RX ISRs continue to buffer requests meanwhile.
+ */
+static void feedCRCByDMA(const uint32_t src_address, const uint32_t num_words) {
+  if (num_words == 0U) {
+    return;
+  }
+
+  DMA1_Channel1->CCR = 0U;
+  DMA1_Channel1->CPAR = (uint32_t)(&CRC->DR);
+  DMA1_Channel1->CMAR = src_address;
+  DMA1_Channel1->CNDTR = num_words;
+  DMA1_Channel1->CCR = DMA_CCR_MEM2MEM | DMA_CCR_MSIZE_1 | DMA_CCR_PSIZE_1 | DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_EN;
+
+  // Wait for transfer (channel is disabled by hardware on transfer error)
+  while ((DMA1_Channel1->CNDTR != 0U) && ((DMA1_Channel1->CCR & DMA_CCR_EN) == DMA_CCR_EN)) {
+    __NOP();
+  }
+  DMA1_Channel1->CCR = 0U;
+}
+
 uint32_t hwi::calculateCRC(uint32_t src_address, uint32_t num_bytes) {
+  flashFinish();
+
+  const uint32_t start_cycles = DWT->CYCCNT;
+
   // Reset CRC calculation
   SET_BIT(CRC->CR, CRC_CR_RESET);
 
   const uint32_t num_words = num_bytes >> 2u;
 
-  // Pointer to data
-  uint32_t* data_ptr = (uint32_t*)src_address;
+  // Input data is bit reversed by word in the CRC unit (see initCRC() in main.c)
+  if ((src_address & 0x3U) == 0U) {
+    feedCRCByDMA(src_address, num_words);
+  } else {
+    // Unaligned region: words are assembled from bytes
+    const uint8_t* data_ptr = (const uint8_t*)src_address;
+    for (uint32_t idx = 0u; idx < num_words; idx++) {
+      uint32_t word;
+      memcpy(&word, &data_ptr[idx * 4U], sizeof(word));
+      CRC->DR = word;
+    }
+  }
 
-  for (uint32_t idx = 0u; idx < num_words; idx++) {
-    const uint32_t value = *(data_ptr);
-    CRC->DR = __REV(value);
-    data_ptr++;
+  const uint32_t crc = ~CRC->DR;
+
+  /* Update statistics */
+  const uint32_t cycles = DWT->CYCCNT - start_cycles;
+  crc_stats.num_bytes_last = num_bytes;
+  crc_stats.cycles_last = cycles;
+  if (cycles != 0U) {
+    crc_stats.bytes_per_s_last = (uint32_t)(((uint64_t)num_bytes * sys_clock_hz) / cycles);
   }
 
-  return ~CRC->DR;
+  return crc;
+}
+
+/**
+ * @brief Returns true if all bytes of the flash row are erased
+ */
+static RAM_FUNC bool isFlashRowErased(const uint32_t* dst_word_ptr) {
+  for (uint32_t idx = 0U; idx < (FLASH_ROW_SIZE / 4U); idx++) {
+    if (dst_word_ptr[idx] != 0xFFFFFFFFU) {
+      return false;
+    }
+  }
+  return true;
 }
 
-bool hwi::eraseFlashPage(uint32_t page_id) {
-  // Unlock flash
-  FLASH->KEYR = 0x45670123U;
-  FLASH->KEYR = 0xCDEF89ABU;
+/**
+ * @brief Starts programming of the next row (fast programming mode) or double word of the flash job
+ *
+ * The double words of a row must be written without gap, so interrupts (vector table and ISRs in
+ * flash) are masked while the row is written. Waiting for the row is done by flashPoll().
+ *
+ * @return false if the double word holds the data already and is skipped (nothing started)
+ */
+static RAM_FUNC bool flashStartProgramStep(void) {
+  uint32_t* dst_word_ptr = flash_job.dst_word_ptr;
+  const uint32_t* src_word_ptr = flash_job.src_word_ptr;
+
+  const bool row_aligned = ((((uint32_t)dst_word_ptr) & (FLASH_ROW_SIZE - 1U)) == 0U);
+  const bool row_complete = ((uint32_t)(flash_job.dst_word_max_ptr - dst_word_ptr) >= (FLASH_ROW_SIZE / 4U));
+
+  // Frames waiting in the RX ring buffer indicate a host sending ahead, which could overflow the FIFOs
+  const bool rx_ring_empty = rx_ring.isEmpty();
 
+  if (flash_job.fast_rows && rx_ring_empty && row_aligned && row_complete && isFlashRowErased(dst_word_ptr)) {
+    FLASH->CR = (FLASH->CR & ~FLASH_CR_PG) | FLASH_CR_FSTPG;
+
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    for (uint32_t idx = 0U; idx < (FLASH_ROW_SIZE / 4U); idx++) {
+      dst_word_ptr[idx] = src_word_ptr[idx];
+    }
+    __set_PRIMASK(primask);
+
+    flash_job.dst_word_ptr += (FLASH_ROW_SIZE / 4U);
+    flash_job.src_word_ptr += (FLASH_ROW_SIZE / 4U);
+    flash_stats.num_rows = flash_stats.num_rows + 1U;
+  } else if ((dst_word_ptr[0U] == src_word_ptr[0U]) && (dst_word_ptr[1U] == src_word_ptr[1U])) {
+    // Page programmed without erase: double word must not be programmed again
+    flash_job.dst_word_ptr += 2U;
+    flash_job.src_word_ptr += 2U;
+    flash_stats.num_skipped_double_words = flash_stats.num_skipped_double_words + 1U;
+    return false;
+  } else {
+    // Both words are written back to back as one double word: the first write is latched, the write of the
+    // second word starts the programming of the double word (BSY set until it is finished)
+    FLASH->CR = (FLASH->CR & ~FLASH_CR_FSTPG) | FLASH_CR_PG;
+    dst_word_ptr[0U] = src_word_ptr[0U];
+    dst_word_ptr[1U] = src_word_ptr[1U];
+
+    flash_job.dst_word_ptr += 2U;
+    flash_job.src_word_ptr += 2U;
+    flash_stats.num_double_words = flash_stats.num_double_words + 1U;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Starts the next programming step of the flash job
+ *
+ * @return false if all remaining double words are skipped (programming finished)
+ */
+static RAM_FUNC bool flashProgramNextStep(void) {
+  while (flash_job.dst_word_ptr < flash_job.dst_word_max_ptr) {
+    if (flashStartProgramStep()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Issues the page erase command of a started erase job
+ */
+static RAM_FUNC void flashEraseCommand(const uint32_t page_id) {
   uint32_t tmp_reg_value = FLASH->CR;
   tmp_reg_value |= FLASH_CR_PER;                   // Enable page erase mode
   tmp_reg_value &= ~(FLASH_CR_PNB_Msk);            // Clear old page idx
@@ -197,75 +907,218 @@ bool hwi::eraseFlashPage(uint32_t page_id) {
 
   // Start erase page
   FLASH->CR = FLASH->CR | FLASH_CR_STRT;
+}
 
-  // Wait for erase to finish
-  bool in_progress = true;
-  while (in_progress) {
-    in_progress = ((FLASH->SR & FLASH_SR_BSY) == FLASH_SR_BSY);
+/**
+ * @brief Advances the flash job if the flash is not busy anymore (called from the main loop)
+ */
+static RAM_FUNC void flashPoll(void) {
+  if (!flash_job.active || ((FLASH->SR & FLASH_SR_BSY) == FLASH_SR_BSY)) {
+    return;
   }
 
-  // Clear page erase mode
-  FLASH->CR &= ~FLASH_CR_PER;
+  if (flash_job.erase_pending) {
+    flash_job.erase_pending = false;
+    flashEraseCommand(flash_job.erase_page_id);
+    return;
+  }
 
-  // Lock flash
+  // Check and clear result of the finished step
+  const uint32_t status = FLASH->SR;
+  FLASH->SR = status & (FLASH_SR_ERRORS | FLASH_SR_EOP);
+  const bool step_failed = ((status & FLASH_SR_ERRORS) != 0U);
+
+  if (!step_failed && flash_job.erase && flash_job.program_after_erase) {
+    // Page erased: continue with its programming
+    FLASH->CR &= ~FLASH_CR_PER;
+    flash_job.erase = false;
+  }
+
+  if (!step_failed && !flash_job.erase && flashProgramNextStep()) {
+    return;
+  }
+
+  // Operation finished: leave erase/programming mode and lock flash
+  FLASH->CR &= ~(FLASH_CR_PER | FLASH_CR_PG | FLASH_CR_FSTPG);
   FLASH->CR |= FLASH_CR_LOCK;
 
-  return true;
+  flash_job.active = false;
+  if (step_failed) {
+    flash_job.error = true;
+    flash_stats.num_errors = flash_stats.num_errors + 1U;
+  }
+  flash_stats.op_cycles_last = DWT->CYCCNT - flash_job.start_cycles;
 }
 
-bool hwi::writeDataBufferToFlash(uint32_t dst_address, uint32_t dst_page_id, uint8_t* src_data_ptr,
-                                 uint32_t num_bytes) {
-  // Check if data size is correct
-  bool data_size_valid = ((num_bytes % 8) == 0);
+/**
+ * @brief Blocks until the flash job is finished (before the flash is read or a new job is started)
+ */
+static RAM_FUNC void flashWaitIdle(void) {
+  while (flash_job.active) {
+    flashPoll();
+  }
+}
+
+/**
+ * @brief Waits for the previous flash job and unlocks the flash for the next one
+ *
+ * @return false if the previous job failed. The failure is reported once, the new job is not started.
+ */
+static RAM_FUNC bool flashStartJob(const bool erase) {
+  flashWaitIdle();
 
-  if (data_size_valid) {
-    // Unlock flash
+  if (flash_job.error) {
+    flash_job.error = false;
+    return false;
+  }
+
+  // Unlock flash and clear flags of previous operations
+  if ((FLASH->CR & FLASH_CR_LOCK) == FLASH_CR_LOCK) {
     FLASH->KEYR = 0x45670123U;
     FLASH->KEYR = 0xCDEF89ABU;
+  }
+  FLASH->SR = FLASH_SR_ERRORS | FLASH_SR_EOP;
+
+  flash_job.active = true;
+  flash_job.erase = erase;
+  flash_job.erase_pending = false;
+  flash_job.program_after_erase = false;
+  flash_job.fast_rows = false;
+  flash_job.start_cycles = DWT->CYCCNT;
+  return true;
+}
+
+/**
+ * @brief Starts erase of the page (NO_PAGE: nothing to erase), finished by flashPoll()
+ */
+static RAM_FUNC bool flashStartErase(const uint32_t page_id) {
+  if (page_id == FlashPageSkip::NO_PAGE) {
+    return true;
+  }
 
-    // Enable programming
-    FLASH->CR |= FLASH_CR_PG;
+  if (!flashStartJob(true)) {
+    return false;
+  }
 
-    // Write data
-    uint32_t* dst_word_ptr = (uint32_t*)(dst_address);
-    const uint32_t* dst_word_max_ptr = (uint32_t*)(dst_address + num_bytes);
-    uint32_t* src_data_word_ptr = (uint32_t*)(src_data_ptr);
+  flashEraseCommand(page_id);
+  return true;
+}
 
-    while (dst_word_ptr < dst_word_max_ptr) {
-      // Write word to flash
-      *(dst_word_ptr) = *(src_data_word_ptr);
+/**
+ * @brief Executes deferred erase and waits until the flash is idle (before the flash is read or left)
+ */
+static RAM_FUNC void flashFinish(void) {
+  flashStartErase(page_skip.takeDeferredErase());
+  flashWaitIdle();
+}
 
-      // Wait until finished
-      bool in_progress = true;
-      while (in_progress) {
-        in_progress = ((FLASH->SR & FLASH_SR_BSY) == FLASH_SR_BSY);
-      }
+RAM_FUNC bool hwi::eraseFlashPage(uint32_t page_id) {
+  // Erase of this page is deferred until the page buffer is written, a previously deferred one starts now
+  return flashStartErase(page_skip.deferErase(page_id));
+}
 
-      // Increase pointer
-      dst_word_ptr++;
-      src_data_word_ptr++;
-    }
+RAM_FUNC bool hwi::writeDataBufferToFlash(uint32_t dst_address, uint32_t dst_page_id, uint8_t* src_data_ptr,
+                                          uint32_t num_bytes) {
+  const uint32_t start_cycles = DWT->CYCCNT;
 
-    // LOCK FLASH
-    uint32_t tmp_reg_value = FLASH->CR;
-    tmp_reg_value &= ~FLASH_CR_PG;
-    tmp_reg_value |= FLASH_CR_LOCK;
-    FLASH->CR = tmp_reg_value;
+  // Check if data size is correct
+  bool data_size_valid = ((num_bytes % 8) == 0) && (num_bytes <= sizeof(flash_program_buffer));
+
+  if (!data_size_valid || !flashStartErase(page_skip.takeDeferredErase(dst_page_id))) {
+    return false;
+  }
 
+  // Compare page buffer with the flash content, which must not change meanwhile
+  flashWaitIdle();
+  const auto action = page_skip.prepareWrite(dst_page_id, dst_address, src_data_ptr, num_bytes);
+
+  if (action == FlashPageSkip::WRITE_SKIP) {
     return true;
   }
 
-  return false;
+  const bool erase = (action == FlashPageSkip::WRITE_ERASE_PROGRAM);
+  if (!flashStartJob(erase)) {
+    return false;
+  }
+
+  // Program from a copy, so the handler can fill its page buffer with the next page meanwhile
+  const uint32_t* src_data_word_ptr = (const uint32_t*)(src_data_ptr);
+  for (uint32_t idx = 0U; idx < (num_bytes / 4U); idx++) {
+    flash_program_buffer[idx] = src_data_word_ptr[idx];
+  }
+
+  flash_job.dst_word_ptr = (uint32_t*)(dst_address);
+  flash_job.dst_word_max_ptr = (uint32_t*)(dst_address + num_bytes);
+  flash_job.src_word_ptr = flash_program_buffer;
+  flash_job.fast_rows = FLASH_FAST_PROGRAMMING && !req_window.isActive() && !bcast_update.isActive();
+
+  if (erase) {
+    // Erase and programming run as one job. The erase is issued by flashPoll() after the response is queued,
+    // so a host sending ahead (request window, page stream) transmits while the page is erased. The RX path
+    // buffers its frames, the main loop stalls on flash fetches until the erase is finished.
+    flash_job.erase_pending = true;
+    flash_job.program_after_erase = true;
+    flash_job.erase_page_id = dst_page_id;
+  } else {
+    // Start first step, the following steps are started by flashPoll()
+    flashProgramNextStep();
+  }
+
+  flash_stats.write_cycles_last = DWT->CYCCNT - start_cycles;
+  return true;
+}
+
+/**
+ * @brief Programs node ID record into the OTP area (blocking)
+ *
+ * @return false if programming failed or the record does not hold the data afterwards
+ */
+static bool storeNodeIDRecord(const uint32_t record_idx, const ext::NodeIDRecord& record) {
+  flashFinish();
+
+  if (!flashStartJob(false)) {
+    return false;
+  }
+
+  const uint32_t record_words[2U] = {record.magic, record.value};
+  const uint32_t dst_address = device::OTP_NODE_ID_ADDR + record_idx * sizeof(ext::NodeIDRecord);
+  flash_job.dst_word_ptr = (uint32_t*)(dst_address);
+  flash_job.dst_word_max_ptr = (uint32_t*)(dst_address + sizeof(ext::NodeIDRecord));
+  flash_job.src_word_ptr = record_words;
+  flashProgramNextStep();
+  flashWaitIdle();
+
+  const bool failed = flash_job.error;
+  flash_job.error = false;
+
+  const volatile ext::NodeIDRecord* stored_record = (const volatile ext::NodeIDRecord*)(dst_address);
+  return !failed && (stored_record->magic == record.magic) && (stored_record->value == record.value);
 }
 
 [[nodiscard]] uint8_t franklyboot::hwi::readByteFromFlash(uint32_t flash_src_address) {
+  flashFinish();
+
   uint8_t* flash_src_ptr = (uint8_t*)(flash_src_address);
   return *(flash_src_ptr);
 }
 
-void franklyboot::hwi::startApp(uint32_t app_flash_address) {  // Disable interrupts
+void franklyboot::hwi::startApp(uint32_t app_flash_address) {
+  // Finish pending flash operation
+  flashFinish();
+
+  // Finish pending responses
+  txQueueFlush();
+
+  // Application expects the clock after reset
+  setSysClock(device::SYS_TICK);
+
+  // Disable interrupts
   __disable_irq();
 
+  // Stop CAN interrupts
+  deinitCANTx();
+  deinitCANRx();
+
   // Clear pending interrupts
   NVIC->ICPR[0] = 0xFFFFFFFFu;
 
@@ -45,6 +45,12 @@ int main(void) {
 
 void SysTick_Handler(void) { FRANKLYBOOT_autoStartISR(); }
 
+void CAN1_TX_IRQHandler(void) { FRANKLYBOOT_canTxISR(); }
+
+__attribute__((section(".RamFunc"))) void CAN1_RX0_IRQHandler(void) { FRANKLYBOOT_canRxISR(); }
+
+__attribute__((section(".RamFunc"))) void CAN1_RX1_IRQHandler(void) { FRANKLYBOOT_canRxISR(); }
+
 // Private Functions --------------------------------------------------------------------------------------------------
 
 static void initCore(void) {
@@ -61,7 +67,7 @@ static void initCore(void) {
   RCC->CFGR = RCC->CFGR | RCC_CFGR_SW_HSI;
 
   // Enable Clocks
-  RCC->AHB1ENR = RCC_AHB1ENR_FLASHEN | RCC_AHB1ENR_CRCEN;
+  RCC->AHB1ENR = RCC_AHB1ENR_FLASHEN | RCC_AHB1ENR_CRCEN | RCC_AHB1ENR_DMA1EN;
   RCC->AHB2ENR = RCC_AHB2ENR_GPIOAEN;
   RCC->APB1ENR1 = RCC_APB1ENR1_CAN1EN | RCC_APB1ENR1_RTCAPBEN;
 
@@ -72,8 +78,8 @@ static void initCore(void) {
 }
 
 static void initCRC(void) {
-  // Set data input inversion mode to byte
-  MODIFY_REG(CRC->CR, CRC_CR_REV_IN, CRC_CR_REV_IN_0);
+  // Set data input inversion mode to word (words are fed in memory order, no byte swap needed)
+  MODIFY_REG(CRC->CR, CRC_CR_REV_IN, CRC_CR_REV_IN);
 
   // Set data output inversion
   MODIFY_REG(CRC->CR, CRC_CR_REV_OUT, CRC_CR_REV_OUT);
@@ -96,6 +102,7 @@ static void initCAN(void) {
 
   // Config CAN module
   SET_BIT(CAN->MCR, CAN_MCR_AWUM);  // Enable auto wakeup
+  SET_BIT(CAN->MCR, CAN_MCR_TXFP);  // Transmit pending mailboxes in request order
   CAN->BTR = 0x001C0001;            // Config CAN speed to 500 kBit/s
 
   // Enable CAN module
@@ -114,19 +121,27 @@ static void initCAN(void) {
 
   // Determine IDs and mask
   const uint32_t msg_broadcast_id = CAN_BROADCAST_ID;
-  const uint32_t msg_node_id = (msg_broadcast_id + 1U) + (CAN_NODE_ID << 1U);
+  const uint32_t msg_broadcast_data_id = CAN_BROADCAST_DATA_ID;
+  const uint32_t msg_node_id = CAN_NODE_REQ_ID(FRANKLYBOOT_loadCANNodeID());
   const uint32_t msg_mask = 0x7FF;
 
-  // Setup filters
+  // Setup filters (both 16 bit filters of a bank are set, the reset value of the registers is undefined)
+  CAN->sFilterRegister[0].FR1 = (msg_mask << 21U) | (msg_broadcast_id << 5U);
   CAN->sFilterRegister[0].FR2 = (msg_mask << 21U) | (msg_broadcast_id << 5U);
+  CAN->sFilterRegister[1].FR1 = (msg_mask << 21U) | (msg_node_id << 5U);
   CAN->sFilterRegister[1].FR2 = (msg_mask << 21U) | (msg_node_id << 5U);
-  CAN->FA1R = 3U;
+  CAN->sFilterRegister[2].FR1 = (msg_mask << 21U) | (msg_broadcast_data_id << 5U);
+  CAN->sFilterRegister[2].FR2 = (msg_mask << 21U) | (msg_broadcast_data_id << 5U);
+  CAN->FFA1R = 5U;  // Broadcast messages and broadcast data to FIFO 1, node messages to FIFO 0
+  CAN->FA1R = 7U;
 
   CLEAR_BIT(CAN->FMR, CAN_FMR_FINIT);  // Disable filter init mode
 
-  // Setup tx message
-  CAN->sTxMailBox[0].TIR = ((msg_node_id + 1U) << CAN_TI0R_STID_Pos);
-  CAN->sTxMailBox[0].TDTR = 8U;
+  // Setup tx message in all mailboxes
+  for (uint32_t mailbox_idx = 0U; mailbox_idx < 3U; mailbox_idx++) {
+    CAN->sTxMailBox[mailbox_idx].TIR = ((msg_node_id + 1U) << CAN_TI0R_STID_Pos);
+    CAN->sTxMailBox[mailbox_idx].TDTR = 8U;
+  }
 }
 
 static void initSysTick(void) {
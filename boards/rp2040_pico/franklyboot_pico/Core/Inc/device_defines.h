@@ -43,6 +43,13 @@ constexpr uint32_t FLASH_PAGE_SIZE_BOOT = FLASH_SECTOR_SIZE;
 // Application start address
 constexpr uint32_t FLASH_APP_START_ADDR = FLASH_START_ADDR + FLASH_APP_FIRST_PAGE * FLASH_SECTOR_SIZE;
 
+// Number of application pages (application CRC is the last word of the last page)
+constexpr uint32_t FLASH_APP_NUM_PAGES = FLASH_SIZE / FLASH_SECTOR_SIZE - FLASH_APP_FIRST_PAGE;
+
+// Sector of the per-page CRC manifest (in the bootloader region, see MANIFEST in rp2040.ld)
+constexpr uint32_t FLASH_MANIFEST_PAGE = {30U};
+constexpr uint32_t FLASH_MANIFEST_ADDR = FLASH_START_ADDR + FLASH_MANIFEST_PAGE * FLASH_SECTOR_SIZE;
+
 };  // namespace device
 
 #endif /* __cplusplus */
@@ -0,0 +1,113 @@
+/**
+ * @file spsc_ring.h
+ * @author agent (agent@local)
+ * @brief Lock-free single producer / single consumer ring buffer for the communication between the cores
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * The write index is only written by the producer, the read index only by the consumer. Both indices
+ * count continuously and are masked on access, so the full buffer size is usable. The producer publishes
+ * written data with a release store of the write index, the consumer reads the write index with acquire
+ * semantics before copying data (and vice versa for freeing space).
+ *
+ * Push and pop never block and never drop data: they transfer as many elements as possible and return
+ * the number of transferred elements. Producers check freeSpace() to apply backpressure.
+ */
+
+#ifndef SPSC_RING_H_
+#define SPSC_RING_H_
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Single producer / single consumer ring buffer
+ *
+ * @tparam T     Element type (trivially copyable)
+ * @tparam SIZE  Number of elements (must be a power of two)
+ */
+template <typename T, uint32_t SIZE>
+class SPSCRing {
+ public:
+  static_assert((SIZE > 0U) && ((SIZE & (SIZE - 1U)) == 0U), "SIZE must be a power of two");
+
+  /**
+   * @brief Resets ring buffer (only allowed while producer and consumer are stopped)
+   */
+  void reset() {
+    _write_idx.store(0U, std::memory_order_relaxed);
+    _read_idx.store(0U, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns number of elements which can be pushed (producer side)
+   */
+  uint32_t freeSpace() const {
+    return SIZE - (_write_idx.load(std::memory_order_relaxed) - _read_idx.load(std::memory_order_acquire));
+  }
+
+  /**
+   * @brief Returns number of elements which can be popped (consumer side)
+   */
+  uint32_t available() const {
+    return _write_idx.load(std::memory_order_acquire) - _read_idx.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Copies up to count elements into the ring buffer (producer side)
+   *
+   * @return Number of elements pushed
+   */
+  uint32_t push(const T* data, uint32_t count) {
+    const uint32_t write_idx = _write_idx.load(std::memory_order_relaxed);
+    const uint32_t free_space = SIZE - (write_idx - _read_idx.load(std::memory_order_acquire));
+    if (count > free_space) {
+      count = free_space;
+    }
+
+    // Copy in up to two parts (wrap around at end of buffer)
+    const uint32_t offset = write_idx & (SIZE - 1U);
+    const uint32_t first_part = (count < (SIZE - offset)) ? count : (SIZE - offset);
+    memcpy(&_buffer[offset], data, first_part * sizeof(T));
+    memcpy(&_buffer[0U], &data[first_part], (count - first_part) * sizeof(T));
+
+    _write_idx.store(write_idx + count, std::memory_order_release);
+    return count;
+  }
+
+  /**
+   * @brief Copies up to count elements out of the ring buffer (consumer side)
+   *
+   * @return Number of elements popped
+   */
+  uint32_t pop(T* data, uint32_t count) {
+    const uint32_t read_idx = _read_idx.load(std::memory_order_relaxed);
+    const uint32_t num_available = _write_idx.load(std::memory_order_acquire) - read_idx;
+    if (count > num_available) {
+      count = num_available;
+    }
+
+    // Copy in up to two parts (wrap around at end of buffer)
+    const uint32_t offset = read_idx & (SIZE - 1U);
+    const uint32_t first_part = (count < (SIZE - offset)) ? count : (SIZE - offset);
+    memcpy(data, &_buffer[offset], first_part * sizeof(T));
+    memcpy(&data[first_part], &_buffer[0U], (count - first_part) * sizeof(T));
+
+    _read_idx.store(read_idx + count, std::memory_order_release);
+    return count;
+  }
+
+ private:
+  T _buffer[SIZE];
+  std::atomic<uint32_t> _write_idx = {0U};
+  std::atomic<uint32_t> _read_idx = {0U};
+};
+
+#endif /* SPSC_RING_H_ */
@@ -14,12 +14,25 @@
 
 #include <francor/franklyboot/handler.h>
 
+#include "crc32.h"
 #include "device_defines.h"
+#include "ext_config.h"
+#include "frame_codec.h"
+#include "page_manifest.h"
+#include "page_patch.h"
+#include "page_skip.h"
+#include "page_stream.h"
+#include "req_window.h"
+#include "spsc_ring.h"
 #include "pico/stdlib.h"
 #include "pico/multicore.h"
 #include "pico/bootrom.h"
 #include "pico/unique_id.h"
+#include "hardware/dma.h"
 #include "hardware/flash.h"
+#include "hardware/irq.h"
+#include "hardware/structs/rosc.h"
+#include "hardware/structs/sio.h"
 #include "hardware/sync.h"
 #include "hardware/watchdog.h"
 #include "hardware/structs/scb.h"
@@ -54,23 +67,102 @@ volatile uint32_t __DEVICE_IDENT__[4U]
 constexpr uint32_t AUTOBOOT_DISABLE_OVERRIDE_KEY = {0xDEADBEEFU};
 constexpr uint32_t MSG_TIMEOUT_US = {500U};  // 500us timeout for message reception
 constexpr uint32_t MSG_SIZE = {8U};
+constexpr uint32_t STREAM_TIMEOUT_US = {100000U};  // 100ms timeout between blocks of a page stream
 
-// Communication FIFO between Core0 and Core1
-constexpr uint32_t RX_FIFO_SIZE = {256U};
+using BootloaderHandler = Handler<device::FLASH_START_ADDR, device::FLASH_APP_FIRST_PAGE, device::FLASH_SIZE,
+                                  device::FLASH_PAGE_SIZE_BOOT>;
+using BootloaderPageStream = ext::PageStream<BootloaderHandler, device::FLASH_PAGE_SIZE_BOOT>;
+using AppPageManifest =
+    ext::PageManifest<device::FLASH_APP_START_ADDR, device::FLASH_SECTOR_SIZE, device::FLASH_APP_NUM_PAGES>;
+
+// Sector erase is deferred until the sector is written, sectors which hold the data already are skipped.
+// NOR flash can clear any bit by programming, so no erase is needed if bits are only cleared.
+using FlashPageSkip = ext::PageSkip<device::FLASH_START_ADDR, device::FLASH_PAGE_SIZE_BOOT, 0U>;
+
+// Delta patches are applied in a separate page buffer
+using BootloaderPagePatch = ext::PagePatch<device::FLASH_START_ADDR, device::FLASH_APP_FIRST_PAGE, device::FLASH_SIZE,
+                                           device::FLASH_PAGE_SIZE_BOOT>;
+
+// Number of application pages hashed at boot if the page manifest is valid
+constexpr uint32_t MANIFEST_NUM_SAMPLES = {8U};
+
+// Manifest is programmed in multiples of the flash programming page (256 bytes)
+constexpr uint32_t MANIFEST_PROGRAM_SIZE = {(sizeof(AppPageManifest::Data) + FLASH_PAGE_SIZE - 1U) /
+                                            FLASH_PAGE_SIZE * FLASH_PAGE_SIZE};
+static_assert(MANIFEST_PROGRAM_SIZE <= device::FLASH_SECTOR_SIZE, "Page manifest must fit into one sector");
+
+// Outstanding requests granted to the host (RX FIFO between the cores holds 128 messages)
+constexpr uint32_t REQ_WINDOW_SIZE = {16U};
+
+// Communication between Core0 and Core1 (sizes must be a power of two)
+// RX: Core1 frames messages and forwards them as two words via the SIO FIFO, the SIO FIFO ISR on Core0
+// moves them into the RX message ring. TX: Core0 writes encoded responses into the TX byte ring.
+constexpr uint32_t RX_MSG_RING_SIZE = {128U};
 constexpr uint32_t TX_FIFO_SIZE = {256U};
+constexpr uint32_t CORE_MSG_WORDS = {MSG_SIZE / 4U};
+
+// Size of the USB CDC transfer buffers on Core1
+constexpr uint32_t USB_CDC_CHUNK_SIZE = {64U};
+
+// Messages are wrapped into frames with sync marker, length and CRC-8 in framed mode. Core0 encodes the
+// responses and selects the mode, Core1 decodes the requests.
+using SerialFrameCodec = ext::FrameCodec<MSG_SIZE>;
 
 // Private Variables --------------------------------------------------------------------------------------------------
 static volatile bool autostart_possible = {false};
 static volatile bool req_autostart = {false};
 
-// Circular buffers for inter-core communication
-static volatile uint8_t rx_fifo[RX_FIFO_SIZE];
-static volatile uint32_t rx_fifo_read_idx = 0;
-static volatile uint32_t rx_fifo_write_idx = 0;
+static ext::RequestWindow<REQ_WINDOW_SIZE> req_window;
+
+// DMA channel used for CRC calculation with the DMA sniffer (-1 if no channel is available)
+static int crc_dma_channel = {-1};
+static uint32_t crc_dma_sink;
+
+// Per-page CRC manifest of the application and its programming buffer
+static AppPageManifest page_manifest;
+static union {
+  AppPageManifest::Data data;
+  uint8_t bytes[MANIFEST_PROGRAM_SIZE];
+} manifest_program_buffer;
+
+// CRC diagnostic counters (read via debugger)
+static volatile uint32_t crc_dma_cnt = {0U};
+static volatile uint32_t crc_sw_cnt = {0U};
+
+static FlashPageSkip page_skip;
+static BootloaderPagePatch page_patch;
+
+// Flash pages (256 bytes) not programmed because the flash holds the data already (read via debugger)
+static volatile uint32_t flash_skipped_page_cnt = {0U};
+
+/**
+ * Message transferred from Core1 to Core0 as two words (little endian wire format)
+ */
+struct CoreMsg {
+  uint32_t words[CORE_MSG_WORDS];
+};
+
+// RX message ring filled by the SIO FIFO ISR on Core0 and TX byte ring read by Core1
+static SPSCRing<CoreMsg, RX_MSG_RING_SIZE> rx_msg_ring;
+static SPSCRing<uint8_t, TX_FIFO_SIZE> tx_fifo;
+
+// Word reassembly state of the SIO FIFO ISR
+static CoreMsg rx_core_msg;
+static uint32_t rx_core_msg_word_idx = {0U};
+
+// Message framing state of Core1
+static std::array<std::uint8_t, MSG_SIZE> core1_rx_buffer;
+static uint32_t core1_rx_buffer_idx = {0U};
+static absolute_time_t core1_rx_timeout_time = nil_time;
+static bool core1_rx_framed = {false};
+static CoreMsg core1_tx_msg;
+static uint32_t core1_tx_words_pending = {0U};
+
+// RX diagnostic counters (read via debugger)
+static volatile uint32_t rx_resync_cnt = {0U};
+static volatile uint32_t rx_msg_ring_full_cnt = {0U};
 
-static volatile uint8_t tx_fifo[TX_FIFO_SIZE];
-static volatile uint32_t tx_fifo_read_idx = 0;
-static volatile uint32_t tx_fifo_write_idx = 0;
+static SerialFrameCodec frame_codec;
 
 // Communication activity tracking
 static volatile uint32_t last_comm_time_ms = 0;
@@ -85,73 +177,54 @@ static volatile bool led_state = false;
 
 // Private Function Prototypes ----------------------------------------------------------------------------------------
 
-/**
- * @brief Write byte to RX FIFO (called from Core1)
- */
-static inline void rxFifoPush(uint8_t byte) {
-  uint32_t next_write_idx = (rx_fifo_write_idx + 1) % RX_FIFO_SIZE;
-  if (next_write_idx != rx_fifo_read_idx) {
-    rx_fifo[rx_fifo_write_idx] = byte;
-    rx_fifo_write_idx = next_write_idx;
-  }
-}
+static void flashFinishErase(void);
 
 /**
- * @brief Read byte from RX FIFO (called from Core0)
+ * @brief Checks if autostart shall be aborted by ping message request
  */
-static inline bool rxFifoPop(uint8_t& byte) {
-  if (rx_fifo_read_idx != rx_fifo_write_idx) {
-    byte = rx_fifo[rx_fifo_read_idx];
-    rx_fifo_read_idx = (rx_fifo_read_idx + 1) % RX_FIFO_SIZE;
-    return true;
+static void checkAutoStartAbort(msg::Msg& request) {
+  if (autostart_possible) {
+    /* Abort autostart if a ping for the bootloader was received */
+    if (request.request == msg::REQ_PING || request.request == msg::REQ_DEV_INFO_BOOTLOADER_VERSION) {
+      autostart_possible = false;
+    }
   }
-  return false;
 }
 
 /**
- * @brief Write byte to TX FIFO (called from Core0)
+ * @brief SIO FIFO ISR on Core0 (doorbell), moves messages forwarded by Core1 into the RX message ring
+ *
+ * If the ring is full the interrupt is disabled and the words stay in the SIO FIFO, so Core1 stops
+ * forwarding and reading from USB. The main loop enables the interrupt again after taking a message.
  */
-static inline void txFifoPush(uint8_t byte) {
-  uint32_t next_write_idx = (tx_fifo_write_idx + 1) % TX_FIFO_SIZE;
-  while (next_write_idx == tx_fifo_read_idx) {
-    // Wait for space in FIFO
-    tight_loop_contents();
-  }
-  tx_fifo[tx_fifo_write_idx] = byte;
-  tx_fifo_write_idx = next_write_idx;
-}
+static void coreFifoISR(void) {
+  while (multicore_fifo_rvalid()) {
+    if ((rx_core_msg_word_idx == 0U) && (rx_msg_ring.freeSpace() == 0U)) {
+      irq_set_enabled(SIO_IRQ_PROC0, false);
+      rx_msg_ring_full_cnt = rx_msg_ring_full_cnt + 1U;
+      break;
+    }
 
-/**
- * @brief Read byte from TX FIFO (called from Core1)
- */
-static inline bool txFifoPop(uint8_t& byte) {
-  if (tx_fifo_read_idx != tx_fifo_write_idx) {
-    byte = tx_fifo[tx_fifo_read_idx];
-    tx_fifo_read_idx = (tx_fifo_read_idx + 1) % TX_FIFO_SIZE;
-    return true;
-  }
-  return false;
-}
+    rx_core_msg.words[rx_core_msg_word_idx] = sio_hw->fifo_rd;
+    rx_core_msg_word_idx++;
 
-/**
- * @brief Checks if autostart shall be aborted by ping message request
- */
-static void checkAutoStartAbort(msg::Msg& request) {
-  if (autostart_possible) {
-    /* Abort autostart if a ping for the bootloader was received */
-    if (request.request == msg::REQ_PING || request.request == msg::REQ_DEV_INFO_BOOTLOADER_VERSION) {
-      autostart_possible = false;
+    if (rx_core_msg_word_idx >= CORE_MSG_WORDS) {
+      rx_msg_ring.push(&rx_core_msg, 1U);
+      rx_core_msg_word_idx = 0U;
     }
   }
+
+  // Clear FIFO error flags
+  multicore_fifo_clear_irq();
 }
 
 /**
  * @brief Block until message is received from USB CDC via Core1
+ *
+ * An open page stream is aborted if no data is received within STREAM_TIMEOUT_US.
  */
-static void waitForMessage(msg::Msg& request) {
-  std::array<std::uint8_t, MSG_SIZE> buffer;
-  uint32_t buffer_idx = 0U;
-  absolute_time_t timeout_time = nil_time;
+static void waitForMessage(std::array<std::uint8_t, MSG_SIZE>& buffer, BootloaderPageStream& page_stream) {
+  const absolute_time_t stream_timeout_time = make_timeout_time_us(STREAM_TIMEOUT_US);
 
   for (;;) {
     // Check for autostart override
@@ -159,33 +232,32 @@ static void waitForMessage(msg::Msg& request) {
       hwi::startApp(device::FLASH_APP_START_ADDR);
     }
 
-    // Try to read byte from RX FIFO
-    uint8_t rx_byte;
-    if (rxFifoPop(rx_byte)) {
-      buffer[buffer_idx] = rx_byte;
-      buffer_idx++;
+    // Take complete message framed by Core1
+    CoreMsg core_msg;
+    if (rx_msg_ring.pop(&core_msg, 1U) != 0U) {
+      irq_set_enabled(SIO_IRQ_PROC0, true);
+
+      for (uint32_t idx = 0U; idx < buffer.size(); idx++) {
+        buffer[idx] = static_cast<uint8_t>(core_msg.words[idx / 4U] >> ((idx % 4U) * 8U));
+      }
 
       // Update communication timestamp
       last_comm_time_ms = to_ms_since_boot(get_absolute_time());
+      break;
+    }
 
-      if (buffer_idx >= buffer.size()) {
-        break;
-      }
-
-      // Reset timeout
-      timeout_time = make_timeout_time_us(MSG_TIMEOUT_US);
-    } else {
-      // Check if timeout occurred
-      if (buffer_idx != 0 && !is_nil_time(timeout_time) && time_reached(timeout_time)) {
-        buffer_idx = 0U;
-        timeout_time = nil_time;
-      }
+    if (ext::EXT_PAGE_STREAM && page_stream.isActive() && time_reached(stream_timeout_time)) {
+      page_stream.abort();
     }
 
     tight_loop_contents();
   }
+}
 
-  /* Decode message */
+/**
+ * @brief Decodes request from received message buffer
+ */
+static void decodeMessage(const std::array<std::uint8_t, MSG_SIZE>& buffer, msg::Msg& request) {
   const uint16_t rx_request_raw = static_cast<uint16_t>(buffer[0U]) | static_cast<uint16_t>(buffer[1U] << 8U);
   request.request = static_cast<msg::RequestType>(rx_request_raw);
   request.result = static_cast<msg::ResultType>(buffer[2U]);
@@ -201,6 +273,7 @@ static void waitForMessage(msg::Msg& request) {
  */
 static void transmitResponse(const msg::Msg& response) {
   std::array<std::uint8_t, MSG_SIZE> buffer;
+  std::array<std::uint8_t, SerialFrameCodec::FRAME_SIZE> frame;
 
   /* Encode message */
   buffer[0U] = static_cast<uint8_t>(response.request);
@@ -213,25 +286,118 @@ static void transmitResponse(const msg::Msg& response) {
   buffer[6U] = response.data.at(2);
   buffer[7U] = response.data.at(3);
 
-  /* Transmit message to TX FIFO */
-  for (uint32_t buffer_idx = 0U; buffer_idx < buffer.size(); buffer_idx++) {
-    txFifoPush(buffer.at(buffer_idx));
+  /* Wait for space in TX FIFO and transmit complete message (framed in framed mode) */
+  const uint32_t num_bytes = frame_codec.encode(buffer.data(), frame.data());
+  while (tx_fifo.freeSpace() < num_bytes) {
+    tight_loop_contents();
   }
+  tx_fifo.push(frame.data(), num_bytes);
+}
+
+/**
+ * @brief Returns stored page manifest (memory mapped flash)
+ */
+static const AppPageManifest::Data& getStoredManifest(void) {
+  return *reinterpret_cast<const AppPageManifest::Data*>(device::FLASH_MANIFEST_ADDR);
+}
+
+/**
+ * @brief Erases the stored page manifest, boot validation falls back to hashing the complete application
+ */
+static void eraseStoredManifest(void) {
+  const uint32_t ints = save_and_disable_interrupts();
+  flash_range_erase(device::FLASH_MANIFEST_ADDR - device::FLASH_START_ADDR, device::FLASH_SECTOR_SIZE);
+  restore_interrupts(ints);
+}
+
+/**
+ * @brief Hashes unknown application pages and stores the page manifest if it changed
+ */
+static void storeManifest(void) {
+  if (!page_manifest.isDirty()) {
+    return;
+  }
+
+  for (uint32_t idx = 0U; idx < MANIFEST_PROGRAM_SIZE; idx++) {
+    manifest_program_buffer.bytes[idx] = 0xFFU;
+  }
+  manifest_program_buffer.data = page_manifest.update(hwi::calculateCRC);
+
+  const uint32_t ints = save_and_disable_interrupts();
+  flash_range_erase(device::FLASH_MANIFEST_ADDR - device::FLASH_START_ADDR, device::FLASH_SECTOR_SIZE);
+  flash_range_program(device::FLASH_MANIFEST_ADDR - device::FLASH_START_ADDR, manifest_program_buffer.bytes,
+                      MANIFEST_PROGRAM_SIZE);
+  restore_interrupts(ints);
+}
+
+/**
+ * @brief Marks application page as changed in the page manifest
+ */
+static void invalidateManifestPage(const uint32_t page_id) {
+  if (page_id < device::FLASH_APP_FIRST_PAGE) {
+    return;
+  }
+
+  // Stored manifest is outdated with the first change
+  if (page_manifest.invalidatePage(page_id - device::FLASH_APP_FIRST_PAGE)) {
+    eraseStoredManifest();
+  }
+}
+
+/**
+ * @brief Returns 32 random bits of the ring oscillator
+ */
+static uint32_t getRandomSeed(void) {
+  uint32_t seed = 0U;
+  for (uint32_t idx = 0U; idx < 32U; idx++) {
+    seed = (seed << 1U) | (rosc_hw->randombit & 0x1U);
+  }
+  return seed;
+}
+
+/**
+ * @brief Checks application with the page manifest or by hashing the complete application as fallback
+ */
+static bool isAppValid(BootloaderHandler& handler) {
+  const uint32_t app_crc = *reinterpret_cast<const volatile uint32_t*>(AppPageManifest::APP_CRC_ADDR);
+
+  if (page_manifest.load(getStoredManifest()) &&
+      AppPageManifest::verify(getStoredManifest(), app_crc, hwi::calculateCRC, getRandomSeed(),
+                              MANIFEST_NUM_SAMPLES)) {
+    return true;
+  }
+
+  // Fallback: full check and create manifest for the next boot
+  if (!handler.isAppValid()) {
+    return false;
+  }
+
+  page_manifest.clear();
+  storeManifest();
+  return true;
 }
 
 // Public Functions ---------------------------------------------------------------------------------------------------
 
 extern "C" void FRANKLYBOOT_Init(void) {
   // Initialize FIFOs
-  rx_fifo_read_idx = 0;
-  rx_fifo_write_idx = 0;
-  tx_fifo_read_idx = 0;
-  tx_fifo_write_idx = 0;
+  rx_msg_ring.reset();
+  tx_fifo.reset();
+
+  // Receive messages from Core1 via SIO FIFO interrupt. The SDK disables this interrupt while
+  // Core1 is launched, because the launch handshake uses the same FIFO.
+  multicore_fifo_drain();
+  multicore_fifo_clear_irq();
+  irq_set_exclusive_handler(SIO_IRQ_PROC0, coreFifoISR);
+  irq_set_enabled(SIO_IRQ_PROC0, true);
+
+  // Reserve DMA channel for the CRC calculation (software CRC is used if none is free)
+  crc_dma_channel = dma_claim_unused_channel(false);
 }
 
 extern "C" void FRANKLYBOOT_Run(void) {
-  static Handler<device::FLASH_START_ADDR, device::FLASH_APP_FIRST_PAGE, device::FLASH_SIZE, device::FLASH_PAGE_SIZE_BOOT>
-      hBootloader;
+  static BootloaderHandler hBootloader;
+  static BootloaderPageStream page_stream(hBootloader);
 
   // Check if autostart shall be disabled
   // On RP2040, we can use watchdog scratch registers for persistent storage
@@ -239,16 +405,40 @@ extern "C" void FRANKLYBOOT_Run(void) {
   watchdog_hw->scratch[0] = 0;  // Reset scratch register
 
   // Autostart is possible if a valid app in flash is available
-  autostart_possible = hBootloader.isAppValid() && !autostart_disable;
+  autostart_possible = isAppValid(hBootloader) && !autostart_disable;
 
   for (;;) {
-    msg::Msg request;
+    std::array<std::uint8_t, MSG_SIZE> buffer;
     hBootloader.processBufferedCmds();
-    waitForMessage(request);
-    checkAutoStartAbort(request);
-    hBootloader.processRequest(request);
-    const auto response = hBootloader.getResponse();
-    transmitResponse(response);
+    waitForMessage(buffer, page_stream);
+
+    msg::Msg response;
+    if (ext::EXT_PAGE_STREAM && page_stream.isActive()) {
+      // Raw data block of bulk page stream, acknowledged once per page
+      if (page_stream.feed(buffer.data(), response)) {
+        transmitResponse(response);
+      }
+    } else {
+      msg::Msg request;
+      decodeMessage(buffer, request);
+      checkAutoStartAbort(request);
+
+      // Process request directly or in order of the request window
+      const auto process = [&](const msg::Msg& req) {
+        msg::Msg resp;
+        if (!(ext::EXT_PAGE_STREAM && page_stream.processRequest(req, resp)) && !page_skip.processRequest(req, resp) &&
+            !(ext::EXT_PAGE_PATCH && page_patch.processRequest(req, resp)) &&
+            !(ext::EXT_FRAME_MODE && frame_codec.processRequest(req, resp))) {
+          hBootloader.processRequest(req);
+          resp = hBootloader.getResponse();
+        }
+        return resp;
+      };
+
+      if (!(ext::EXT_REQ_WINDOW && req_window.processRequest(request, process, transmitResponse))) {
+        transmitResponse(process(request));
+      }
+    }
   }
 }
 
@@ -289,6 +479,19 @@ extern "C" void FRANKLYBOOT_updateLED(void) {
   }
 }
 
+/**
+ * @brief Packs the received message of Core1 into words for the SIO FIFO
+ */
+static void core1QueueMessage(void) {
+  for (uint32_t idx = 0U; idx < CORE_MSG_WORDS; idx++) {
+    core1_tx_msg.words[idx] = static_cast<uint32_t>(core1_rx_buffer[idx * 4U + 0U]) |
+                              (static_cast<uint32_t>(core1_rx_buffer[idx * 4U + 1U]) << 8U) |
+                              (static_cast<uint32_t>(core1_rx_buffer[idx * 4U + 2U]) << 16U) |
+                              (static_cast<uint32_t>(core1_rx_buffer[idx * 4U + 3U]) << 24U);
+  }
+  core1_tx_words_pending = CORE_MSG_WORDS;
+}
+
 /**
  * @brief Core1 entry point - handles USB CDC communication
  */
@@ -300,22 +503,57 @@ extern "C" void FRANKLYBOOT_Core1Entry(void) {
     // Handle USB tasks
     tud_task();
 
-    // Handle RX: USB CDC -> RX FIFO
-    if (tud_cdc_connected() && tud_cdc_available()) {
-      uint8_t buf[64];
-      uint32_t count = tud_cdc_read(buf, sizeof(buf));
-      for (uint32_t i = 0; i < count; i++) {
-        rxFifoPush(buf[i]);
+    // Handle RX: forward framed message to Core0 word by word as long as the SIO FIFO has space
+    while ((core1_tx_words_pending != 0U) && multicore_fifo_wready()) {
+      sio_hw->fifo_wr = core1_tx_msg.words[CORE_MSG_WORDS - core1_tx_words_pending];
+      core1_tx_words_pending--;
+      __sev();
+    }
+
+    // Handle RX: USB CDC -> message framing
+    // Only read from USB if the previous message is forwarded. Remaining data stays in the TinyUSB FIFO
+    // and the endpoint is NAKed, so the host is throttled instead of losing data.
+    if (core1_rx_framed != frame_codec.isEnabled()) {
+      // Mode changed by Core0 after the response to the mode request, host sends nothing until then
+      core1_rx_framed = frame_codec.isEnabled();
+      core1_rx_buffer_idx = 0U;
+      frame_codec.resetDecoder();
+    }
+
+    if (core1_tx_words_pending == 0U) {
+      if (ext::EXT_FRAME_MODE && core1_rx_framed) {
+        // Framed mode: decode byte-wise until a frame is complete, frames resynchronise on the marker
+        uint8_t rx_byte;
+        while (tud_cdc_connected() && (tud_cdc_read(&rx_byte, 1U) == 1U)) {
+          if (frame_codec.decode(rx_byte, core1_rx_buffer.data())) {
+            core1QueueMessage();
+            break;
+          }
+        }
+      } else if (tud_cdc_connected() && tud_cdc_available()) {
+        const uint32_t count =
+            tud_cdc_read(&core1_rx_buffer[core1_rx_buffer_idx], core1_rx_buffer.size() - core1_rx_buffer_idx);
+        core1_rx_buffer_idx += count;
+        core1_rx_timeout_time = make_timeout_time_us(MSG_TIMEOUT_US);
+
+        if (core1_rx_buffer_idx >= core1_rx_buffer.size()) {
+          core1QueueMessage();
+          core1_rx_buffer_idx = 0U;
+        }
+      } else if ((core1_rx_buffer_idx != 0U) && time_reached(core1_rx_timeout_time)) {
+        // Message is ignored if the next byte is not received within the timeout
+        core1_rx_buffer_idx = 0U;
+        rx_resync_cnt = rx_resync_cnt + 1U;
       }
     }
 
     // Handle TX: TX FIFO -> USB CDC
+    // Only take as much as TinyUSB accepts, the rest stays in the TX FIFO.
     if (tud_cdc_connected()) {
-      uint8_t buf[64];
-      uint32_t count = 0;
-      while (count < sizeof(buf) && txFifoPop(buf[count])) {
-        count++;
-      }
+      uint8_t buf[USB_CDC_CHUNK_SIZE];
+      const uint32_t write_available = tud_cdc_write_available();
+      const uint32_t max_count = (write_available < sizeof(buf)) ? write_available : sizeof(buf);
+      const uint32_t count = tx_fifo.pop(buf, max_count);
       if (count > 0) {
         tud_cdc_write(buf, count);
         tud_cdc_write_flush();
@@ -329,6 +567,9 @@ extern "C" void FRANKLYBOOT_Core1Entry(void) {
 // Hardware Interface -------------------------------------------------------------------------------------------------
 
 void hwi::resetDevice() {
+  flashFinishErase();
+  storeManifest();
+
   /* Delay system reset */
   sleep_ms(100);
 
@@ -364,48 +605,91 @@ void hwi::resetDevice() {
   return uid_value;
 }
 
-// Software CRC-32 implementation (RP2040 doesn't have hardware CRC)
-static uint32_t crc32_table[256];
-static bool crc32_table_initialized = false;
-
-static void init_crc32_table() {
-  for (uint32_t i = 0; i < 256; i++) {
-    uint32_t crc = i;
-    for (uint32_t j = 0; j < 8; j++) {
-      if (crc & 1) {
-        crc = (crc >> 1) ^ 0xEDB88320;
-      } else {
-        crc >>= 1;
-      }
+/**
+ * @brief Calculates CRC-32 with the DMA sniffer
+ *
+ * The sniffer calculates the bit reversed CRC-32 (IEEE 802.3) of all data read by the DMA channel. Flash
+ * data is read via the XIP streaming interface, which bypasses the XIP cache and does not evict the
+ * cached code of the application. Other memory (e.g. the page buffer in RAM) is read directly.
+ *
+ * @return false if the DMA can not be used (no channel or unaligned data), the CRC is not calculated
+ */
+static bool calculateCRCDMA(const uint32_t src_address, const uint32_t num_bytes, uint32_t& crc) {
+  if ((crc_dma_channel < 0) || (num_bytes == 0U) || (((src_address | num_bytes) & 0x3U) != 0U)) {
+    return false;
+  }
+
+  const uint channel = static_cast<uint>(crc_dma_channel);
+  const uint32_t num_words = num_bytes / 4U;
+  const bool src_is_flash = (src_address >= device::FLASH_START_ADDR) &&
+                            ((src_address + num_bytes) <= (device::FLASH_START_ADDR + device::FLASH_SIZE));
+
+  dma_channel_config config = dma_channel_get_default_config(channel);
+  channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+  channel_config_set_write_increment(&config, false);
+  channel_config_set_sniff_enable(&config, true);
+
+  const volatile void* read_addr = reinterpret_cast<const volatile void*>(src_address);
+  if (src_is_flash) {
+    // Drain stale data of the streaming FIFO and start streaming
+    while ((xip_ctrl_hw->stat & XIP_STAT_FIFO_EMPTY_BITS) == 0U) {
+      (void)xip_ctrl_hw->stream_fifo;
     }
-    crc32_table[i] = crc;
+    xip_ctrl_hw->stream_addr = src_address;
+    xip_ctrl_hw->stream_ctr = num_words;
+
+    channel_config_set_read_increment(&config, false);
+    channel_config_set_dreq(&config, DREQ_XIP_STREAM);
+    read_addr = reinterpret_cast<const volatile void*>(XIP_AUX_BASE);
+  } else {
+    channel_config_set_read_increment(&config, true);
   }
-  crc32_table_initialized = true;
+
+  // Seed and result inversion/reversal match the standard CRC-32 of the software implementation
+  dma_hw->sniff_data = 0xFFFFFFFFU;
+  dma_hw->sniff_ctrl = (channel << DMA_SNIFF_CTRL_DMACH_LSB) |
+                       (DMA_SNIFF_CTRL_CALC_VALUE_CRC32R << DMA_SNIFF_CTRL_CALC_LSB) | DMA_SNIFF_CTRL_OUT_REV_BITS |
+                       DMA_SNIFF_CTRL_OUT_INV_BITS | DMA_SNIFF_CTRL_EN_BITS;
+
+  dma_channel_configure(channel, &config, &crc_dma_sink, read_addr, num_words, true);
+  dma_channel_wait_for_finish_blocking(channel);
+
+  crc = dma_hw->sniff_data;
+  dma_hw->sniff_ctrl = 0U;
+
+  return true;
 }
 
 uint32_t hwi::calculateCRC(uint32_t src_address, uint32_t num_bytes) {
-  if (!crc32_table_initialized) {
-    init_crc32_table();
-  }
-
-  uint32_t crc = 0xFFFFFFFF;
-  uint8_t* data_ptr = (uint8_t*)src_address;
+  flashFinishErase();
 
-  for (uint32_t i = 0; i < num_bytes; i++) {
-    uint8_t byte = data_ptr[i];
-    crc = (crc >> 8) ^ crc32_table[(crc ^ byte) & 0xFF];
+  uint32_t crc = 0U;
+  if (calculateCRCDMA(src_address, num_bytes, crc)) {
+    crc_dma_cnt = crc_dma_cnt + 1U;
+    return crc;
   }
 
-  return ~crc;
+  // Software fallback (slicing-by-8)
+  crc_sw_cnt = crc_sw_cnt + 1U;
+  return crc::calculate(reinterpret_cast<const uint8_t*>(src_address), num_bytes);
 }
 
-bool hwi::eraseFlashPage(uint32_t page_id) {
+/**
+ * @brief Erases the sector (NO_PAGE: nothing to erase)
+ */
+static void flashEraseSector(const uint32_t page_id) {
+  if (page_id == FlashPageSkip::NO_PAGE) {
+    return;
+  }
+
   // RP2040 flash sector size is 4KB
   const uint32_t sector_size = 4096U;
 
   // Calculate flash offset from page ID
   uint32_t flash_offset = page_id * sector_size;
 
+  invalidateManifestPage(page_id);
+
   // Disable interrupts during flash operation
   uint32_t ints = save_and_disable_interrupts();
 
@@ -414,7 +698,16 @@ bool hwi::eraseFlashPage(uint32_t page_id) {
 
   // Restore interrupts
   restore_interrupts(ints);
+}
 
+/**
+ * @brief Executes deferred erase (before the flash is read or left)
+ */
+static void flashFinishErase(void) { flashEraseSector(page_skip.takeDeferredErase()); }
+
+bool hwi::eraseFlashPage(uint32_t page_id) {
+  // Erase of this sector is deferred until the page buffer is written, a previously deferred one is done now
+  flashEraseSector(page_skip.deferErase(page_id));
   return true;
 }
 
@@ -425,22 +718,44 @@ bool hwi::writeDataBufferToFlash(uint32_t dst_address, uint32_t dst_page_id, uin
     return false;
   }
 
+  flashEraseSector(page_skip.takeDeferredErase(dst_page_id));
+
+  const auto action = page_skip.prepareWrite(dst_page_id, dst_address, src_data_ptr, num_bytes);
+  if (action == FlashPageSkip::WRITE_SKIP) {
+    return true;
+  }
+  if (action == FlashPageSkip::WRITE_ERASE_PROGRAM) {
+    flashEraseSector(dst_page_id);
+  }
+
   // Calculate flash offset (remove XIP base address)
   uint32_t flash_offset = dst_address - device::FLASH_START_ADDR;
 
-  // Disable interrupts during flash operation
-  uint32_t ints = save_and_disable_interrupts();
+  invalidateManifestPage(dst_page_id);
 
-  // Program flash
-  flash_range_program(flash_offset, src_data_ptr, num_bytes);
+  // Program flash pages which differ from the data (programming only clears bits, the rest are equal)
+  for (uint32_t offset = 0U; offset < num_bytes; offset += FLASH_PAGE_SIZE) {
+    if (memcmp(reinterpret_cast<const void*>(dst_address + offset), &src_data_ptr[offset], FLASH_PAGE_SIZE) == 0) {
+      flash_skipped_page_cnt = flash_skipped_page_cnt + 1U;
+      continue;
+    }
 
-  // Restore interrupts
-  restore_interrupts(ints);
+    // Disable interrupts during flash operation
+    uint32_t ints = save_and_disable_interrupts();
+
+    // Program flash
+    flash_range_program(flash_offset + offset, &src_data_ptr[offset], FLASH_PAGE_SIZE);
+
+    // Restore interrupts
+    restore_interrupts(ints);
+  }
 
   return true;
 }
 
 [[nodiscard]] uint8_t franklyboot::hwi::readByteFromFlash(uint32_t flash_src_address) {
+  flashFinishErase();
+
   uint8_t* flash_src_ptr = (uint8_t*)(flash_src_address);
   return *(flash_src_ptr);
 }
@@ -448,7 +763,11 @@ bool hwi::writeDataBufferToFlash(uint32_t dst_address, uint32_t dst_page_id, uin
 void franklyboot::hwi::startApp(uint32_t app_flash_address) {
   // Sleep before starting app
   //sleep_ms(100);
-  
+
+  // Store manifest of the updated pages before the flash is left
+  flashFinishErase();
+  storeManifest();
+
   // Disable interrupts
   __asm volatile("cpsid i");
 
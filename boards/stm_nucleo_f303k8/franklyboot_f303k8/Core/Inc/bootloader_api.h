@@ -40,6 +40,16 @@
   */
  void FRANKLYBOOT_autoStartISR(void);
  
+ /**
+  * @brief Called by serial DMA and UART ISRs to publish received bytes
+  */
+ void FRANKLYBOOT_serialRxISR(void);
+ 
+ /**
+  * @brief Called by serial TX DMA ISR to continue with the next queued response
+  */
+ void FRANKLYBOOT_serialTxISR(void);
+ 
  #ifdef __cplusplus
  };
  #endif
@@ -20,7 +20,8 @@
  
  namespace device {
  
- constexpr uint32_t SYS_TICK = {8000000U};
+ constexpr uint32_t SYS_TICK = {8000000U};        // HSI after reset
+ constexpr uint32_t SYS_TICK_BOOST = {64000000U};  // PLL during update sessions (PCLK1 = SYS_TICK_BOOST / 2)
  
  constexpr uint32_t FLASH_START_ADDR = {0x08000000U};
  constexpr uint32_t FLASH_APP_FIRST_PAGE = {4U};
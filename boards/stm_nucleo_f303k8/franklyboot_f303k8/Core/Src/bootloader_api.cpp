@@ -13,8 +13,19 @@
 #include "bootloader_api.h"
 
 #include <francor/franklyboot/handler.h>
+#include <string.h>
 
+#include "baud_switch.h"
 #include "device_defines.h"
+#include "dma_rx_ring.h"
+#include "ext_config.h"
+#include "frame_codec.h"
+#include "frame_sync.h"
+#include "isr_queue.h"
+#include "page_patch.h"
+#include "page_skip.h"
+#include "page_stream.h"
+#include "req_window.h"
 #include "stm32f3xx.h"
 
 using namespace franklyboot;
@@ -42,15 +53,119 @@ volatile uint32_t __DEVICE_IDENT__[4U]
 
 // Defines ------------------------------------------------------------------------------------------------------------
 constexpr uint32_t AUTOBOOT_DISABLE_OVERRIDE_KEY = {0xDEADBEEFU};
-constexpr uint32_t MSG_TIMEOUT_CNT = {device::SYS_TICK / 2000U};
 constexpr uint32_t MSG_SIZE = {8U};
 
+using BootloaderHandler =
+    Handler<device::FLASH_START_ADDR, device::FLASH_APP_FIRST_PAGE, device::FLASH_SIZE, device::FLASH_PAGE_SIZE>;
+using BootloaderPageStream = ext::PageStream<BootloaderHandler, device::FLASH_PAGE_SIZE>;
+
+// Page erase is deferred until the page is written, pages which hold the data already are skipped
+using FlashPageSkip = ext::PageSkip<device::FLASH_START_ADDR, device::FLASH_PAGE_SIZE, 2U>;
+
+// Delta patches are applied in a separate page buffer
+using BootloaderPagePatch = ext::PagePatch<device::FLASH_START_ADDR, device::FLASH_APP_FIRST_PAGE, device::FLASH_SIZE,
+                                           device::FLASH_PAGE_SIZE>;
+
+// Outstanding requests granted to the host (RX ring buffer holds 64 messages)
+constexpr uint32_t REQ_WINDOW_SIZE = {16U};
+
+// CRC unit is fed by DMA in one transfer (channel is only used by hwi::calculateCRC(), 16 bit transfer counter)
+static_assert((device::FLASH_SIZE / 4U) <= 0xFFFFU, "Flash does not fit into one CRC DMA transfer");
+
+/**
+ * CRC calculation statistics (read via debugger)
+ */
+struct CRCStats {
+  uint32_t num_bytes_last;    //!< Number of bytes of the last calculation
+  uint32_t cycles_last;       //!< CPU cycles of the last calculation
+  uint32_t bytes_per_s_last;  //!< Throughput of the last calculation
+};
+
+// Serial RX ring buffer filled by DMA in circular mode (size must be a power of two)
+constexpr uint32_t RX_RING_SIZE = {512U};
+
+// Serial TX queue of encoded responses sent by DMA (size must be a power of two)
+constexpr uint32_t TX_QUEUE_SIZE = {8U};
+
+// Messages are wrapped into frames with sync marker, length and CRC-8 in framed mode
+using SerialFrameCodec = ext::FrameCodec<MSG_SIZE>;
+
+/**
+ * Encoded response in the TX queue
+ */
+struct SerialTxFrame {
+  std::array<uint8_t, SerialFrameCodec::FRAME_SIZE> data;
+  uint32_t len;  //!< Number of bytes to transmit
+};
+
+// Messages are delimited by the receiver timeout after RX_FRAME_GAP_BITS idle bit times (4 characters)
+constexpr uint32_t RX_FRAME_GAP_BITS = {40U};
+constexpr uint32_t RX_FRAME_NUM_GAPS = {16U};
+
+// USART2 runs on PCLK1 with 16 times oversampling, baud rate = PCLK1 / BRR. The first character is
+// measured by the auto baud rate detection in 0x55 frame mode.
+using SerialBaudSwitch = ext::BaudSwitch<1U, 16U, 0xFFFFU>;
+static_assert(SerialBaudSwitch::calcBRR(device::SYS_TICK, ext::DEFAULT_BAUD) != 0U, "Default baud rate not reachable");
+constexpr uint32_t USART_CR2_ABR_SYNC_BYTE = {USART_CR2_ABREN | USART_CR2_ABRMODE_0 | USART_CR2_ABRMODE_1};
+
+/**
+ * Main loop timing statistics in CPU cycles (read via debugger)
+ *
+ * The former blocking transmit spent 8 bytes * 10 bit times in transmitResponse() per reply, which are
+ * 5555 cycles at 8 MHz and 115200 baud. The difference to tx_cycles_last is the loop time freed
+ * by the DMA transmit queue.
+ */
+struct LoopStats {
+  uint32_t num_responses;     //!< Number of responses queued
+  uint32_t tx_cycles_last;    //!< Cycles spent in transmitResponse() for the last response
+  uint32_t tx_cycles_max;     //!< Maximum cycles spent in transmitResponse()
+  uint64_t tx_cycles_total;   //!< Total cycles spent in transmitResponse()
+  uint64_t busy_cycles_total; //!< Total cycles spent in the main loop excluding waiting for requests
+};
+
 // Private Variables --------------------------------------------------------------------------------------------------
 static volatile bool autostart_possible = {false};
 static volatile bool req_autostart = {false};
 
+static ext::RequestWindow<REQ_WINDOW_SIZE> req_window;
+
+static volatile CRCStats crc_stats;
+
+static FlashPageSkip page_skip;
+static BootloaderPagePatch page_patch;
+
+// Half-words not programmed because the flash holds the data already (read via debugger)
+static volatile uint32_t flash_skipped_half_word_cnt = {0U};
+
+// RX ring buffer written by DMA, published by the ISRs (DMA half/full transfer and UART idle line)
+static ext::DmaRxRing<RX_RING_SIZE> rx_ring;
+
+// RX diagnostic counters (read via debugger)
+static volatile uint32_t rx_uart_error_cnt = {0U};
+
+// Gaps of the serial line detected by the receiver timeout
+static ext::FrameSync<RX_FRAME_NUM_GAPS> frame_sync;
+
+// TX queue read by DMA. Pushed by the main loop, popped by the DMA ISR when the frame is transmitted.
+static ext::IsrQueue<SerialTxFrame, TX_QUEUE_SIZE> tx_queue;
+static volatile bool tx_dma_busy = {false};
+
+static SerialBaudSwitch baud_switch(device::SYS_TICK);
+static SerialFrameCodec frame_codec;
+static bool rx_framed = {false};  // Mode of the decoder, follows frame_codec.isEnabled()
+static bool autobaud_armed = {false};
+
+static volatile LoopStats loop_stats;
+
+// System clock (SYS_TICK after reset, SYS_TICK_BOOST during update sessions) and settings derived from it
+static uint32_t sys_clock_hz = {device::SYS_TICK};
+static uint32_t stream_timeout_cnt = {device::SYS_TICK / 200U};
+
 // Private Function Prototypes ----------------------------------------------------------------------------------------
 
+static void flashFinishErase(void);
+static void txQueueFlush(void);
+
 /**
  * @brief Checks if autostart shall be aborted by ping message request
  */
@@ -63,47 +178,265 @@ static void checkAutoStartAbort(msg::Msg& request) {
   }
 }
 
+/**
+ * @brief Setup DMA channel to receive the serial line continuously into the RX ring buffer
+ */
+static void initRxDMA(void) {
+  // USART2 RX is hardwired to DMA1 channel 6
+  // Setup circular peripheral to memory transfer with half and full transfer interrupt
+  DMA1_Channel6->CPAR = (uint32_t)(&USART2->RDR);
+  DMA1_Channel6->CMAR = (uint32_t)(rx_ring.getBuffer());
+  DMA1_Channel6->CNDTR = RX_RING_SIZE;
+  DMA1_Channel6->CCR = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_HTIE | DMA_CCR_TCIE | DMA_CCR_EN;
+
+  // Enable DMA reception, error, idle line and receiver timeout interrupt
+  SET_BIT(USART2->CR3, USART_CR3_DMAR | USART_CR3_EIE);
+  SET_BIT(USART2->CR1, USART_CR1_IDLEIE | USART_CR1_RTOIE);
+
+  NVIC_SetPriority(DMA1_Channel6_IRQn, 1);
+  NVIC_SetPriority(USART2_IRQn, 1);
+  NVIC_EnableIRQ(DMA1_Channel6_IRQn);
+  NVIC_EnableIRQ(USART2_IRQn);
+}
+
+/**
+ * @brief Setup DMA channel to transmit responses from the TX queue
+ */
+static void initTxDMA(void) {
+  // USART2 TX is hardwired to DMA1 channel 7
+  DMA1_Channel7->CPAR = (uint32_t)(&USART2->TDR);
+  SET_BIT(USART2->CR3, USART_CR3_DMAT);
+
+  NVIC_SetPriority(DMA1_Channel7_IRQn, 1);
+  NVIC_EnableIRQ(DMA1_Channel7_IRQn);
+}
+
+/**
+ * @brief Set baud rate and optionally measure the next character (aborts the reception of the current byte)
+ */
+static void setBaudRate(const uint32_t brr, const bool autobaud) {
+  CLEAR_BIT(USART2->CR1, USART_CR1_UE);
+  USART2->BRR = brr;
+  USART2->CR2 = USART_CR2_RTOEN | (autobaud ? USART_CR2_ABR_SYNC_BYTE : 0U);
+  SET_BIT(USART2->CR1, USART_CR1_UE);
+  autobaud_armed = autobaud;
+}
+
+/**
+ * @brief Enable USART2 with the default baud rate and wait for a sync byte
+ */
+static void initSerial(void) {
+  USART2->CR1 = USART_CR1_TE | USART_CR1_RE;
+  USART2->RTOR = RX_FRAME_GAP_BITS;
+  setBaudRate(baud_switch.getBRR(), true);
+}
+
+/**
+ * @brief Enable the DWT cycle counter used for loop instrumentation
+ */
+static void initCycleCounter(void) {
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Stop serial DMA transfers before handing over to the application
+ */
+static void deinitSerialDMA(void) {
+  NVIC_DisableIRQ(DMA1_Channel7_IRQn);
+  NVIC_DisableIRQ(DMA1_Channel6_IRQn);
+  NVIC_DisableIRQ(USART2_IRQn);
+
+  CLEAR_BIT(USART2->CR1, USART_CR1_IDLEIE | USART_CR1_RTOIE);
+  CLEAR_BIT(USART2->CR3, USART_CR3_DMAR | USART_CR3_DMAT | USART_CR3_EIE);
+  DMA1_Channel6->CCR = 0U;
+  DMA1_Channel7->CCR = 0U;
+
+  NVIC_ClearPendingIRQ(DMA1_Channel7_IRQn);
+  NVIC_ClearPendingIRQ(DMA1_Channel6_IRQn);
+  NVIC_ClearPendingIRQ(USART2_IRQn);
+}
+
+/**
+ * @brief Returns true and drops all pending bytes if the DMA has overwritten unread data
+ */
+static bool rxRingCheckOverrun(void) {
+  if (rx_ring.checkOverrun()) {
+    frame_sync.reset();
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * @brief Drops all received data
+ */
+static void rxRingDrop(void) {
+  NVIC_DisableIRQ(DMA1_Channel6_IRQn);
+  NVIC_DisableIRQ(USART2_IRQn);
+  rx_ring.drop(DMA1_Channel6->CNDTR);
+  frame_sync.reset();
+  NVIC_EnableIRQ(USART2_IRQn);
+  NVIC_EnableIRQ(DMA1_Channel6_IRQn);
+}
+
+/**
+ * @brief Evaluates auto-baud detection and applies baud rate changes of the baud rate switch
+ *
+ * @return true if received data was dropped
+ */
+static bool pollBaudRate(void) {
+  const uint32_t uart_isr = USART2->ISR;
+  if (autobaud_armed && ((uart_isr & USART_ISR_ABRF) != 0U)) {
+    autobaud_armed = false;
+
+    if (((uart_isr & USART_ISR_ABRE) == 0U) && baud_switch.setBaseBRR(USART2->BRR)) {
+      // Drop sync byte
+      rxRingDrop();
+      return true;
+    }
+
+    // First character was no sync byte, the measurement may have changed BRR
+    if (USART2->BRR != baud_switch.getBRR()) {
+      setBaudRate(baud_switch.getBRR(), false);
+    }
+  }
+
+  uint32_t brr = 0U;
+  switch (baud_switch.poll(DWT->CYCCNT, rx_uart_error_cnt, brr)) {
+    case SerialBaudSwitch::LINK_SET_BRR:
+      txQueueFlush();
+      setBaudRate(brr, false);
+      rxRingDrop();
+      return true;
+
+    case SerialBaudSwitch::LINK_RESTART:
+      setBaudRate(brr, true);
+      rxRingDrop();
+      frame_codec.disable();
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+/**
+ * @brief Switch system clock between HSI (SYS_TICK) and PLL (SYS_TICK_BOOST)
+ *
+ * PLL: HSI / 2 * 16 = 64 MHz with 2 flash wait states, APB1 is limited to 36 MHz and runs at 32 MHz.
+ */
+static void switchSysClock(const bool boost) {
+  if (boost) {
+    MODIFY_REG(FLASH->ACR, FLASH_ACR_LATENCY, FLASH_ACR_LATENCY_1);
+    while ((FLASH->ACR & FLASH_ACR_LATENCY) != FLASH_ACR_LATENCY_1) {
+      __NOP();
+    }
+
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_PLLSRC | RCC_CFGR_PLLMUL | RCC_CFGR_PPRE1,
+               RCC_CFGR_PLLSRC_HSI_DIV2 | RCC_CFGR_PLLMUL16 | RCC_CFGR_PPRE1_DIV2);
+    SET_BIT(RCC->CR, RCC_CR_PLLON);
+    while ((RCC->CR & RCC_CR_PLLRDY) != RCC_CR_PLLRDY) {
+      __NOP();
+    }
+
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_SW, RCC_CFGR_SW_PLL);
+    while ((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL) {
+      __NOP();
+    }
+  } else {
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_SW, RCC_CFGR_SW_HSI);
+    while ((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_HSI) {
+      __NOP();
+    }
+    CLEAR_BIT(RCC->CR, RCC_CR_PLLON);
+
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_PPRE1, RCC_CFGR_PPRE1_DIV1);
+    MODIFY_REG(FLASH->ACR, FLASH_ACR_LATENCY, 0U);
+  }
+}
+
+/**
+ * @brief Change system clock and derive the clock dependent settings
+ *
+ * Must only be called while the host waits for a response, received data is lost during the change.
+ */
+static void setSysClock(const uint32_t clock_hz) {
+  if (clock_hz == sys_clock_hz) {
+    return;
+  }
+
+  txQueueFlush();
+
+  const bool boost = (clock_hz == device::SYS_TICK_BOOST);
+  switchSysClock(boost);
+  sys_clock_hz = clock_hz;
+  stream_timeout_cnt = clock_hz / 200U;
+  setBaudRate(baud_switch.setClock(boost ? (clock_hz / 2U) : clock_hz, clock_hz), false);
+}
+
 /**
  * @brief Block until message is received from serial line
+ *
+ * In raw mode a message is dropped if the receiver timeout detects a gap before it is complete, in framed
+ * mode frames are checked by the frame codec. An open page stream is aborted if no data is received within
+ * stream_timeout_cnt loops.
  */
-static void waitForMessage(msg::Msg& request) {
-  std::array<std::uint8_t, MSG_SIZE> buffer;
+static void waitForMessage(std::array<std::uint8_t, MSG_SIZE>& buffer, BootloaderPageStream& page_stream) {
   uint32_t buffer_idx = 0U;
-  uint32_t timeout_cnt = 0U;
 
   for (;;) {
     // Check for autostart override
     if (req_autostart) {
       hwi::startApp(device::FLASH_APP_START_ADDR);
     } else {
-      // Otherwise wait for data
-      const uint8_t rx_new_byte = ((USART2->ISR & USART_ISR_RXNE) == USART_ISR_RXNE);
+      // Restart message if received data was lost or the baud rate changed
+      if (pollBaudRate() || rxRingCheckOverrun()) {
+        buffer_idx = 0U;
+        frame_codec.resetDecoder();
+      }
 
-      if (rx_new_byte) {
-        buffer[buffer_idx] = USART2->RDR;
-        buffer_idx++;
+      // Restart message if the mode changed with the last response
+      if (rx_framed != frame_codec.isEnabled()) {
+        rx_framed = frame_codec.isEnabled();
+        buffer_idx = 0U;
+        frame_codec.resetDecoder();
+      }
 
-        if (buffer_idx >= buffer.size()) {
-          break;
+      // Restart message if the line was idle after an incomplete message
+      if (frame_sync.checkGap(rx_ring.getTail(), buffer_idx)) {
+        buffer_idx = 0U;
+      }
+
+      // Otherwise wait for data
+      uint8_t rx_byte;
+      if (rx_ring.pop(rx_byte)) {
+        bool complete = false;
+        if (ext::EXT_FRAME_MODE && rx_framed) {
+          complete = frame_codec.decode(rx_byte, buffer.data());
+        } else {
+          buffer[buffer_idx] = rx_byte;
+          buffer_idx++;
+          complete = (buffer_idx >= buffer.size());
         }
 
-        timeout_cnt = 0U;
-      } else {
-        // Check if new message has started
-        // If new byte is not received within a timeout cnt
-        // the message is ignored
-        if (buffer_idx != 0) {
-          timeout_cnt++;
-
-          if (timeout_cnt >= MSG_TIMEOUT_CNT) {
-            buffer_idx = 0U;
-          }
+        if (complete) {
+          baud_switch.onMessage(rx_uart_error_cnt);
+          break;
         }
+      } else {
+        page_stream.checkTimeout(stream_timeout_cnt);
       }
     }
   }
+}
 
-  /* Decode message */
+/**
+ * @brief Decodes request from received message buffer
+ */
+static void decodeMessage(const std::array<std::uint8_t, MSG_SIZE>& buffer, msg::Msg& request) {
   const uint16_t rx_request_raw = static_cast<uint16_t>(buffer[0U]) | static_cast<uint16_t>(buffer[1U] << 8U);
   request.request = static_cast<msg::RequestType>(rx_request_raw);
   request.result = static_cast<msg::ResultType>(buffer[2U]);
@@ -115,9 +448,46 @@ static void waitForMessage(msg::Msg& request) {
 }
 
 /**
- * @brief Transmit response over serial line
+ * @brief Start DMA transfer of the oldest queued response if the DMA is idle
+ *
+ * Must be called from the TX DMA ISR or with the TX DMA interrupt disabled.
+ */
+static void txQueueStartDMA(void) {
+  if (!tx_dma_busy && !tx_queue.isEmpty()) {
+    const SerialTxFrame& frame = tx_queue.front();
+    DMA1_Channel7->CCR = 0U;
+    DMA1_Channel7->CMAR = (uint32_t)(frame.data.data());
+    DMA1_Channel7->CNDTR = frame.len;
+    __DMB();
+    DMA1_Channel7->CCR = DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_TCIE | DMA_CCR_EN;
+    tx_dma_busy = true;
+  }
+}
+
+/**
+ * @brief Block until all queued responses are transmitted completely
+ */
+static void txQueueFlush(void) {
+  while (!tx_queue.isEmpty()) {
+    __NOP();
+  }
+
+  while ((USART2->ISR & USART_ISR_TC) != USART_ISR_TC) {
+    __NOP();
+  }
+}
+
+/**
+ * @brief Queue response for transmission over serial line
  */
 static void transmitResponse(const msg::Msg& response) {
+  const uint32_t start_cycles = DWT->CYCCNT;
+
+  // Wait for free slot in TX queue
+  while (tx_queue.isFull()) {
+    __NOP();
+  }
+
   std::array<std::uint8_t, MSG_SIZE> buffer;
 
   /* Encode message */
@@ -131,25 +501,37 @@ static void transmitResponse(const msg::Msg& response) {
   buffer[6U] = response.data.at(2);
   buffer[7U] = response.data.at(3);
 
-  /* Transmit message */
-  for (uint32_t buffer_idx = 0U; buffer_idx < buffer.size(); buffer_idx++) {
-    uint8_t tx_not_ready = ((USART2->ISR & USART_ISR_TXE) == USART_ISR_TXE);
-
-    USART2->TDR = buffer.at(buffer_idx);
-
-    do {
-      tx_not_ready = !((USART2->ISR & USART_ISR_TXE) == USART_ISR_TXE);
-    } while (tx_not_ready);
+  /* Transmit message (framed in framed mode) */
+  SerialTxFrame& frame = tx_queue.back();
+  frame.len = frame_codec.encode(buffer.data(), frame.data.data());
+  tx_queue.push();
+
+  NVIC_DisableIRQ(DMA1_Channel7_IRQn);
+  txQueueStartDMA();
+  NVIC_EnableIRQ(DMA1_Channel7_IRQn);
+
+  /* Update statistics */
+  const uint32_t tx_cycles = DWT->CYCCNT - start_cycles;
+  loop_stats.num_responses = loop_stats.num_responses + 1U;
+  loop_stats.tx_cycles_last = tx_cycles;
+  loop_stats.tx_cycles_total = loop_stats.tx_cycles_total + tx_cycles;
+  if (tx_cycles > loop_stats.tx_cycles_max) {
+    loop_stats.tx_cycles_max = tx_cycles;
   }
 }
 
 // Public Functions ---------------------------------------------------------------------------------------------------
 
-extern "C" void FRANKLYBOOT_Init(void) {}
+extern "C" void FRANKLYBOOT_Init(void) {
+  initCycleCounter();
+  initSerial();
+  initRxDMA();
+  initTxDMA();
+}
 
 extern "C" void FRANKLYBOOT_Run(void) {
-  Handler<device::FLASH_START_ADDR, device::FLASH_APP_FIRST_PAGE, device::FLASH_SIZE, device::FLASH_PAGE_SIZE>
-      hBootloader;
+  BootloaderHandler hBootloader;
+  BootloaderPageStream page_stream(hBootloader);
 
   // Check if autostart shall be disabled by app firmware via backup register
   const bool autostart_disable = (RTC->BKP0R== AUTOBOOT_DISABLE_OVERRIDE_KEY);
@@ -159,13 +541,46 @@ extern "C" void FRANKLYBOOT_Run(void) {
   autostart_possible = hBootloader.isAppValid() && !autostart_disable;
 
   for (;;) {
-    msg::Msg request;
+    std::array<std::uint8_t, MSG_SIZE> buffer;
     hBootloader.processBufferedCmds();
-    waitForMessage(request);
-    checkAutoStartAbort(request);
-    hBootloader.processRequest(request);
-    const auto response = hBootloader.getResponse();
-    transmitResponse(response);
+    waitForMessage(buffer, page_stream);
+    const uint32_t start_cycles = DWT->CYCCNT;
+
+    msg::Msg response;
+    if (ext::EXT_PAGE_STREAM && page_stream.isActive()) {
+      // Raw data block of bulk page stream, acknowledged once per page
+      if (page_stream.feed(buffer.data(), response)) {
+        transmitResponse(response);
+      }
+    } else {
+      msg::Msg request;
+      decodeMessage(buffer, request);
+      checkAutoStartAbort(request);
+
+      // Update session has started, run it with the PLL clock
+      if (!autostart_possible) {
+        setSysClock(device::SYS_TICK_BOOST);
+      }
+
+      // Process request directly or in order of the request window
+      const auto process = [&](const msg::Msg& req) {
+        msg::Msg resp;
+        if (!(ext::EXT_PAGE_STREAM && page_stream.processRequest(req, resp)) && !page_skip.processRequest(req, resp) &&
+            !(ext::EXT_PAGE_PATCH && page_patch.processRequest(req, resp)) &&
+            !(ext::EXT_BAUD_SWITCH && baud_switch.processRequest(req, resp)) &&
+            !(ext::EXT_FRAME_MODE && frame_codec.processRequest(req, resp))) {
+          hBootloader.processRequest(req);
+          resp = hBootloader.getResponse();
+        }
+        return resp;
+      };
+
+      if (!(ext::EXT_REQ_WINDOW && req_window.processRequest(request, process, transmitResponse))) {
+        transmitResponse(process(request));
+      }
+    }
+
+    loop_stats.busy_cycles_total = loop_stats.busy_cycles_total + (DWT->CYCCNT - start_cycles);
   }
 }
 
@@ -178,9 +593,46 @@ extern "C" void FRANKLYBOOT_autoStartISR(void) {
   }
 }
 
+extern "C" void FRANKLYBOOT_serialRxISR(void) {
+  // Clear UART idle line, receiver timeout and error flags
+  const uint32_t uart_isr = USART2->ISR;
+  if ((uart_isr & (USART_ISR_ORE | USART_ISR_FE | USART_ISR_NE)) != 0U) {
+    rx_uart_error_cnt++;
+  }
+  USART2->ICR = USART_ICR_IDLECF | USART_ICR_RTOCF | USART_ICR_ORECF | USART_ICR_FECF | USART_ICR_NCF;
+
+  // Clear DMA flags
+  DMA1->IFCR = DMA_IFCR_CGIF6;
+
+  // Publish bytes written by DMA since last call
+  rx_ring.publish(DMA1_Channel6->CNDTR);
+
+  // Line is idle after the received data
+  if ((uart_isr & USART_ISR_RTOF) != 0U) {
+    frame_sync.markGap(rx_ring.getHead());
+  }
+}
+
+extern "C" void FRANKLYBOOT_serialTxISR(void) {
+  // Clear DMA flags and release transmitted queue slot
+  DMA1->IFCR = DMA_IFCR_CGIF7;
+  DMA1_Channel7->CCR = 0U;
+  tx_queue.pop();
+  tx_dma_busy = false;
+
+  // Continue with next queued response
+  txQueueStartDMA();
+}
+
 // Hardware Interface -------------------------------------------------------------------------------------------------
 
 void hwi::resetDevice() { 
+  /* Finish deferred flash erase */
+  flashFinishErase();
+
+  /* Finish pending responses */
+  txQueueFlush();
+
   /* Delay system reset */
   for(uint32_t idx = 0U; idx < 1000000U; idx++) {
     __NOP();
@@ -209,25 +661,74 @@ void hwi::resetDevice() {
   return uid_value;
 }
 
+/**
+ * @brief Feeds words to the CRC unit by DMA (memory to memory mode, no DMA request needed)
+ *
+ * hwi::calculateCRC() returns the result, so the main loop waits for the transfer. The DMA frees the CPU
+ * from the load/store loop only, the RX ISRs continue to buffer requests meanwhile.
+ */
+static void feedCRCByDMA(const uint32_t src_address, const uint32_t num_words) {
+  if (num_words == 0U) {
+    return;
+  }
+
+  DMA1_Channel1->CCR = 0U;
+  DMA1_Channel1->CPAR = (uint32_t)(&CRC->DR);
+  DMA1_Channel1->CMAR = src_address;
+  DMA1_Channel1->CNDTR = num_words;
+  DMA1_Channel1->CCR = DMA_CCR_MEM2MEM | DMA_CCR_MSIZE_1 | DMA_CCR_PSIZE_1 | DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_EN;
+
+  // Wait for transfer (channel is disabled by hardware on transfer error)
+  while ((DMA1_Channel1->CNDTR != 0U) && ((DMA1_Channel1->CCR & DMA_CCR_EN) == DMA_CCR_EN)) {
+    __NOP();
+  }
+  DMA1_Channel1->CCR = 0U;
+}
+
 uint32_t hwi::calculateCRC(uint32_t src_address, uint32_t num_bytes) {
+  flashFinishErase();
+
+  const uint32_t start_cycles = DWT->CYCCNT;
+
   // Reset CRC calculation
   SET_BIT(CRC->CR, CRC_CR_RESET);
 
   const uint32_t num_words = num_bytes >> 2u;
 
-  // Pointer to data
-  uint32_t* data_ptr = (uint32_t*)src_address;
+  // Input data is bit reversed by word in the CRC unit (see initCRC() in main.c)
+  if ((src_address & 0x3U) == 0U) {
+    feedCRCByDMA(src_address, num_words);
+  } else {
+    // Unaligned region: words are assembled from bytes
+    const uint8_t* data_ptr = (const uint8_t*)src_address;
+    for (uint32_t idx = 0u; idx < num_words; idx++) {
+      uint32_t word;
+      memcpy(&word, &data_ptr[idx * 4U], sizeof(word));
+      CRC->DR = word;
+    }
+  }
+
+  const uint32_t crc = ~CRC->DR;
 
-  for (uint32_t idx = 0u; idx < num_words; idx++) {
-    const uint32_t value = *(data_ptr);
-    CRC->DR = __REV(value);
-    data_ptr++;
+  /* Update statistics */
+  const uint32_t cycles = DWT->CYCCNT - start_cycles;
+  crc_stats.num_bytes_last = num_bytes;
+  crc_stats.cycles_last = cycles;
+  if (cycles != 0U) {
+    crc_stats.bytes_per_s_last = (uint32_t)(((uint64_t)num_bytes * sys_clock_hz) / cycles);
   }
 
-  return ~CRC->DR;
+  return crc;
 }
 
-bool hwi::eraseFlashPage(uint32_t page_id) {
+/**
+ * @brief Erases the page (NO_PAGE: nothing to erase)
+ */
+static bool flashErasePage(const uint32_t page_id) {
+  if (page_id == FlashPageSkip::NO_PAGE) {
+    return true;
+  }
+
   // Unlock flash
   FLASH->KEYR = 0x45670123U;
   FLASH->KEYR = 0xCDEF89ABU;
@@ -257,12 +758,32 @@ bool hwi::eraseFlashPage(uint32_t page_id) {
   return true;
 }
 
+/**
+ * @brief Executes deferred erase (before the flash is read or left)
+ */
+static void flashFinishErase(void) { flashErasePage(page_skip.takeDeferredErase()); }
+
+bool hwi::eraseFlashPage(uint32_t page_id) {
+  // Erase of this page is deferred until the page buffer is written, a previously deferred one is done now
+  return flashErasePage(page_skip.deferErase(page_id));
+}
+
 bool hwi::writeDataBufferToFlash(uint32_t dst_address, uint32_t dst_page_id, uint8_t* src_data_ptr,
                                  uint32_t num_bytes) {
   // Check if data size is correct
   bool data_size_valid = ((num_bytes % 8) == 0);
 
   if (data_size_valid) {
+    flashErasePage(page_skip.takeDeferredErase(dst_page_id));
+
+    const auto action = page_skip.prepareWrite(dst_page_id, dst_address, src_data_ptr, num_bytes);
+    if (action == FlashPageSkip::WRITE_SKIP) {
+      return true;
+    }
+    if (action == FlashPageSkip::WRITE_ERASE_PROGRAM) {
+      flashErasePage(dst_page_id);
+    }
+
     // Unlock flash
     FLASH->KEYR = 0x45670123U;
     FLASH->KEYR = 0xCDEF89ABU;
@@ -277,13 +798,18 @@ bool hwi::writeDataBufferToFlash(uint32_t dst_address, uint32_t dst_page_id, uin
     uint16_t* src_data_word_ptr = (uint16_t*)(src_data_ptr);
 
     while (dst_word_ptr < dst_word_max_ptr) {
-      // Write word to flash
-      *(dst_word_ptr) = *(src_data_word_ptr);
+      if (*(dst_word_ptr) == *(src_data_word_ptr)) {
+        // Half-word holds the data already (must not be programmed again without erase)
+        flash_skipped_half_word_cnt = flash_skipped_half_word_cnt + 1U;
+      } else {
+        // Write word to flash
+        *(dst_word_ptr) = *(src_data_word_ptr);
 
-      // Wait until finished
-      bool in_progress = true;
-      while (in_progress) {
-        in_progress = ((FLASH->SR & FLASH_SR_BSY) == FLASH_SR_BSY);
+        // Wait until finished
+        bool in_progress = true;
+        while (in_progress) {
+          in_progress = ((FLASH->SR & FLASH_SR_BSY) == FLASH_SR_BSY);
+        }
       }
 
       // Increase pointer
@@ -304,13 +830,28 @@ bool hwi::writeDataBufferToFlash(uint32_t dst_address, uint32_t dst_page_id, uin
 }
 
 [[nodiscard]] uint8_t franklyboot::hwi::readByteFromFlash(uint32_t flash_src_address) {
+  flashFinishErase();
+
   uint8_t* flash_src_ptr = (uint8_t*)(flash_src_address);
   return *(flash_src_ptr);
 }
 
-void franklyboot::hwi::startApp(uint32_t app_flash_address) {  // Disable interrupts
+void franklyboot::hwi::startApp(uint32_t app_flash_address) {
+  // Finish deferred flash erase
+  flashFinishErase();
+
+  // Finish pending responses
+  txQueueFlush();
+
+  // Application expects the clock after reset
+  setSysClock(device::SYS_TICK);
+
+  // Disable interrupts
   __disable_irq();
 
+  // Stop serial DMA transfers
+  deinitSerialDMA();
+
   // Clear pending interrupts
   NVIC->ICPR[0] = 0xFFFFFFFFu;
 
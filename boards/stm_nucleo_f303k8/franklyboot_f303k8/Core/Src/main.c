@@ -40,11 +40,17 @@ int main(void) {
 
 void SysTick_Handler(void) { FRANKLYBOOT_autoStartISR(); }
 
+void DMA1_Channel6_IRQHandler(void) { FRANKLYBOOT_serialRxISR(); }
+
+void DMA1_Channel7_IRQHandler(void) { FRANKLYBOOT_serialTxISR(); }
+
+void USART2_IRQHandler(void) { FRANKLYBOOT_serialRxISR(); }
+
 // Private Functions --------------------------------------------------------------------------------------------------
 
 static void initCore(void) {
   // Enable clocks
-  RCC->AHBENR = RCC_AHBENR_CRCEN | RCC_AHBENR_GPIOAEN;
+  RCC->AHBENR = RCC_AHBENR_CRCEN | RCC_AHBENR_GPIOAEN | RCC_AHBENR_DMA1EN;
   RCC->APB1ENR = RCC_APB1ENR_USART2EN | RCC_APB1ENR_PWREN;
 
   // Config GPIOs for UART PA2 and PA15
@@ -59,17 +65,15 @@ static void initCore(void) {
   SET_BIT(GPIOA->AFR[0], (7 << GPIO_AFRL_AFRL2_Pos));
   SET_BIT(GPIOA->AFR[1], (7 << GPIO_AFRH_AFRH7_Pos));
 
-  // Setup UART
-  WRITE_REG(USART2->BRR, 0x45); // 115200 baud
-  SET_BIT(USART2->CR1, USART_CR1_TE | USART_CR1_RE | USART_CR1_UE); // Enable UART
+  // UART baud rate is set by the bootloader API (auto-baud and baud rate switch)
 
   // Enable RTC for backup registers
   SET_BIT(PWR->CR, PWR_CR_DBP);
 }
 
 static void initCRC(void) {
-  // Set data input inversion mode to byte
-  MODIFY_REG(CRC->CR, CRC_CR_REV_IN, CRC_CR_REV_IN_0);
+  // Set data input inversion mode to word (words are fed in memory order, no byte swap needed)
+  MODIFY_REG(CRC->CR, CRC_CR_REV_IN, CRC_CR_REV_IN);
 
   // Set data output inversion
   MODIFY_REG(CRC->CR, CRC_CR_REV_OUT, CRC_CR_REV_OUT);
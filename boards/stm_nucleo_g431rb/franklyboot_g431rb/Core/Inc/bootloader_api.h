@@ -40,6 +40,21 @@ uint32_t FRANKLYBOOT_getDevSysTickHz(void);
  */
 void FRANKLYBOOT_autoStartISR(void);
 
+/**
+ * @brief Called by serial DMA and UART ISRs to publish received bytes
+ */
+void FRANKLYBOOT_serialRxISR(void);
+
+/**
+ * @brief Called by EXTI ISR of the serial RX pin to measure the auto-baud sync byte
+ */
+void FRANKLYBOOT_serialEdgeISR(void);
+
+/**
+ * @brief Called by serial TX DMA ISR to continue with the next queued response
+ */
+void FRANKLYBOOT_serialTxISR(void);
+
 #ifdef __cplusplus
 };
 #endif
@@ -20,7 +20,8 @@
 
 namespace device {
 
-constexpr uint32_t SYS_TICK = {16000000U};
+constexpr uint32_t SYS_TICK = {16000000U};        // HSI16 after reset
+constexpr uint32_t SYS_TICK_BOOST = {170000000U};  // PLL during update sessions
 
 constexpr uint32_t FLASH_START_ADDR = {0x08000000U};
 constexpr uint32_t FLASH_APP_FIRST_PAGE = {4U};
@@ -31,4 +32,9 @@ constexpr uint32_t FLASH_APP_START_ADDR = FLASH_START_ADDR + FLASH_APP_FIRST_PAG
 
 #endif /* __cplusplus */
 
+// Defines ------------------------------------------------------------------------------------------------------------
+
+#define CAN_BROADCAST_ID (uint16_t)(0x780U)
+#define CAN_NODE_ID (uint16_t)(1)
+
 #endif /* DEVICE_DEFINES_H_ */
\ No newline at end of file
@@ -0,0 +1,109 @@
+/**
+ * @file fdcan_frame.h
+ * @author agent (agent@local)
+ * @brief Packing of 8 byte bootloader messages into CAN-FD frames (no hardware dependencies)
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * A CAN-FD frame carries up to 64 bytes and is split into slots of 8 bytes. Every slot holds one
+ * message in the same wire format as the serial line. Unused slots, which are required to fill the
+ * frame up to the next valid CAN-FD length, are zero. A zero request (0x0000) is never sent by the
+ * host and marks the end of the messages in a frame.
+ *
+ * Raw blocks of a page stream are counted by the frame length instead, limited to the blocks the stream
+ * still expects (see countStreamSlots() and page_stream.h), so padding slots are never taken as data.
+ *
+ * The helpers are free of device headers so they can be compiled and checked on the host.
+ */
+
+#ifndef FDCAN_FRAME_H_
+#define FDCAN_FRAME_H_
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <stdint.h>
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+namespace fdcan_frame {
+
+constexpr uint32_t SLOT_SIZE = {8U};
+constexpr uint32_t MAX_FRAME_SIZE = {64U};
+constexpr uint32_t MAX_SLOTS = {MAX_FRAME_SIZE / SLOT_SIZE};
+
+/**
+ * @brief Returns number of data bytes of a CAN-FD frame with the given data length code
+ */
+constexpr uint32_t dlcToLength(const uint32_t dlc) {
+  constexpr uint8_t DLC_LENGTH[16U] = {0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U, 12U, 16U, 20U, 24U, 32U, 48U, 64U};
+  return DLC_LENGTH[dlc & 0xFU];
+}
+
+/**
+ * @brief Returns smallest data length code able to carry the given number of bytes
+ */
+constexpr uint32_t lengthToDLC(const uint32_t length) {
+  uint32_t dlc = 0U;
+  while ((dlc < 15U) && (dlcToLength(dlc) < length)) {
+    dlc++;
+  }
+  return dlc;
+}
+
+/**
+ * @brief Returns true if the 8 byte slot does not contain a message
+ */
+constexpr bool isEmptySlot(const uint8_t* slot) { return (slot[0U] == 0U) && (slot[1U] == 0U); }
+
+/**
+ * @brief Returns number of messages packed into a received frame
+ *
+ * Counting stops at the first empty slot or at the end of the frame. Trailing bytes not filling
+ * a complete slot are ignored.
+ */
+constexpr uint32_t countMsgSlots(const uint8_t* frame, const uint32_t length) {
+  const uint32_t max_slots = (length > MAX_FRAME_SIZE ? MAX_FRAME_SIZE : length) / SLOT_SIZE;
+
+  uint32_t num_slots = 0U;
+  while ((num_slots < max_slots) && !isEmptySlot(&frame[num_slots * SLOT_SIZE])) {
+    num_slots++;
+  }
+  return num_slots;
+}
+
+/**
+ * @brief Returns number of raw blocks of a page stream to take from a received frame
+ *
+ * Raw blocks may start with zero bytes, so the frame length counts instead of empty slots. Padding slots
+ * after the last pending block are not taken.
+ *
+ * @param length      Number of data bytes of the frame
+ * @param num_pending Number of blocks the stream still expects
+ */
+constexpr uint32_t countStreamSlots(const uint32_t length, const uint32_t num_pending) {
+  const uint32_t num_slots = (length > MAX_FRAME_SIZE ? MAX_FRAME_SIZE : length) / SLOT_SIZE;
+  return (num_slots < num_pending) ? num_slots : num_pending;
+}
+
+/**
+ * @brief Fills frame with zero padding from the given length up to the length of the returned DLC
+ *
+ * @return Data length code to transmit the frame with
+ */
+inline uint32_t padFrame(uint8_t* frame, const uint32_t length) {
+  const uint32_t dlc = lengthToDLC(length);
+  for (uint32_t idx = length; idx < dlcToLength(dlc); idx++) {
+    frame[idx] = 0U;
+  }
+  return dlc;
+}
+
+static_assert(lengthToDLC(8U) == 8U, "8 bytes are transmitted as classic length");
+static_assert(lengthToDLC(9U) == 9U, "9 bytes are rounded up to 12 bytes");
+static_assert(lengthToDLC(40U) == 14U, "40 bytes are rounded up to 48 bytes");
+static_assert(lengthToDLC(64U) == 15U, "64 bytes are the maximum frame length");
+
+};  // namespace fdcan_frame
+
+#endif /* FDCAN_FRAME_H_ */
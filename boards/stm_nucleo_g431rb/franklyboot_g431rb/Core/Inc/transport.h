@@ -0,0 +1,116 @@
+/**
+ * @file transport.h
+ * @author agent (agent@local)
+ * @brief Communication transport interface of the bootloader (LPUART or FDCAN, selected at build time)
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ */
+
+#ifndef TRANSPORT_H_
+#define TRANSPORT_H_
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <francor/franklyboot/msg.h>
+#include <stdint.h>
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+namespace transport {
+
+constexpr uint32_t MSG_SIZE = {8U};
+
+#ifdef FRANKLYBOOT_TRANSPORT_FDCAN
+constexpr bool HAS_BROADCAST = {true};  // Broadcast ID is received in RX FIFO 1
+#else
+constexpr bool HAS_BROADCAST = {false};  // Point-to-point serial line
+#endif
+
+/**
+ * @brief Decodes message from the 8 byte wire format
+ */
+inline void decodeMsg(const uint8_t* buffer, franklyboot::msg::Msg& msg) {
+  const uint16_t rx_request_raw = static_cast<uint16_t>(buffer[0U]) | static_cast<uint16_t>(buffer[1U] << 8U);
+  msg.request = static_cast<franklyboot::msg::RequestType>(rx_request_raw);
+  msg.result = static_cast<franklyboot::msg::ResultType>(buffer[2U]);
+  msg.packet_id = static_cast<uint8_t>(buffer[3U]);
+  msg.data[0U] = static_cast<uint8_t>(buffer[4U]);
+  msg.data[1U] = static_cast<uint8_t>(buffer[5U]);
+  msg.data[2U] = static_cast<uint8_t>(buffer[6U]);
+  msg.data[3U] = static_cast<uint8_t>(buffer[7U]);
+}
+
+/**
+ * @brief Encodes message into the 8 byte wire format
+ */
+inline void encodeMsg(const franklyboot::msg::Msg& msg, uint8_t* buffer) {
+  buffer[0U] = static_cast<uint8_t>(msg.request);
+  buffer[1U] = static_cast<uint8_t>(msg.request >> 8U);
+  buffer[2U] = static_cast<uint8_t>(msg.result);
+  buffer[3U] = msg.packet_id;
+
+  buffer[4U] = msg.data.at(0);
+  buffer[5U] = msg.data.at(1);
+  buffer[6U] = msg.data.at(2);
+  buffer[7U] = msg.data.at(3);
+}
+
+/**
+ * @brief Setup DMA, interrupts and buffers of the transport (peripheral itself is configured in main.c)
+ */
+void init(void);
+
+/**
+ * @brief Stop all transfers and interrupts before handing over to the application
+ */
+void deinit(void);
+
+/**
+ * @brief Block until all queued responses are transmitted
+ */
+void flush(void);
+
+/**
+ * @brief Stops reception and transmission before a system clock change, setClock() resumes them
+ */
+void suspend(void);
+
+/**
+ * @brief Derives the clock dependent settings (baud rate or bit timing, timeouts) after a system clock change
+ */
+void setClock(uint32_t clock_hz);
+
+/**
+ * @brief Polls for a received message
+ *
+ * @param buffer    Receives MSG_SIZE bytes in wire format
+ * @param broadcast Set if the message was sent to the broadcast ID (always false without HAS_BROADCAST)
+ * @return true if a complete message was received
+ */
+bool receive(uint8_t* buffer, bool& broadcast);
+
+/**
+ * @brief Selects if raw data blocks (bulk page stream) instead of requests are received
+ *
+ * The rest of a received frame is discarded if the mode changes.
+ *
+ * @param num_blocks Number of raw blocks the stream still expects (0: requests are received)
+ */
+void setStreamMode(uint32_t num_blocks);
+
+/**
+ * @brief Queue response for transmission
+ */
+void transmit(const franklyboot::msg::Msg& response);
+
+/**
+ * @brief Processes extension requests of the transport (baud rate switch and frame mode of the serial line)
+ *
+ * @return true if the request was handled and the response is set
+ */
+bool processRequest(const franklyboot::msg::Msg& request, franklyboot::msg::Msg& response);
+
+};  // namespace transport
+
+#endif /* TRANSPORT_H_ */
@@ -13,9 +13,17 @@
 #include "bootloader_api.h"
 
 #include <francor/franklyboot/handler.h>
+#include <string.h>
 
 #include "device_defines.h"
+#include "discovery.h"
+#include "ext_config.h"
+#include "page_patch.h"
+#include "page_skip.h"
+#include "page_stream.h"
+#include "req_window.h"
 #include "stm32g4xx.h"
+#include "transport.h"
 
 using namespace franklyboot;
 
@@ -42,15 +50,116 @@ volatile uint32_t __DEVICE_IDENT__[4U]
 
 // Defines ------------------------------------------------------------------------------------------------------------
 constexpr uint32_t AUTOBOOT_DISABLE_OVERRIDE_KEY = {0xDEADBEEFU};
-constexpr uint32_t MSG_TIMEOUT_CNT = {device::SYS_TICK / 2000U};
-constexpr uint32_t MSG_SIZE = {8U};
+
+// Code executed while the flash is programmed in fast programming mode must not be fetched from flash
+#define RAM_FUNC __attribute__((section(".RamFunc")))
+
+using BootloaderHandler =
+    Handler<device::FLASH_START_ADDR, device::FLASH_APP_FIRST_PAGE, device::FLASH_SIZE, device::FLASH_PAGE_SIZE>;
+using BootloaderPageStream = ext::PageStream<BootloaderHandler, device::FLASH_PAGE_SIZE>;
+
+// Page erase is deferred until the page is written, pages which hold the data already are skipped
+using FlashPageSkip = ext::PageSkip<device::FLASH_START_ADDR, device::FLASH_PAGE_SIZE, 8U>;
+
+// Delta patches are applied in a separate page buffer
+using BootloaderPagePatch = ext::PagePatch<device::FLASH_START_ADDR, device::FLASH_APP_FIRST_PAGE, device::FLASH_SIZE,
+                                           device::FLASH_PAGE_SIZE>;
+
+// Outstanding requests granted to the host (limited by RX ring buffer and FDCAN RX FIFO size)
+constexpr uint32_t REQ_WINDOW_SIZE = {16U};
+
+// CRC unit is fed by DMA in one transfer (channel is only used by hwi::calculateCRC(), 16 bit transfer counter)
+static_assert((device::FLASH_SIZE / 4U) <= 0xFFFFU, "Flash does not fit into one CRC DMA transfer");
+
+// Flash programming: rows of 32 double words in fast programming mode, otherwise double words
+constexpr uint32_t FLASH_ROW_SIZE = {256U};
+constexpr uint32_t FLASH_SR_ERRORS = {FLASH_SR_OPERR | FLASH_SR_PROGERR | FLASH_SR_WRPERR | FLASH_SR_PGAERR |
+                                      FLASH_SR_SIZERR | FLASH_SR_PGSERR | FLASH_SR_MISERR | FLASH_SR_FASTERR};
+// Program complete rows in fast programming mode (interrupts are masked for each row)
+constexpr bool FLASH_FAST_PROGRAMMING = {true};
+
+/**
+ * Flash programming statistics (read via debugger)
+ */
+struct FlashStats {
+  uint32_t num_rows;                  //!< Number of rows programmed in fast programming mode
+  uint32_t num_double_words;          //!< Number of double words programmed in standard mode
+  uint32_t num_skipped_double_words;  //!< Number of double words not programmed (flash equal to data)
+  uint32_t num_errors;                //!< Number of failed erase or programming operations
+  uint32_t op_cycles_last;            //!< CPU cycles from start to end of the last erase or programming operation
+  uint32_t write_cycles_last;         //!< CPU cycles the last hwi::writeDataBufferToFlash() blocked the main loop
+};
+
+/**
+ * Asynchronous flash operation, started by the hardware interface and advanced by flashPoll()
+ */
+struct FlashJob {
+  bool active;                       //!< Operation in progress
+  bool erase;                        //!< Page erase (otherwise programming)
+  bool erase_pending;                //!< Erase command is issued by the next flashPoll()
+  bool program_after_erase;          //!< Range is programmed when the erase is finished (same job)
+  bool error;                        //!< Last operation failed (reported by the next operation)
+  uint32_t* dst_word_ptr;            //!< Next flash word to program
+  const uint32_t* dst_word_max_ptr;  //!< End of flash range to program
+  const uint32_t* src_word_ptr;      //!< Next word of the program buffer
+  uint32_t erase_page_id;            //!< Page of a pending erase command
+  uint32_t start_cycles;             //!< Cycle counter at start of the operation
+};
+
+/**
+ * CRC calculation statistics (read via debugger)
+ */
+struct CRCStats {
+  uint32_t num_bytes_last;    //!< Number of bytes of the last calculation
+  uint32_t cycles_last;       //!< CPU cycles of the last calculation
+  uint32_t bytes_per_s_last;  //!< Throughput of the last calculation
+};
+
+/**
+ * Main loop timing statistics in CPU cycles (read via debugger)
+ *
+ * The former blocking transmit spent 8 bytes * 10 bit times in transmitResponse() per reply, which are
+ * 11111 cycles at 16 MHz and 115200 baud. The difference to tx_cycles_last is the loop time freed
+ * by the DMA transmit queue.
+ */
+struct LoopStats {
+  uint32_t num_responses;     //!< Number of responses queued
+  uint32_t tx_cycles_last;    //!< Cycles spent in transmitResponse() for the last response
+  uint32_t tx_cycles_max;     //!< Maximum cycles spent in transmitResponse()
+  uint64_t tx_cycles_total;   //!< Total cycles spent in transmitResponse()
+  uint64_t busy_cycles_total; //!< Total cycles spent in the main loop excluding waiting for requests
+};
 
 // Private Variables --------------------------------------------------------------------------------------------------
 static volatile bool autostart_possible = {false};
 static volatile bool req_autostart = {false};
 
+static ext::RequestWindow<REQ_WINDOW_SIZE> req_window;
+
+static volatile CRCStats crc_stats;
+static volatile FlashStats flash_stats;
+
+// Second page buffer: the page is programmed from this copy while the handler fills its page buffer
+static FlashJob flash_job;
+static uint32_t flash_program_buffer[device::FLASH_PAGE_SIZE / 4U];
+static FlashPageSkip page_skip;
+static BootloaderPagePatch page_patch;
+
+static volatile LoopStats loop_stats;
+
+// Broadcast discovery of all nodes on the bus (FDCAN only)
+static ext::Discovery discovery(device::SYS_TICK);
+
+// System clock (SYS_TICK after reset, SYS_TICK_BOOST during update sessions) and settings derived from it
+static uint32_t sys_clock_hz = {device::SYS_TICK};
+static uint32_t stream_timeout_cnt = {device::SYS_TICK / 200U};
+
 // Private Function Prototypes ----------------------------------------------------------------------------------------
 
+static RAM_FUNC void flashPoll(void);
+static RAM_FUNC void flashFinish(void);
+static void transmitResponse(const msg::Msg& response);
+
 /**
  * @brief Checks if autostart shall be aborted by ping message request
  */
@@ -64,91 +173,151 @@ static void checkAutoStartAbort(msg::Msg& request) {
 }
 
 /**
- * @brief Block until message is received from serial line
+ * @brief Enable the DWT cycle counter used for loop instrumentation
  */
-static void waitForMessage(msg::Msg& request) {
-  std::array<std::uint8_t, MSG_SIZE> buffer;
-  uint32_t buffer_idx = 0U;
-  uint32_t timeout_cnt = 0U;
+static void initCycleCounter(void) {
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
 
+/**
+ * @brief Block until message is received from the transport
+ *
+ * Discovery responses are sent in the slot of the node while waiting. An open page stream is aborted if no data
+ * is received within stream_timeout_cnt loops.
+ *
+ * @param broadcast Set if the message was sent to the broadcast ID
+ */
+static void waitForMessage(uint8_t* buffer, bool& broadcast, BootloaderPageStream& page_stream) {
   for (;;) {
+    // Advance erase or programming of the previous page while waiting
+    flashPoll();
+
+    msg::Msg slot_response;
+    if (transport::HAS_BROADCAST && discovery.poll(DWT->CYCCNT, slot_response)) {
+      transmitResponse(slot_response);
+    }
+
     // Check for autostart override
     if (req_autostart) {
       hwi::startApp(device::FLASH_APP_START_ADDR);
+    } else if (transport::receive(buffer, broadcast)) {
+      break;
     } else {
-      // Otherwise wait for data
-      const uint8_t rx_new_byte = ((LPUART1->ISR & USART_ISR_RXNE) == USART_ISR_RXNE);
-      if (rx_new_byte) {
-        buffer[buffer_idx] = LPUART1->RDR;
-        buffer_idx++;
-
-        if (buffer_idx >= buffer.size()) {
-          break;
-        }
-
-        timeout_cnt = 0U;
-      } else {
-        // Check if new message has started
-        // If new byte is not received within a timeout cnt
-        // the message is ignored
-        if (buffer_idx != 0) {
-          timeout_cnt++;
-
-          if (timeout_cnt >= MSG_TIMEOUT_CNT) {
-            buffer_idx = 0U;
-          }
-        }
-      }
+      page_stream.checkTimeout(stream_timeout_cnt);
+      transport::setStreamMode(page_stream.getPendingBlocks());
     }
   }
-
-  /* Decode message */
-  const uint16_t rx_request_raw = static_cast<uint16_t>(buffer[0U]) | static_cast<uint16_t>(buffer[1U] << 8U);
-  request.request = static_cast<msg::RequestType>(rx_request_raw);
-  request.result = static_cast<msg::ResultType>(buffer[2U]);
-  request.packet_id = static_cast<uint8_t>(buffer[3U]);
-  request.data[0U] = static_cast<uint8_t>(buffer[4U]);
-  request.data[1U] = static_cast<uint8_t>(buffer[5U]);
-  request.data[2U] = static_cast<uint8_t>(buffer[6U]);
-  request.data[3U] = static_cast<uint8_t>(buffer[7U]);
 }
 
 /**
- * @brief Transmit response over serial line
+ * @brief Queue response for transmission over the transport
  */
 static void transmitResponse(const msg::Msg& response) {
-  std::array<std::uint8_t, MSG_SIZE> buffer;
+  const uint32_t start_cycles = DWT->CYCCNT;
+
+  transport::transmit(response);
+
+  /* Update statistics */
+  const uint32_t tx_cycles = DWT->CYCCNT - start_cycles;
+  loop_stats.num_responses = loop_stats.num_responses + 1U;
+  loop_stats.tx_cycles_last = tx_cycles;
+  loop_stats.tx_cycles_total = loop_stats.tx_cycles_total + tx_cycles;
+  if (tx_cycles > loop_stats.tx_cycles_max) {
+    loop_stats.tx_cycles_max = tx_cycles;
+  }
+}
+
+/**
+ * @brief Switch system clock between HSI16 (SYS_TICK) and PLL (SYS_TICK_BOOST)
+ *
+ * PLL: HSI16 / 4 * 85 / 2 = 170 MHz in range 1 boost mode with 4 flash wait states. The AHB clock is
+ * halved for 1 us after the switch to the PLL to limit the current step.
+ */
+static void switchSysClock(const bool boost) {
+  if (boost) {
+    CLEAR_BIT(PWR->CR5, PWR_CR5_R1MODE);
+    MODIFY_REG(FLASH->ACR, FLASH_ACR_LATENCY, FLASH_ACR_LATENCY_4WS);
+    SET_BIT(FLASH->ACR, FLASH_ACR_PRFTEN);
+    while ((FLASH->ACR & FLASH_ACR_LATENCY) != FLASH_ACR_LATENCY_4WS) {
+      __NOP();
+    }
 
-  /* Encode message */
-  buffer[0U] = static_cast<uint8_t>(response.request);
-  buffer[1U] = static_cast<uint8_t>(response.request >> 8U);
-  buffer[2U] = static_cast<uint8_t>(response.result);
-  buffer[3U] = response.packet_id;
+    RCC->PLLCFGR = RCC_PLLCFGR_PLLSRC_HSI | (3U << RCC_PLLCFGR_PLLM_Pos) | (85U << RCC_PLLCFGR_PLLN_Pos) |
+                   RCC_PLLCFGR_PLLREN;
+    SET_BIT(RCC->CR, RCC_CR_PLLON);
+    while ((RCC->CR & RCC_CR_PLLRDY) != RCC_CR_PLLRDY) {
+      __NOP();
+    }
 
-  buffer[4U] = response.data.at(0);
-  buffer[5U] = response.data.at(1);
-  buffer[6U] = response.data.at(2);
-  buffer[7U] = response.data.at(3);
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_HPRE, RCC_CFGR_HPRE_DIV2);
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_SW, RCC_CFGR_SW_PLL);
+    while ((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL) {
+      __NOP();
+    }
 
-  /* Transmit message */
-  for (uint32_t buffer_idx = 0U; buffer_idx < buffer.size(); buffer_idx++) {
-    uint8_t tx_not_ready = ((LPUART1->ISR & USART_ISR_TXE) == USART_ISR_TXE);
+    // 85 cycles at 85 MHz
+    const uint32_t start_cycles = DWT->CYCCNT;
+    while ((DWT->CYCCNT - start_cycles) < (device::SYS_TICK_BOOST / 2000000U)) {
+      __NOP();
+    }
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_HPRE, RCC_CFGR_HPRE_DIV1);
+  } else {
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_SW, RCC_CFGR_SW_HSI);
+    while ((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_HSI) {
+      __NOP();
+    }
+    CLEAR_BIT(RCC->CR, RCC_CR_PLLON);
 
-    LPUART1->TDR = buffer.at(buffer_idx);
+    CLEAR_BIT(FLASH->ACR, FLASH_ACR_PRFTEN);
+    MODIFY_REG(FLASH->ACR, FLASH_ACR_LATENCY, FLASH_ACR_LATENCY_0WS);
+    SET_BIT(PWR->CR5, PWR_CR5_R1MODE);
+  }
+}
 
-    do {
-      tx_not_ready = !((LPUART1->ISR & USART_ISR_TXE) == USART_ISR_TXE);
-    } while (tx_not_ready);
+/**
+ * @brief Change system clock and derive the clock dependent settings
+ *
+ * Must only be called while the host waits for a response, received data is lost during the change.
+ */
+static void setSysClock(const uint32_t clock_hz) {
+  if (clock_hz == sys_clock_hz) {
+    return;
   }
+
+  flashFinish();
+  transport::flush();
+  transport::suspend();
+
+  switchSysClock(clock_hz == device::SYS_TICK_BOOST);
+  sys_clock_hz = clock_hz;
+  stream_timeout_cnt = clock_hz / 200U;
+  discovery.setClock(clock_hz);
+  transport::setClock(clock_hz);
+}
+
+/**
+ * @brief Returns the bootloader version reported by the handler
+ */
+static uint32_t getBootloaderVersion(BootloaderHandler& handler) {
+  msg::Msg request = {};
+  request.request = msg::REQ_DEV_INFO_BOOTLOADER_VERSION;
+  request.result = msg::RES_NONE;
+  handler.processRequest(request);
+  return ext::getDataWord(handler.getResponse());
 }
 
 // Public Functions ---------------------------------------------------------------------------------------------------
 
-extern "C" void FRANKLYBOOT_Init(void) {}
+extern "C" void FRANKLYBOOT_Init(void) {
+  initCycleCounter();
+  transport::init();
+}
 
 extern "C" void FRANKLYBOOT_Run(void) {
-  Handler<device::FLASH_START_ADDR, device::FLASH_APP_FIRST_PAGE, device::FLASH_SIZE, device::FLASH_PAGE_SIZE>
-      hBootloader;
+  BootloaderHandler hBootloader;
+  BootloaderPageStream page_stream(hBootloader);
 
   // Check if autostart shall be disabled by app firmware via backup register
   const bool autostart_disable = (TAMP->BKP0R == AUTOBOOT_DISABLE_OVERRIDE_KEY);
@@ -157,16 +326,62 @@ extern "C" void FRANKLYBOOT_Run(void) {
   // Autostart is possible if a valid app in flash is available
   autostart_possible = hBootloader.isAppValid() && !autostart_disable;
 
+  // Answer of broadcast discovery requests
+  if (transport::HAS_BROADCAST) {
+    discovery.setDeviceInfo(hwi::getVendorID(), hwi::getProductID(), getBootloaderVersion(hBootloader),
+                            ext::hashUniqueID(hwi::getUniqueIDWord(0U), hwi::getUniqueIDWord(1U),
+                                              hwi::getUniqueIDWord(2U)));
+  }
+
   // TODO init sys tick in main.c!
 
   for (;;) {
-    msg::Msg request;
+    std::array<uint8_t, transport::MSG_SIZE> buffer;
+    bool broadcast = false;
     hBootloader.processBufferedCmds();
-    waitForMessage(request);
-    checkAutoStartAbort(request);
-    hBootloader.processRequest(request);
-    const auto response = hBootloader.getResponse();
-    transmitResponse(response);
+    waitForMessage(buffer.data(), broadcast, page_stream);
+    const uint32_t start_cycles = DWT->CYCCNT;
+
+    msg::Msg response;
+    if (ext::EXT_PAGE_STREAM && page_stream.isActive() && !broadcast) {
+      // Raw data block of bulk page stream, acknowledged once per page
+      if (page_stream.feed(buffer.data(), response)) {
+        transport::setStreamMode(0U);
+        transmitResponse(response);
+      } else {
+        transport::setStreamMode(page_stream.getPendingBlocks());
+      }
+    } else {
+      msg::Msg request;
+      transport::decodeMsg(buffer.data(), request);
+      checkAutoStartAbort(request);
+
+      // Update session has started, run it with the PLL clock
+      if (!autostart_possible) {
+        setSysClock(device::SYS_TICK_BOOST);
+      }
+
+      // Process request directly or in order of the request window
+      const auto process = [&](const msg::Msg& req) {
+        msg::Msg resp;
+        if (!(ext::EXT_PAGE_STREAM && page_stream.processRequest(req, resp)) && !page_skip.processRequest(req, resp) &&
+            !(ext::EXT_PAGE_PATCH && page_patch.processRequest(req, resp)) && !transport::processRequest(req, resp)) {
+          hBootloader.processRequest(req);
+          resp = hBootloader.getResponse();
+        }
+        return resp;
+      };
+
+      if (transport::HAS_BROADCAST && broadcast && discovery.processBroadcast(request, DWT->CYCCNT)) {
+        // Discovery request, answered in the slot of the node while waiting for the next message
+      } else if (!(ext::EXT_REQ_WINDOW && req_window.processRequest(request, process, transmitResponse))) {
+        transmitResponse(process(request));
+      }
+
+      transport::setStreamMode(page_stream.getPendingBlocks());
+    }
+
+    loop_stats.busy_cycles_total = loop_stats.busy_cycles_total + (DWT->CYCCNT - start_cycles);
   }
 }
 
@@ -181,7 +396,13 @@ extern "C" void FRANKLYBOOT_autoStartISR(void) {
 
 // Hardware Interface -------------------------------------------------------------------------------------------------
 
-void hwi::resetDevice() { 
+void hwi::resetDevice() {
+  /* Finish pending flash operation */
+  flashFinish();
+
+  /* Finish pending responses */
+  transport::flush();
+
   /* Delay system reset */
   for(uint32_t idx = 0U; idx < 1000000U; idx++) {
     __NOP();
@@ -209,29 +430,145 @@ void hwi::resetDevice() {
   return uid_value;
 }
 
+/**
+ * @brief Feeds words to the CRC unit by DMA (memory to memory mode, no DMA request needed)
+ *
+ * hwi::calculateCRC() returns the result, so the main loop waits for the transfer. The DMA frees the CPU
+ * from the load/store loop only, the RX ISRs continue to buffer requests meanwhile.
+ */
+static void feedCRCByDMA(const uint32_t src_address, const uint32_t num_words) {
+  if (num_words == 0U) {
+    return;
+  }
+
+  DMA1_Channel3->CCR = 0U;
+  DMA1_Channel3->CPAR = (uint32_t)(&CRC->DR);
+  DMA1_Channel3->CMAR = src_address;
+  DMA1_Channel3->CNDTR = num_words;
+  DMA1_Channel3->CCR = DMA_CCR_MEM2MEM | DMA_CCR_MSIZE_1 | DMA_CCR_PSIZE_1 | DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_EN;
+
+  // Wait for transfer (channel is disabled by hardware on transfer error)
+  while ((DMA1_Channel3->CNDTR != 0U) && ((DMA1_Channel3->CCR & DMA_CCR_EN) == DMA_CCR_EN)) {
+    __NOP();
+  }
+  DMA1_Channel3->CCR = 0U;
+}
+
 uint32_t hwi::calculateCRC(uint32_t src_address, uint32_t num_bytes) {
+  flashFinish();
+
+  const uint32_t start_cycles = DWT->CYCCNT;
+
   // Reset CRC calculation
   SET_BIT(CRC->CR, CRC_CR_RESET);
 
   const uint32_t num_words = num_bytes >> 2u;
 
-  // Pointer to data
-  uint32_t* data_ptr = (uint32_t*)src_address;
+  // Input data is bit reversed by word in the CRC unit (see initCRC() in main.c)
+  if ((src_address & 0x3U) == 0U) {
+    feedCRCByDMA(src_address, num_words);
+  } else {
+    // Unaligned region: words are assembled from bytes
+    const uint8_t* data_ptr = (const uint8_t*)src_address;
+    for (uint32_t idx = 0u; idx < num_words; idx++) {
+      uint32_t word;
+      memcpy(&word, &data_ptr[idx * 4U], sizeof(word));
+      CRC->DR = word;
+    }
+  }
+
+  const uint32_t crc = ~CRC->DR;
+
+  /* Update statistics */
+  const uint32_t cycles = DWT->CYCCNT - start_cycles;
+  crc_stats.num_bytes_last = num_bytes;
+  crc_stats.cycles_last = cycles;
+  if (cycles != 0U) {
+    crc_stats.bytes_per_s_last = (uint32_t)(((uint64_t)num_bytes * sys_clock_hz) / cycles);
+  }
+
+  return crc;
+}
+
+/**
+ * @brief Returns true if all bytes of the flash row are erased
+ */
+static RAM_FUNC bool isFlashRowErased(const uint32_t* dst_word_ptr) {
+  for (uint32_t idx = 0U; idx < (FLASH_ROW_SIZE / 4U); idx++) {
+    if (dst_word_ptr[idx] != 0xFFFFFFFFU) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Starts programming of the next row (fast programming mode) or double word of the flash job
+ *
+ * The double words of a row must be written without gap, so interrupts (vector table and ISRs in
+ * flash) are masked while the row is written. Waiting for the row is done by flashPoll().
+ *
+ * @return false if the double word holds the data already and is skipped (nothing started)
+ */
+static RAM_FUNC bool flashStartProgramStep(void) {
+  uint32_t* dst_word_ptr = flash_job.dst_word_ptr;
+  const uint32_t* src_word_ptr = flash_job.src_word_ptr;
+
+  const bool row_aligned = ((((uint32_t)dst_word_ptr) & (FLASH_ROW_SIZE - 1U)) == 0U);
+  const bool row_complete = ((uint32_t)(flash_job.dst_word_max_ptr - dst_word_ptr) >= (FLASH_ROW_SIZE / 4U));
 
-  for (uint32_t idx = 0u; idx < num_words; idx++) {
-    const uint32_t value = *(data_ptr);
-    CRC->DR = __REV(value);
-    data_ptr++;
+  if (FLASH_FAST_PROGRAMMING && row_aligned && row_complete && isFlashRowErased(dst_word_ptr)) {
+    FLASH->CR = (FLASH->CR & ~FLASH_CR_PG) | FLASH_CR_FSTPG;
+
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    for (uint32_t idx = 0U; idx < (FLASH_ROW_SIZE / 4U); idx++) {
+      dst_word_ptr[idx] = src_word_ptr[idx];
+    }
+    __set_PRIMASK(primask);
+
+    flash_job.dst_word_ptr += (FLASH_ROW_SIZE / 4U);
+    flash_job.src_word_ptr += (FLASH_ROW_SIZE / 4U);
+    flash_stats.num_rows = flash_stats.num_rows + 1U;
+  } else if ((dst_word_ptr[0U] == src_word_ptr[0U]) && (dst_word_ptr[1U] == src_word_ptr[1U])) {
+    // Page programmed without erase: double word must not be programmed again
+    flash_job.dst_word_ptr += 2U;
+    flash_job.src_word_ptr += 2U;
+    flash_stats.num_skipped_double_words = flash_stats.num_skipped_double_words + 1U;
+    return false;
+  } else {
+    // Both words are written back to back as one double word: the first write is latched, the write of the
+    // second word starts the programming of the double word (BSY set until it is finished)
+    FLASH->CR = (FLASH->CR & ~FLASH_CR_FSTPG) | FLASH_CR_PG;
+    dst_word_ptr[0U] = src_word_ptr[0U];
+    dst_word_ptr[1U] = src_word_ptr[1U];
+
+    flash_job.dst_word_ptr += 2U;
+    flash_job.src_word_ptr += 2U;
+    flash_stats.num_double_words = flash_stats.num_double_words + 1U;
   }
 
-  return ~CRC->DR;
+  return true;
 }
 
-bool hwi::eraseFlashPage(uint32_t page_id) {
-  // Unlock flash
-  FLASH->KEYR = 0x45670123U;
-  FLASH->KEYR = 0xCDEF89ABU;
+/**
+ * @brief Starts the next programming step of the flash job
+ *
+ * @return false if all remaining double words are skipped (programming finished)
+ */
+static RAM_FUNC bool flashProgramNextStep(void) {
+  while (flash_job.dst_word_ptr < flash_job.dst_word_max_ptr) {
+    if (flashStartProgramStep()) {
+      return true;
+    }
+  }
+  return false;
+}
 
+/**
+ * @brief Issues the page erase command of a started erase job
+ */
+static RAM_FUNC void flashEraseCommand(const uint32_t page_id) {
   uint32_t tmp_reg_value = FLASH->CR;
   tmp_reg_value |= FLASH_CR_PER;                   // Enable page erase mode
   tmp_reg_value &= ~(FLASH_CR_PNB_Msk);            // Clear old page idx
@@ -240,75 +577,188 @@ bool hwi::eraseFlashPage(uint32_t page_id) {
 
   // Start erase page
   FLASH->CR = FLASH->CR | FLASH_CR_STRT;
+}
+
+/**
+ * @brief Advances the flash job if the flash is not busy anymore (called from the main loop)
+ */
+static RAM_FUNC void flashPoll(void) {
+  if (!flash_job.active || ((FLASH->SR & FLASH_SR_BSY) == FLASH_SR_BSY)) {
+    return;
+  }
 
-  // Wait for erase to finish
-  bool in_progress = true;
-  while (in_progress) {
-    in_progress = ((FLASH->SR & FLASH_SR_BSY) == FLASH_SR_BSY);
+  if (flash_job.erase_pending) {
+    flash_job.erase_pending = false;
+    flashEraseCommand(flash_job.erase_page_id);
+    return;
   }
 
-  // Clear page erase mode
-  FLASH->CR &= ~FLASH_CR_PER;
+  // Check and clear result of the finished step
+  const uint32_t status = FLASH->SR;
+  FLASH->SR = status & (FLASH_SR_ERRORS | FLASH_SR_EOP);
+  const bool step_failed = ((status & FLASH_SR_ERRORS) != 0U);
 
-  // Lock flash
+  if (!step_failed && flash_job.erase && flash_job.program_after_erase) {
+    // Page erased: continue with its programming
+    FLASH->CR &= ~FLASH_CR_PER;
+    flash_job.erase = false;
+  }
+
+  if (!step_failed && !flash_job.erase && flashProgramNextStep()) {
+    return;
+  }
+
+  // Operation finished: leave erase/programming mode and lock flash
+  FLASH->CR &= ~(FLASH_CR_PER | FLASH_CR_PG | FLASH_CR_FSTPG);
   FLASH->CR |= FLASH_CR_LOCK;
 
-  return true;
+  flash_job.active = false;
+  if (step_failed) {
+    flash_job.error = true;
+    flash_stats.num_errors = flash_stats.num_errors + 1U;
+  }
+  flash_stats.op_cycles_last = DWT->CYCCNT - flash_job.start_cycles;
 }
 
-bool hwi::writeDataBufferToFlash(uint32_t dst_address, uint32_t dst_page_id, uint8_t* src_data_ptr,
-                                 uint32_t num_bytes) {
-  // Check if data size is correct
-  bool data_size_valid = ((num_bytes % 8) == 0);
+/**
+ * @brief Blocks until the flash job is finished (before the flash is read or a new job is started)
+ */
+static RAM_FUNC void flashWaitIdle(void) {
+  while (flash_job.active) {
+    flashPoll();
+  }
+}
+
+/**
+ * @brief Waits for the previous flash job and unlocks the flash for the next one
+ *
+ * @return false if the previous job failed. The failure is reported once, the new job is not started.
+ */
+static RAM_FUNC bool flashStartJob(const bool erase) {
+  flashWaitIdle();
 
-  if (data_size_valid) {
-    // Unlock flash
+  if (flash_job.error) {
+    flash_job.error = false;
+    return false;
+  }
+
+  // Unlock flash and clear flags of previous operations
+  if ((FLASH->CR & FLASH_CR_LOCK) == FLASH_CR_LOCK) {
     FLASH->KEYR = 0x45670123U;
     FLASH->KEYR = 0xCDEF89ABU;
+  }
+  FLASH->SR = FLASH_SR_ERRORS | FLASH_SR_EOP;
 
-    // Enable programming
-    FLASH->CR |= FLASH_CR_PG;
+  flash_job.active = true;
+  flash_job.erase = erase;
+  flash_job.erase_pending = false;
+  flash_job.program_after_erase = false;
+  flash_job.start_cycles = DWT->CYCCNT;
+  return true;
+}
 
-    // Write data
-    uint32_t* dst_word_ptr = (uint32_t*)(dst_address);
-    const uint32_t* dst_word_max_ptr = (uint32_t*)(dst_address + num_bytes);
-    uint32_t* src_data_word_ptr = (uint32_t*)(src_data_ptr);
+/**
+ * @brief Starts erase of the page (NO_PAGE: nothing to erase), finished by flashPoll()
+ */
+static RAM_FUNC bool flashStartErase(const uint32_t page_id) {
+  if (page_id == FlashPageSkip::NO_PAGE) {
+    return true;
+  }
 
-    while (dst_word_ptr < dst_word_max_ptr) {
-      // Write word to flash
-      *(dst_word_ptr) = *(src_data_word_ptr);
+  if (!flashStartJob(true)) {
+    return false;
+  }
 
-      // Wait until finished
-      bool in_progress = true;
-      while (in_progress) {
-        in_progress = ((FLASH->SR & FLASH_SR_BSY) == FLASH_SR_BSY);
-      }
+  flashEraseCommand(page_id);
+  return true;
+}
 
-      // Increase pointer
-      dst_word_ptr++;
-      src_data_word_ptr++;
-    }
+/**
+ * @brief Executes deferred erase and waits until the flash is idle (before the flash is read or left)
+ */
+static RAM_FUNC void flashFinish(void) {
+  flashStartErase(page_skip.takeDeferredErase());
+  flashWaitIdle();
+}
+
+RAM_FUNC bool hwi::eraseFlashPage(uint32_t page_id) {
+  // Erase of this page is deferred until the page buffer is written, a previously deferred one starts now
+  return flashStartErase(page_skip.deferErase(page_id));
+}
+
+RAM_FUNC bool hwi::writeDataBufferToFlash(uint32_t dst_address, uint32_t dst_page_id, uint8_t* src_data_ptr,
+                                          uint32_t num_bytes) {
+  const uint32_t start_cycles = DWT->CYCCNT;
+
+  // Check if data size is correct
+  bool data_size_valid = ((num_bytes % 8) == 0) && (num_bytes <= sizeof(flash_program_buffer));
+
+  if (!data_size_valid || !flashStartErase(page_skip.takeDeferredErase(dst_page_id))) {
+    return false;
+  }
 
-    // LOCK FLASH
-    uint32_t tmp_reg_value = FLASH->CR;
-    tmp_reg_value &= ~FLASH_CR_PG;
-    tmp_reg_value |= FLASH_CR_LOCK;
-    FLASH->CR = tmp_reg_value;
+  // Compare page buffer with the flash content, which must not change meanwhile
+  flashWaitIdle();
+  const auto action = page_skip.prepareWrite(dst_page_id, dst_address, src_data_ptr, num_bytes);
 
+  if (action == FlashPageSkip::WRITE_SKIP) {
     return true;
   }
 
-  return false;
+  const bool erase = (action == FlashPageSkip::WRITE_ERASE_PROGRAM);
+  if (!flashStartJob(erase)) {
+    return false;
+  }
+
+  // Program from a copy, so the handler can fill its page buffer with the next page meanwhile
+  const uint32_t* src_data_word_ptr = (const uint32_t*)(src_data_ptr);
+  for (uint32_t idx = 0U; idx < (num_bytes / 4U); idx++) {
+    flash_program_buffer[idx] = src_data_word_ptr[idx];
+  }
+
+  flash_job.dst_word_ptr = (uint32_t*)(dst_address);
+  flash_job.dst_word_max_ptr = (uint32_t*)(dst_address + num_bytes);
+  flash_job.src_word_ptr = flash_program_buffer;
+
+  if (erase) {
+    // Erase and programming run as one job. The erase is issued by flashPoll() after the response is queued,
+    // so a host sending ahead (request window, page stream) transmits while the page is erased. The RX path
+    // buffers its frames, the main loop stalls on flash fetches until the erase is finished.
+    flash_job.erase_pending = true;
+    flash_job.program_after_erase = true;
+    flash_job.erase_page_id = dst_page_id;
+  } else {
+    // Start first step, the following steps are started by flashPoll()
+    flashProgramNextStep();
+  }
+
+  flash_stats.write_cycles_last = DWT->CYCCNT - start_cycles;
+  return true;
 }
 
 [[nodiscard]] uint8_t franklyboot::hwi::readByteFromFlash(uint32_t flash_src_address) {
+  flashFinish();
+
   uint8_t* flash_src_ptr = (uint8_t*)(flash_src_address);
   return *(flash_src_ptr);
 }
 
-void franklyboot::hwi::startApp(uint32_t app_flash_address) {  // Disable interrupts
+void franklyboot::hwi::startApp(uint32_t app_flash_address) {
+  // Finish pending flash operation
+  flashFinish();
+
+  // Finish pending responses
+  transport::flush();
+
+  // Application expects the clock after reset
+  setSysClock(device::SYS_TICK);
+
+  // Disable interrupts
   __disable_irq();
 
+  // Stop transport transfers and interrupts
+  transport::deinit();
+
   // Clear pending interrupts
   NVIC->ICPR[0] = 0xFFFFFFFFu;
 
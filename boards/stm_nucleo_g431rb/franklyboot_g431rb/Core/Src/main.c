@@ -11,6 +11,7 @@
 
 // Includes -----------------------------------------------------------------------------------------------------------
 #include "bootloader_api.h"
+#include "device_defines.h"
 #include "stm32g4xx.h"
 
 // Private Functions --------------------------------------------------------------------------------------------------
@@ -18,6 +19,14 @@
 /** \brief Init core and sys clocks */
 static void initCore(void);
 
+#ifdef FRANKLYBOOT_TRANSPORT_FDCAN
+/** \brief Init FDCAN1 with 500 kBit/s nominal and 2 MBit/s data bit rate */
+static void initFDCAN(void);
+#else
+/** \brief Init LPUART1 pins and auto-baud edge detection (baud rate is set by the transport) */
+static void initLPUART(void);
+#endif
+
 /** \brief Init CRC unit */
 static void initCRC(void);
 
@@ -28,6 +37,11 @@ static void initSysTick(void);
 
 void SystemInit(void) {
   initCore();
+#ifdef FRANKLYBOOT_TRANSPORT_FDCAN
+  initFDCAN();
+#else
+  initLPUART();
+#endif
   initCRC();
   initSysTick();
   FRANKLYBOOT_Init();
@@ -40,6 +54,16 @@ int main(void) {
 
 void SysTick_Handler(void) { FRANKLYBOOT_autoStartISR(); }
 
+#ifndef FRANKLYBOOT_TRANSPORT_FDCAN
+void DMA1_Channel1_IRQHandler(void) { FRANKLYBOOT_serialRxISR(); }
+
+void DMA1_Channel2_IRQHandler(void) { FRANKLYBOOT_serialTxISR(); }
+
+void LPUART1_IRQHandler(void) { FRANKLYBOOT_serialRxISR(); }
+
+void EXTI3_IRQHandler(void) { FRANKLYBOOT_serialEdgeISR(); }
+#endif
+
 // Private Functions --------------------------------------------------------------------------------------------------
 
 static void initCore(void) {
@@ -57,9 +81,81 @@ static void initCore(void) {
 
   // Enable Clocks
   RCC->BDCR |= RCC_BDCR_RTCEN;
-  RCC->AHB1ENR = RCC_AHB1ENR_FLASHEN | RCC_AHB1ENR_CRCEN;
+  RCC->AHB1ENR = RCC_AHB1ENR_FLASHEN | RCC_AHB1ENR_CRCEN | RCC_AHB1ENR_DMA1EN | RCC_AHB1ENR_DMAMUX1EN;
   RCC->AHB2ENR = RCC_AHB2ENR_GPIOAEN;
   RCC->APB1ENR1 |= RCC_APB1ENR1_RTCAPBEN | RCC_APB1ENR1_PWREN;
+
+  // Enable RTC for backup register access
+  // Used for autostart overwrite
+  PWR->CR1 |= PWR_CR1_DBP;
+  __NOP();
+}
+
+#ifdef FRANKLYBOOT_TRANSPORT_FDCAN
+
+static void initFDCAN(void) {
+  // Enable clock and use PCLK1 as FDCAN kernel clock
+  RCC->APB1ENR1 |= RCC_APB1ENR1_FDCANEN;
+  MODIFY_REG(RCC->CCIPR, RCC_CCIPR_FDCANSEL, RCC_CCIPR_FDCANSEL_1);
+
+  // Config GPIOs for FDCAN Pin PA11 (RX) & PA12 (TX)
+
+  // Setup alternate function mode
+  uint32_t regValue = GPIOA->MODER;
+  CLEAR_BIT(regValue, (GPIO_MODER_MODE11_Msk | GPIO_MODER_MODE12_Msk));
+  SET_BIT(regValue, (2U << GPIO_MODER_MODE11_Pos) | (2U << GPIO_MODER_MODE12_Pos));
+  GPIOA->MODER = regValue;
+
+  // Setup AF9 mode for FDCAN
+  MODIFY_REG(GPIOA->AFR[1], GPIO_AFRH_AFSEL11_Msk | GPIO_AFRH_AFSEL12_Msk,
+             (9U << GPIO_AFRH_AFSEL11_Pos) | (9U << GPIO_AFRH_AFSEL12_Pos));
+
+  // Enter init mode and enable configuration change
+  SET_BIT(FDCAN1->CCCR, FDCAN_CCCR_INIT);
+  while ((FDCAN1->CCCR & FDCAN_CCCR_INIT) != FDCAN_CCCR_INIT) {
+    __NOP();
+  }
+  SET_BIT(FDCAN1->CCCR, FDCAN_CCCR_CCE);
+
+  // Enable CAN-FD frames with bit rate switching
+  SET_BIT(FDCAN1->CCCR, FDCAN_CCCR_FDOE | FDCAN_CCCR_BRSE);
+
+  // Nominal bit rate 500 kBit/s: 16 MHz / 1 / (1 + 26 + 5) -> sample point 84 %
+  FDCAN1->NBTP = (3U << FDCAN_NBTP_NSJW_Pos) | (0U << FDCAN_NBTP_NBRP_Pos) | (25U << FDCAN_NBTP_NTSEG1_Pos) |
+                 (4U << FDCAN_NBTP_NTSEG2_Pos);
+
+  // Data bit rate 2 MBit/s: 16 MHz / 1 / (1 + 5 + 2) -> sample point 75 %, with delay compensation
+  FDCAN1->DBTP = FDCAN_DBTP_TDC | (0U << FDCAN_DBTP_DBRP_Pos) | (4U << FDCAN_DBTP_DTSEG1_Pos) |
+                 (1U << FDCAN_DBTP_DTSEG2_Pos) | (1U << FDCAN_DBTP_DSJW_Pos);
+  FDCAN1->TDCR = (5U << FDCAN_TDCR_TDCO_Pos);
+
+  // Determine IDs
+  const uint32_t msg_broadcast_id = CAN_BROADCAST_ID;
+  const uint32_t msg_node_id = (msg_broadcast_id + 1U) + (CAN_NODE_ID << 1U);
+
+  // Setup standard ID filters in message RAM (classic filter: SFT = 2, ID and mask)
+  // Node messages to FIFO 0 (SFEC = 1), broadcast messages to FIFO 1 (SFEC = 2)
+  volatile uint32_t* filter_list = (volatile uint32_t*)(SRAMCAN_BASE);
+  filter_list[0] = (2U << 30U) | (1U << 27U) | (msg_node_id << 16U) | 0x7FFU;
+  filter_list[1] = (2U << 30U) | (2U << 27U) | (msg_broadcast_id << 16U) | 0x7FFU;
+
+  // Use both filters and reject all other frames
+  FDCAN1->RXGFC = (2U << FDCAN_RXGFC_LSS_Pos) | (2U << FDCAN_RXGFC_ANFS_Pos) | (2U << FDCAN_RXGFC_ANFE_Pos) |
+                  FDCAN_RXGFC_RRFS | FDCAN_RXGFC_RRFE;
+
+  // Transmit buffers are used as FIFO
+  CLEAR_BIT(FDCAN1->TXBC, FDCAN_TXBC_TFQM);
+
+  // Leave init mode
+  CLEAR_BIT(FDCAN1->CCCR, FDCAN_CCCR_INIT);
+  while ((FDCAN1->CCCR & FDCAN_CCCR_INIT) == FDCAN_CCCR_INIT) {
+    __NOP();
+  }
+}
+
+#else
+
+static void initLPUART(void) {
   RCC->APB1ENR2 |= RCC_APB1ENR2_LPUART1EN;
 
   // Config GPIOs for UART Pin PA2 & PA3
@@ -74,19 +170,16 @@ static void initCore(void) {
   SET_BIT(GPIOA->AFR[0], (12 << GPIO_AFRL_AFSEL2_Pos));
   SET_BIT(GPIOA->AFR[0], (12 << GPIO_AFRL_AFSEL3_Pos));
 
-  // Setup UART
-  WRITE_REG(LPUART1->BRR, 0x8AE4);
-  WRITE_REG(LPUART1->CR1, 0xD);
-
-  // Enable RTC for backup register access
-  // Used for autostart overwrite
-  PWR->CR1 |= PWR_CR1_DBP;
-  __NOP();
+  // Route PA3 to EXTI3 to timestamp the edges of the auto-baud sync byte
+  RCC->APB2ENR |= RCC_APB2ENR_SYSCFGEN;
+  MODIFY_REG(SYSCFG->EXTICR[0], SYSCFG_EXTICR1_EXTI3, SYSCFG_EXTICR1_EXTI3_PA);
 }
 
+#endif
+
 static void initCRC(void) {
-  // Set data input inversion mode to byte
-  MODIFY_REG(CRC->CR, CRC_CR_REV_IN, CRC_CR_REV_IN_0);
+  // Set data input inversion mode to word (words are fed in memory order, no byte swap needed)
+  MODIFY_REG(CRC->CR, CRC_CR_REV_IN, CRC_CR_REV_IN);
 
   // Set data output inversion
   MODIFY_REG(CRC->CR, CRC_CR_REV_OUT, CRC_CR_REV_OUT);
@@ -0,0 +1,296 @@
+/**
+ * @file transport_fdcan.cpp
+ * @author agent (agent@local)
+ * @brief FDCAN1 transport with bit rate switching and up to 8 messages per 64 byte frame
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include "bootloader_api.h"
+#include "can_bit_timing.h"
+#include "device_defines.h"
+#include "fdcan_frame.h"
+#include "stm32g4xx.h"
+#include "transport.h"
+
+using namespace franklyboot;
+
+// Defines ------------------------------------------------------------------------------------------------------------
+
+// Bit rates on the bus. The bit timing is derived from the kernel clock (PCLK1 = system clock) with the
+// sample points of the initial configuration in main.c.
+constexpr uint32_t CAN_NOMINAL_BIT_RATE = {500000U};
+constexpr uint32_t CAN_NOMINAL_SAMPLE_POINT = {844U};
+constexpr uint32_t CAN_DATA_BIT_RATE = {2000000U};
+constexpr uint32_t CAN_DATA_SAMPLE_POINT = {750U};
+
+// Fixed message RAM layout of FDCAN1 (offsets in bytes, see RM0440 "Message RAM")
+constexpr uint32_t MSG_RAM_RX_FIFO0_OFFSET = {0x0B0U};
+constexpr uint32_t MSG_RAM_RX_FIFO1_OFFSET = {0x188U};
+constexpr uint32_t MSG_RAM_TX_BUFFER_OFFSET = {0x278U};
+constexpr uint32_t MSG_RAM_ELEMENT_SIZE = {18U * 4U};
+constexpr uint32_t MSG_RAM_HEADER_WORDS = {2U};
+constexpr uint32_t MSG_RAM_DATA_WORDS = {fdcan_frame::MAX_FRAME_SIZE / 4U};
+
+// Element header fields
+constexpr uint32_t ELEMENT_STID_POS = {18U};
+constexpr uint32_t ELEMENT_DLC_POS = {16U};
+constexpr uint32_t ELEMENT_DLC_MSK = {0xFU << ELEMENT_DLC_POS};
+constexpr uint32_t ELEMENT_BRS = {1U << 20U};
+constexpr uint32_t ELEMENT_FDF = {1U << 21U};
+
+constexpr uint32_t CAN_TX_ID = {(CAN_BROADCAST_ID + 1U) + (CAN_NODE_ID << 1U) + 1U};
+
+/**
+ * Data of a CAN-FD frame as 32 bit words (message RAM only supports word access)
+ */
+union FrameData {
+  uint32_t words[MSG_RAM_DATA_WORDS];
+  uint8_t bytes[fdcan_frame::MAX_FRAME_SIZE];
+};
+
+// Private Variables --------------------------------------------------------------------------------------------------
+
+// Received frame and index of the next message to hand over to the bootloader
+static FrameData rx_frame;
+static uint32_t rx_num_slots = {0U};
+static uint32_t rx_slot_idx = {0U};
+static uint32_t rx_stream_blocks = {0U};
+static bool rx_broadcast = {false};
+
+// Frame collecting the responses to the current received frame
+static FrameData tx_frame;
+static uint32_t tx_num_slots = {0U};
+
+// Loops waiting for a free TX FIFO element (derived from the system clock)
+static uint32_t tx_timeout_cnt = {device::SYS_TICK / 100U};
+
+// Diagnostic counters (read via debugger)
+static volatile uint32_t rx_frame_cnt = {0U};
+static volatile uint32_t rx_msg_lost_cnt = {0U};
+static volatile uint32_t rx_slot_drop_cnt = {0U};
+static volatile uint32_t tx_frame_cnt = {0U};
+static volatile uint32_t tx_drop_cnt = {0U};
+
+// Private Functions --------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Calculates nominal and data bit timing for the kernel clock
+ *
+ * @return false if a bit rate is not reachable exactly
+ */
+static constexpr bool calcBitTiming(const uint32_t clock_hz, ext::CanBitTiming& nominal, ext::CanBitTiming& data) {
+  return ext::calcCanBitTiming(clock_hz, CAN_NOMINAL_BIT_RATE, CAN_NOMINAL_SAMPLE_POINT, 512U, 256U, 128U, nominal) &&
+         ext::calcCanBitTiming(clock_hz, CAN_DATA_BIT_RATE, CAN_DATA_SAMPLE_POINT, 32U, 32U, 16U, data);
+}
+
+static constexpr bool isClockValid(const uint32_t clock_hz) {
+  ext::CanBitTiming nominal = {};
+  ext::CanBitTiming data = {};
+  return calcBitTiming(clock_hz, nominal, data);
+}
+static_assert(isClockValid(device::SYS_TICK) && isClockValid(device::SYS_TICK_BOOST),
+              "CAN bit rates not reachable with the system clock");
+
+/**
+ * @brief Reads oldest frame of the RX FIFO into rx_frame and releases the FIFO element
+ *
+ * @param broadcast FIFO receives the broadcast ID (requests only, never raw blocks of a page stream)
+ * @return true if a frame was read
+ */
+static bool readRxFIFO(const uint32_t fifo_status, volatile uint32_t* fifo_ack, const uint32_t fifo_offset,
+                       const bool broadcast) {
+  // Check fill level (same position for both FIFOs)
+  if ((fifo_status & FDCAN_RXF0S_F0FL_Msk) == 0U) {
+    return false;
+  }
+
+  const uint32_t get_idx = (fifo_status & FDCAN_RXF0S_F0GI_Msk) >> FDCAN_RXF0S_F0GI_Pos;
+  const volatile uint32_t* element =
+      (const volatile uint32_t*)(SRAMCAN_BASE + fifo_offset + get_idx * MSG_RAM_ELEMENT_SIZE);
+
+  const uint32_t length = fdcan_frame::dlcToLength((element[1U] & ELEMENT_DLC_MSK) >> ELEMENT_DLC_POS);
+  for (uint32_t idx = 0U; idx < ((length + 3U) / 4U); idx++) {
+    rx_frame.words[idx] = element[MSG_RAM_HEADER_WORDS + idx];
+  }
+
+  *fifo_ack = get_idx;
+
+  // Raw data blocks of a page stream may start with zero bytes, so only the length counts
+  if ((rx_stream_blocks > 0U) && !broadcast) {
+    rx_num_slots = fdcan_frame::countStreamSlots(length, rx_stream_blocks);
+  } else {
+    rx_num_slots = fdcan_frame::countMsgSlots(rx_frame.bytes, length);
+  }
+  rx_slot_idx = 0U;
+  rx_broadcast = broadcast;
+  rx_frame_cnt = rx_frame_cnt + 1U;
+
+  return true;
+}
+
+/**
+ * @brief Transmits collected responses as one frame via the TX FIFO
+ *
+ * Waits for a free TX FIFO element at most tx_timeout_cnt loops (bus without acknowledging node),
+ * afterwards the responses are dropped.
+ */
+static void sendTxFrame(void) {
+  if (tx_num_slots == 0U) {
+    return;
+  }
+
+  const uint32_t length = tx_num_slots * fdcan_frame::SLOT_SIZE;
+  const uint32_t dlc = fdcan_frame::padFrame(tx_frame.bytes, length);
+  tx_num_slots = 0U;
+
+  uint32_t timeout_cnt = 0U;
+  while ((FDCAN1->TXFQS & FDCAN_TXFQS_TFQF) == FDCAN_TXFQS_TFQF) {
+    timeout_cnt++;
+    if (timeout_cnt >= tx_timeout_cnt) {
+      tx_drop_cnt = tx_drop_cnt + 1U;
+      return;
+    }
+  }
+
+  const uint32_t put_idx = (FDCAN1->TXFQS & FDCAN_TXFQS_TFQPI_Msk) >> FDCAN_TXFQS_TFQPI_Pos;
+  volatile uint32_t* element = (volatile uint32_t*)(SRAMCAN_BASE + MSG_RAM_TX_BUFFER_OFFSET +
+                                                    put_idx * MSG_RAM_ELEMENT_SIZE);
+
+  element[0U] = (CAN_TX_ID << ELEMENT_STID_POS);
+  element[1U] = (dlc << ELEMENT_DLC_POS) | ELEMENT_BRS | ELEMENT_FDF;
+  for (uint32_t idx = 0U; idx < ((fdcan_frame::dlcToLength(dlc) + 3U) / 4U); idx++) {
+    element[MSG_RAM_HEADER_WORDS + idx] = tx_frame.words[idx];
+  }
+
+  FDCAN1->TXBAR = (1U << put_idx);
+  tx_frame_cnt = tx_frame_cnt + 1U;
+}
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+void transport::init(void) {
+  rx_num_slots = 0U;
+  rx_slot_idx = 0U;
+  tx_num_slots = 0U;
+}
+
+void transport::deinit(void) {
+  // Abort pending transmissions and stop taking part in bus communication
+  SET_BIT(FDCAN1->CCCR, FDCAN_CCCR_INIT);
+  while ((FDCAN1->CCCR & FDCAN_CCCR_INIT) != FDCAN_CCCR_INIT) {
+    __NOP();
+  }
+}
+
+void transport::flush(void) {
+  sendTxFrame();
+
+  uint32_t timeout_cnt = 0U;
+  while ((FDCAN1->TXBRP != 0U) && (timeout_cnt < tx_timeout_cnt)) {
+    timeout_cnt++;
+  }
+}
+
+bool transport::receive(uint8_t* buffer, bool& broadcast) {
+  // Count and clear lost frames (RX FIFO full)
+  const uint32_t lost_flags = FDCAN1->IR & (FDCAN_IR_RF0L | FDCAN_IR_RF1L);
+  if (lost_flags != 0U) {
+    FDCAN1->IR = lost_flags;
+    rx_msg_lost_cnt = rx_msg_lost_cnt + 1U;
+  }
+
+  // Fetch next frame if all messages of the current one are handled. Node messages are
+  // stored in FIFO 0, broadcast messages in FIFO 1.
+  if (rx_slot_idx >= rx_num_slots) {
+    if (!readRxFIFO(FDCAN1->RXF0S, &FDCAN1->RXF0A, MSG_RAM_RX_FIFO0_OFFSET, false) &&
+        !readRxFIFO(FDCAN1->RXF1S, &FDCAN1->RXF1A, MSG_RAM_RX_FIFO1_OFFSET, true)) {
+      return false;
+    }
+  }
+
+  if (rx_slot_idx < rx_num_slots) {
+    const uint8_t* slot = &rx_frame.bytes[rx_slot_idx * fdcan_frame::SLOT_SIZE];
+    for (uint32_t idx = 0U; idx < fdcan_frame::SLOT_SIZE; idx++) {
+      buffer[idx] = slot[idx];
+    }
+    rx_slot_idx++;
+    broadcast = rx_broadcast;
+    return true;
+  }
+
+  return false;
+}
+
+void transport::suspend(void) {
+  // Bit timing is invalid while the kernel clock changes: without initialization mode the node would
+  // sample the bus with a wrong bit rate and destroy frames of other nodes with error frames
+  SET_BIT(FDCAN1->CCCR, FDCAN_CCCR_INIT);
+  while ((FDCAN1->CCCR & FDCAN_CCCR_INIT) != FDCAN_CCCR_INIT) {
+    __NOP();
+  }
+}
+
+void transport::setClock(uint32_t clock_hz) {
+  tx_timeout_cnt = clock_hz / 100U;
+
+  ext::CanBitTiming nominal = {};
+  ext::CanBitTiming data = {};
+  calcBitTiming(clock_hz, nominal, data);
+
+  // Configuration change resets the message RAM FIFOs, frames received in the meantime are lost. Usually
+  // already in initialization mode (suspend()), left after the new bit timing is set.
+  SET_BIT(FDCAN1->CCCR, FDCAN_CCCR_INIT);
+  while ((FDCAN1->CCCR & FDCAN_CCCR_INIT) != FDCAN_CCCR_INIT) {
+    __NOP();
+  }
+  SET_BIT(FDCAN1->CCCR, FDCAN_CCCR_CCE);
+
+  FDCAN1->NBTP = ((nominal.tseg2 - 1U) << FDCAN_NBTP_NSJW_Pos) | ((nominal.prescaler - 1U) << FDCAN_NBTP_NBRP_Pos) |
+                 ((nominal.tseg1 - 1U) << FDCAN_NBTP_NTSEG1_Pos) | ((nominal.tseg2 - 1U) << FDCAN_NBTP_NTSEG2_Pos);
+  FDCAN1->DBTP = FDCAN_DBTP_TDC | ((data.prescaler - 1U) << FDCAN_DBTP_DBRP_Pos) |
+                 ((data.tseg1 - 1U) << FDCAN_DBTP_DTSEG1_Pos) | ((data.tseg2 - 1U) << FDCAN_DBTP_DTSEG2_Pos) |
+                 ((data.tseg2 - 1U) << FDCAN_DBTP_DSJW_Pos);
+  FDCAN1->TDCR = ((data.prescaler * data.tseg1) << FDCAN_TDCR_TDCO_Pos);
+
+  CLEAR_BIT(FDCAN1->CCCR, FDCAN_CCCR_INIT);
+  while ((FDCAN1->CCCR & FDCAN_CCCR_INIT) == FDCAN_CCCR_INIT) {
+    __NOP();
+  }
+}
+
+void transport::setStreamMode(uint32_t num_blocks) {
+  // Slots following the last block or request of the previous mode are not handed over
+  if ((num_blocks > 0U) != (rx_stream_blocks > 0U)) {
+    if (rx_slot_idx < rx_num_slots) {
+      rx_slot_drop_cnt = rx_slot_drop_cnt + (rx_num_slots - rx_slot_idx);
+      rx_num_slots = rx_slot_idx;
+    }
+
+    // Responses to the handled messages of the frame are complete
+    sendTxFrame();
+  }
+
+  rx_stream_blocks = num_blocks;
+}
+
+bool transport::processRequest(const msg::Msg& request, msg::Msg& response) {
+  // Bit rates are fixed by the bus configuration
+  (void)request;
+  (void)response;
+  return false;
+}
+
+void transport::transmit(const msg::Msg& response) {
+  encodeMsg(response, &tx_frame.bytes[tx_num_slots * fdcan_frame::SLOT_SIZE]);
+  tx_num_slots++;
+
+  // Send responses as soon as all requests of the received frame are handled
+  if ((rx_slot_idx >= rx_num_slots) || (tx_num_slots >= fdcan_frame::MAX_SLOTS)) {
+    sendTxFrame();
+  }
+}
@@ -0,0 +1,420 @@
+/**
+ * @file transport_uart.cpp
+ * @author agent (agent@local)
+ * @brief LPUART1 transport with DMA reception ring buffer, DMA transmit queue, baud rate switching and framed mode
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <algorithm>
+#include <array>
+
+#include "baud_switch.h"
+#include "bootloader_api.h"
+#include "device_defines.h"
+#include "dma_rx_ring.h"
+#include "ext_config.h"
+#include "frame_codec.h"
+#include "frame_sync.h"
+#include "isr_queue.h"
+#include "stm32g4xx.h"
+#include "transport.h"
+
+using namespace franklyboot;
+using transport::MSG_SIZE;
+
+// Defines ------------------------------------------------------------------------------------------------------------
+
+// Serial RX ring buffer filled by DMA in circular mode (size must be a power of two)
+constexpr uint32_t RX_RING_SIZE = {512U};
+constexpr uint32_t RX_DMA_REQ_LPUART1_RX = {34U};
+
+// Serial TX queue of encoded responses sent by DMA (size must be a power of two)
+constexpr uint32_t TX_QUEUE_SIZE = {8U};
+constexpr uint32_t TX_DMA_REQ_LPUART1_TX = {35U};
+
+// Messages are wrapped into frames with sync marker, length and CRC-8 in framed mode
+using SerialFrameCodec = ext::FrameCodec<MSG_SIZE>;
+
+/**
+ * Encoded response in the TX queue
+ */
+struct SerialTxFrame {
+  std::array<uint8_t, SerialFrameCodec::FRAME_SIZE> data;
+  uint32_t len;  //!< Number of bytes to transmit
+};
+
+// LPUART has no receiver timeout, messages are delimited by the idle line detection (1 character)
+constexpr uint32_t RX_FRAME_NUM_GAPS = {16U};
+
+// LPUART1 runs on PCLK1 = system clock, baud rate = 256 * system clock / BRR
+using SerialBaudSwitch = ext::BaudSwitch<256U, 0x300U, 0xFFFFFU>;
+static_assert(SerialBaudSwitch::calcBRR(device::SYS_TICK, ext::DEFAULT_BAUD) != 0U, "Default baud rate not reachable");
+
+// LPUART has no auto-baud detection. EXTI3 timestamps the edges of the sync byte 0x55 on PA3 (RX) instead,
+// measured with SerialBaudSwitch::measureSyncBRR(). The EXTI ISR limits the sync byte to ~230400 baud.
+constexpr uint32_t AUTOBAUD_NUM_EDGES = {ext::SYNC_NUM_EDGES};
+
+// Private Variables --------------------------------------------------------------------------------------------------
+
+// RX ring buffer written by DMA, published by the ISRs (DMA half/full transfer and UART idle line)
+static ext::DmaRxRing<RX_RING_SIZE> rx_ring;
+
+// Message reassembly state of receive()
+static std::array<std::uint8_t, MSG_SIZE> rx_msg_buffer;
+static uint32_t rx_msg_buffer_idx = {0U};
+
+// RX diagnostic counters (read via debugger)
+static volatile uint32_t rx_uart_error_cnt = {0U};
+
+// Gaps of the serial line detected by the idle line detection
+static ext::FrameSync<RX_FRAME_NUM_GAPS> frame_sync;
+
+// TX queue read by DMA. Pushed by the main loop, popped by the DMA ISR when the frame is transmitted.
+static ext::IsrQueue<SerialTxFrame, TX_QUEUE_SIZE> tx_queue;
+static volatile bool tx_dma_busy = {false};
+
+static SerialBaudSwitch baud_switch(device::SYS_TICK);
+static SerialFrameCodec frame_codec;
+static bool rx_framed = {false};  // Mode of the decoder, follows frame_codec.isEnabled()
+
+// Edge timestamps of the sync byte written by the EXTI ISR, evaluated by the main loop. Auto-baud is
+// armed until the first message is received or the sync byte is measured.
+static volatile uint32_t autobaud_edge_cycles[AUTOBAUD_NUM_EDGES];
+static volatile uint32_t autobaud_edge_cnt = {0U};
+static bool autobaud_armed = {false};
+
+// Private Functions --------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Setup DMA channel to receive the serial line continuously into the RX ring buffer
+ */
+static void initRxDMA(void) {
+  // Route LPUART1 RX request to DMA1 channel 1
+  DMAMUX1_Channel0->CCR = (RX_DMA_REQ_LPUART1_RX << DMAMUX_CxCR_DMAREQ_ID_Pos);
+
+  // Setup circular peripheral to memory transfer with half and full transfer interrupt
+  DMA1_Channel1->CPAR = (uint32_t)(&LPUART1->RDR);
+  DMA1_Channel1->CMAR = (uint32_t)(rx_ring.getBuffer());
+  DMA1_Channel1->CNDTR = RX_RING_SIZE;
+  DMA1_Channel1->CCR = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_HTIE | DMA_CCR_TCIE | DMA_CCR_EN;
+
+  // Enable DMA reception, error and idle line interrupt
+  SET_BIT(LPUART1->CR3, USART_CR3_DMAR | USART_CR3_EIE);
+  SET_BIT(LPUART1->CR1, USART_CR1_IDLEIE);
+
+  NVIC_SetPriority(DMA1_Channel1_IRQn, 1);
+  NVIC_SetPriority(LPUART1_IRQn, 1);
+  NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+  NVIC_EnableIRQ(LPUART1_IRQn);
+}
+
+/**
+ * @brief Setup DMA channel to transmit responses from the TX queue
+ */
+static void initTxDMA(void) {
+  // Route LPUART1 TX request to DMA1 channel 2
+  DMAMUX1_Channel1->CCR = (TX_DMA_REQ_LPUART1_TX << DMAMUX_CxCR_DMAREQ_ID_Pos);
+
+  DMA1_Channel2->CPAR = (uint32_t)(&LPUART1->TDR);
+  SET_BIT(LPUART1->CR3, USART_CR3_DMAT);
+
+  NVIC_SetPriority(DMA1_Channel2_IRQn, 1);
+  NVIC_EnableIRQ(DMA1_Channel2_IRQn);
+}
+
+/**
+ * @brief Set baud rate (aborts the reception of the current byte)
+ */
+static void setBaudRate(const uint32_t brr) {
+  CLEAR_BIT(LPUART1->CR1, USART_CR1_UE);
+  LPUART1->BRR = brr;
+  SET_BIT(LPUART1->CR1, USART_CR1_UE);
+}
+
+/**
+ * @brief Arm EXTI3 to timestamp the edges of the next sync byte, starting with the falling start bit edge
+ */
+static void autoBaudStart(void) {
+  CLEAR_BIT(EXTI->IMR1, EXTI_IMR1_IM3);
+  autobaud_edge_cnt = 0U;
+  CLEAR_BIT(EXTI->RTSR1, EXTI_RTSR1_RT3);
+  SET_BIT(EXTI->FTSR1, EXTI_FTSR1_FT3);
+  EXTI->PR1 = EXTI_PR1_PIF3;
+  SET_BIT(EXTI->IMR1, EXTI_IMR1_IM3);
+  autobaud_armed = true;
+}
+
+/**
+ * @brief Disarm auto-baud detection
+ */
+static void autoBaudStop(void) {
+  CLEAR_BIT(EXTI->IMR1, EXTI_IMR1_IM3);
+  autobaud_armed = false;
+}
+
+/**
+ * @brief Returns true and drops all pending bytes if the DMA has overwritten unread data
+ */
+static bool rxRingCheckOverrun(void) {
+  if (rx_ring.checkOverrun()) {
+    frame_sync.reset();
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * @brief Drops all received data and restarts message reassembly
+ */
+static void rxRingDrop(void) {
+  NVIC_DisableIRQ(DMA1_Channel1_IRQn);
+  NVIC_DisableIRQ(LPUART1_IRQn);
+  rx_ring.drop(DMA1_Channel1->CNDTR);
+  frame_sync.reset();
+  NVIC_EnableIRQ(LPUART1_IRQn);
+  NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+
+  rx_msg_buffer_idx = 0U;
+  frame_codec.resetDecoder();
+}
+
+/**
+ * @brief Evaluates auto-baud detection and applies baud rate changes of the baud rate switch
+ */
+static void pollBaudRate(void) {
+  if (autobaud_armed && (autobaud_edge_cnt >= AUTOBAUD_NUM_EDGES)) {
+    const uint32_t brr = SerialBaudSwitch::measureSyncBRR(autobaud_edge_cycles);
+    if ((brr != 0U) && baud_switch.setBaseBRR(brr)) {
+      // Data received until now used the wrong baud rate
+      setBaudRate(brr);
+      rxRingDrop();
+      autoBaudStop();
+    } else {
+      autoBaudStart();
+    }
+  }
+
+  uint32_t brr = 0U;
+  switch (baud_switch.poll(DWT->CYCCNT, rx_uart_error_cnt, brr)) {
+    case SerialBaudSwitch::LINK_SET_BRR:
+      transport::flush();
+      setBaudRate(brr);
+      rxRingDrop();
+      break;
+
+    case SerialBaudSwitch::LINK_RESTART:
+      setBaudRate(brr);
+      rxRingDrop();
+      frame_codec.disable();
+      autoBaudStart();
+      break;
+
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Start DMA transfer of the oldest queued response if the DMA is idle
+ *
+ * Must be called from the TX DMA ISR or with the TX DMA interrupt disabled.
+ */
+static void txQueueStartDMA(void) {
+  if (!tx_dma_busy && !tx_queue.isEmpty()) {
+    const SerialTxFrame& frame = tx_queue.front();
+    DMA1_Channel2->CCR = 0U;
+    DMA1_Channel2->CMAR = (uint32_t)(frame.data.data());
+    DMA1_Channel2->CNDTR = frame.len;
+    __DMB();
+    DMA1_Channel2->CCR = DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_TCIE | DMA_CCR_EN;
+    tx_dma_busy = true;
+  }
+}
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+void transport::init(void) {
+  // Start with the default baud rate and wait for a sync byte
+  LPUART1->BRR = baud_switch.getBRR();
+  LPUART1->CR1 = USART_CR1_TE | USART_CR1_RE | USART_CR1_UE;
+
+  initRxDMA();
+  initTxDMA();
+
+  NVIC_SetPriority(EXTI3_IRQn, 0);
+  NVIC_EnableIRQ(EXTI3_IRQn);
+  autoBaudStart();
+}
+
+void transport::deinit(void) {
+  autoBaudStop();
+  NVIC_DisableIRQ(EXTI3_IRQn);
+  NVIC_DisableIRQ(DMA1_Channel2_IRQn);
+  NVIC_DisableIRQ(DMA1_Channel1_IRQn);
+  NVIC_DisableIRQ(LPUART1_IRQn);
+
+  CLEAR_BIT(LPUART1->CR1, USART_CR1_IDLEIE);
+  CLEAR_BIT(LPUART1->CR3, USART_CR3_DMAR | USART_CR3_DMAT | USART_CR3_EIE);
+  DMA1_Channel1->CCR = 0U;
+  DMA1_Channel2->CCR = 0U;
+
+  NVIC_ClearPendingIRQ(DMA1_Channel2_IRQn);
+  NVIC_ClearPendingIRQ(DMA1_Channel1_IRQn);
+  NVIC_ClearPendingIRQ(LPUART1_IRQn);
+  NVIC_ClearPendingIRQ(EXTI3_IRQn);
+}
+
+void transport::flush(void) {
+  while (!tx_queue.isEmpty()) {
+    __NOP();
+  }
+
+  while ((LPUART1->ISR & USART_ISR_TC) != USART_ISR_TC) {
+    __NOP();
+  }
+}
+
+bool transport::receive(uint8_t* buffer, bool& broadcast) {
+  broadcast = false;
+  pollBaudRate();
+
+  // Restart message if received data was lost
+  if (rxRingCheckOverrun()) {
+    rx_msg_buffer_idx = 0U;
+    frame_codec.resetDecoder();
+  }
+
+  // Restart message if the mode changed with the last response
+  if (rx_framed != frame_codec.isEnabled()) {
+    rx_framed = frame_codec.isEnabled();
+    rx_msg_buffer_idx = 0U;
+    frame_codec.resetDecoder();
+  }
+
+  // Restart message if the line was idle after an incomplete message
+  if (frame_sync.checkGap(rx_ring.getTail(), rx_msg_buffer_idx)) {
+    rx_msg_buffer_idx = 0U;
+  }
+
+  uint8_t rx_byte;
+  if (rx_ring.pop(rx_byte)) {
+    bool complete = false;
+    if (ext::EXT_FRAME_MODE && rx_framed) {
+      complete = frame_codec.decode(rx_byte, rx_msg_buffer.data());
+    } else {
+      rx_msg_buffer[rx_msg_buffer_idx] = rx_byte;
+      rx_msg_buffer_idx++;
+      complete = (rx_msg_buffer_idx >= rx_msg_buffer.size());
+    }
+
+    if (complete) {
+      rx_msg_buffer_idx = 0U;
+      std::copy(rx_msg_buffer.begin(), rx_msg_buffer.end(), buffer);
+
+      // Host uses the current baud rate without sync byte
+      if (autobaud_armed) {
+        autoBaudStop();
+      }
+      baud_switch.onMessage(rx_uart_error_cnt);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void transport::suspend(void) {
+  // Baud rate is invalid while the kernel clock changes, setBaudRate() enables the UART again
+  CLEAR_BIT(LPUART1->CR1, USART_CR1_UE);
+}
+
+void transport::setClock(uint32_t clock_hz) {
+  setBaudRate(baud_switch.setClock(clock_hz, clock_hz));
+}
+
+void transport::setStreamMode(uint32_t num_blocks) {
+  // Serial line is a byte stream, raw blocks are received like messages
+  (void)num_blocks;
+}
+
+void transport::transmit(const msg::Msg& response) {
+  // Wait for free slot in TX queue
+  while (tx_queue.isFull()) {
+    __NOP();
+  }
+
+  /* Encode message (framed in framed mode) */
+  std::array<uint8_t, MSG_SIZE> buffer;
+  encodeMsg(response, buffer.data());
+
+  SerialTxFrame& frame = tx_queue.back();
+  frame.len = frame_codec.encode(buffer.data(), frame.data.data());
+
+  /* Transmit message */
+  tx_queue.push();
+
+  NVIC_DisableIRQ(DMA1_Channel2_IRQn);
+  txQueueStartDMA();
+  NVIC_EnableIRQ(DMA1_Channel2_IRQn);
+}
+
+extern "C" void FRANKLYBOOT_serialRxISR(void) {
+  // Clear UART idle line and error flags
+  const uint32_t uart_isr = LPUART1->ISR;
+  if ((uart_isr & (USART_ISR_ORE | USART_ISR_FE | USART_ISR_NE)) != 0U) {
+    rx_uart_error_cnt++;
+  }
+  LPUART1->ICR = USART_ICR_IDLECF | USART_ICR_ORECF | USART_ICR_FECF | USART_ICR_NECF;
+
+  // Clear DMA flags
+  DMA1->IFCR = DMA_IFCR_CGIF1;
+
+  // Publish bytes written by DMA since last call
+  rx_ring.publish(DMA1_Channel1->CNDTR);
+
+  // Line is idle after the received data
+  if ((uart_isr & USART_ISR_IDLE) != 0U) {
+    frame_sync.markGap(rx_ring.getHead());
+  }
+}
+
+bool transport::processRequest(const msg::Msg& request, msg::Msg& response) {
+  return (ext::EXT_BAUD_SWITCH && baud_switch.processRequest(request, response)) ||
+         (ext::EXT_FRAME_MODE && frame_codec.processRequest(request, response));
+}
+
+extern "C" void FRANKLYBOOT_serialEdgeISR(void) {
+  const uint32_t cycles = DWT->CYCCNT;
+  EXTI->PR1 = EXTI_PR1_PIF3;
+
+  const uint32_t edge_idx = autobaud_edge_cnt;
+  if (edge_idx < AUTOBAUD_NUM_EDGES) {
+    autobaud_edge_cycles[edge_idx] = cycles;
+    autobaud_edge_cnt = edge_idx + 1U;
+  }
+
+  if (edge_idx == 0U) {
+    // Following edges alternate, detect both
+    SET_BIT(EXTI->RTSR1, EXTI_RTSR1_RT3);
+  } else if ((edge_idx + 1U) >= AUTOBAUD_NUM_EDGES) {
+    // Sync byte complete, evaluated by the main loop
+    CLEAR_BIT(EXTI->IMR1, EXTI_IMR1_IM3);
+  }
+}
+
+extern "C" void FRANKLYBOOT_serialTxISR(void) {
+  // Clear DMA flags and release transmitted queue slot
+  DMA1->IFCR = DMA_IFCR_CGIF2;
+  DMA1_Channel2->CCR = 0U;
+  tx_queue.pop();
+  tx_dma_busy = false;
+
+  // Continue with next queued response
+  txQueueStartDMA();
+}
@@ -0,0 +1,316 @@
+/**
+ * @file baud_switch.h
+ * @author agent (agent@local)
+ * @brief Auto-baud base rate and negotiated switch to a higher baud rate of the serial transport
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * The serial line starts at DEFAULT_BAUD. A host may send BAUD_SYNC_BYTE (0x55) before its first request,
+ * followed by at least 1 ms idle line. The board measures the sync byte and sets the measured rate as base
+ * rate. The data received until then is dropped.
+ *
+ * Switch to one of BAUD_RATES (all values of data LE):
+ *
+ *  1. Host sends REQ_EXT_BAUD_SWITCH with the baud rate at the current rate. The board answers RES_OK
+ *     (data: baud rate) and switches after the response is transmitted. Unsupported rates are answered
+ *     with RES_ERR (data: highest supported rate).
+ *  2. Host switches and sends the same request again at the new rate within CONFIRM_TIMEOUT_MS.
+ *     The board answers RES_OK and keeps the rate. Without confirmation the board returns to the
+ *     previous rate.
+ *  3. LINK_ERROR_LIMIT framing or noise errors without an error free message in between are taken as
+ *     link failure. The board returns to the base rate and waits for a new sync byte.
+ *
+ * The BRR values are computed from the kernel clock, which changes with the clock profile of the board
+ * (see setClock()). Rates which are not reachable within 2 % with the kernel clock are not offered.
+ *
+ * The class has no device dependencies, the UART is configured by the board.
+ */
+
+#ifndef BAUD_SWITCH_H_
+#define BAUD_SWITCH_H_
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <francor/franklyboot/msg.h>
+#include <stdint.h>
+
+#include <array>
+
+#include "ext_msg.h"
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+namespace ext {
+
+constexpr uint8_t BAUD_SYNC_BYTE = {0x55U};
+constexpr uint32_t DEFAULT_BAUD = {115200U};
+
+// The start bit and the alternating data bits of the sync byte give 10 edges from the falling start bit edge
+// to the rising stop bit edge, which are 9 bit times apart
+constexpr uint32_t SYNC_NUM_EDGES = {10U};
+constexpr uint32_t SYNC_NUM_BITS = {SYNC_NUM_EDGES - 1U};
+
+/**
+ * Baud rates offered for the negotiated switch
+ */
+constexpr std::array<uint32_t, 6U> BAUD_RATES = {115200U, 230400U, 460800U, 921600U, 1000000U, 2000000U};
+
+/**
+ * @brief Baud rate switch with confirmation and fallback
+ *
+ * @tparam BRR_SCALE  Baud rate = CLK_HZ * BRR_SCALE / BRR (256: LPUART, 1: USART with 16 times oversampling)
+ * @tparam BRR_MIN    Smallest valid BRR value
+ * @tparam BRR_MAX    Largest valid BRR value
+ */
+template <uint32_t BRR_SCALE, uint32_t BRR_MIN, uint32_t BRR_MAX>
+class BaudSwitch {
+ public:
+  static constexpr uint32_t CONFIRM_TIMEOUT_MS = {100U};
+  static constexpr uint32_t LINK_ERROR_LIMIT = {8U};
+
+  /**
+   * @brief Returns BRR value of the baud rate (0 if the rate is not reachable within 2 %)
+   */
+  static constexpr uint32_t calcBRR(const uint32_t clk_hz, const uint32_t baud) {
+    const uint64_t clk = static_cast<uint64_t>(clk_hz) * BRR_SCALE;
+    const uint64_t brr = (clk + baud / 2U) / baud;
+    if ((brr < BRR_MIN) || (brr > BRR_MAX)) {
+      return 0U;
+    }
+
+    const uint64_t actual_baud = clk / brr;
+    const uint64_t deviation = (actual_baud > baud) ? (actual_baud - baud) : (baud - actual_baud);
+    return ((deviation * 50U) <= baud) ? static_cast<uint32_t>(brr) : 0U;
+  }
+
+  /**
+   * @brief Returns BRR value measured from the edge timestamps of the sync byte
+   *
+   * @param edge_cycles SYNC_NUM_EDGES timestamps of a counter running with the kernel clock (may wrap around)
+   * @return BRR value, 0 if an edge is more than a quarter bit time off its expected position
+   */
+  static uint32_t measureSyncBRR(const volatile uint32_t* edge_cycles) {
+    const uint64_t total_cycles = edge_cycles[SYNC_NUM_BITS] - edge_cycles[0U];
+    const uint64_t tolerance = total_cycles / (SYNC_NUM_BITS * 4U);
+
+    for (uint32_t idx = 1U; idx < SYNC_NUM_BITS; idx++) {
+      const uint64_t cycles = edge_cycles[idx] - edge_cycles[0U];
+      const uint64_t expected = (total_cycles * idx) / SYNC_NUM_BITS;
+      const uint64_t deviation = (cycles > expected) ? (cycles - expected) : (expected - cycles);
+      if (deviation > tolerance) {
+        return 0U;
+      }
+    }
+
+    // BRR = BRR_SCALE * kernel clock / baud = BRR_SCALE * cycles per bit
+    return static_cast<uint32_t>((total_cycles * BRR_SCALE + SYNC_NUM_BITS / 2U) / SYNC_NUM_BITS);
+  }
+
+  /**
+   * Action the board has to execute after poll()
+   */
+  enum LinkAction : uint8_t {
+    LINK_KEEP = 0U,     //!< Nothing to do
+    LINK_SET_BRR = 1U,  //!< Transmit queued responses and set BRR
+    LINK_RESTART = 2U,  //!< Set BRR of the base rate, drop received data and wait for a new sync byte
+  };
+
+  /**
+   * @brief Starts with DEFAULT_BAUD
+   *
+   * @param clk_hz Kernel clock of the UART in Hz (also clock of the cycle counter)
+   */
+  explicit constexpr BaudSwitch(const uint32_t clk_hz)
+      : _clk_hz(clk_hz),
+        _cycles_per_ms(clk_hz / 1000U),
+        _base_brr(calcBRR(clk_hz, DEFAULT_BAUD)),
+        _brr(_base_brr),
+        _fallback_brr(_base_brr) {}
+
+  /**
+   * @brief Processes extension request to switch the baud rate
+   *
+   * @return true if the request was a baud switch request and the response is set
+   */
+  bool processRequest(const franklyboot::msg::Msg& request, franklyboot::msg::Msg& response) {
+    if (!isRequest(request, REQ_EXT_BAUD_SWITCH)) {
+      return false;
+    }
+
+    const uint32_t baud = getDataWord(request);
+
+    // Second request at the new rate confirms the switch
+    if ((_state == STATE_CONFIRM) && !_apply_brr && (baud == _switch_baud)) {
+      _state = STATE_ACTIVE;
+      _num_switches++;
+      response = createResponse(REQ_EXT_BAUD_SWITCH, franklyboot::msg::RES_OK, request.packet_id, baud);
+      return true;
+    }
+
+    const uint32_t brr = lookupBRR(baud);
+    if (brr == 0U) {
+      response = createResponse(REQ_EXT_BAUD_SWITCH, franklyboot::msg::RES_ERR, request.packet_id, getMaxBaud());
+      return true;
+    }
+
+    // Previous rate is kept as fallback until the switch is confirmed
+    if (_state != STATE_CONFIRM) {
+      _fallback_brr = _brr;
+    }
+    _brr = brr;
+    _switch_baud = baud;
+    _apply_brr = true;
+    _state = STATE_CONFIRM;
+
+    response = createResponse(REQ_EXT_BAUD_SWITCH, franklyboot::msg::RES_OK, request.packet_id, baud);
+    return true;
+  }
+
+  /**
+   * @brief Sets base rate measured by auto-baud detection
+   *
+   * @return false if the BRR value is not valid (base rate is kept)
+   */
+  bool setBaseBRR(const uint32_t brr) {
+    if ((brr < BRR_MIN) || (brr > BRR_MAX)) {
+      _num_autobaud_errors++;
+      return false;
+    }
+
+    _base_brr = brr;
+    _brr = brr;
+    _apply_brr = false;
+    _state = STATE_BASE;
+    return true;
+  }
+
+  /**
+   * @brief Returns BRR value of the current baud rate
+   */
+  uint32_t getBRR() const { return _brr; }
+
+  /**
+   * @brief Rescales all baud rates to a new kernel clock
+   *
+   * @param clk_hz     Kernel clock of the UART in Hz
+   * @param cpu_clk_hz Clock of the cycle counter in Hz
+   * @return BRR value of the current baud rate with the new clock
+   */
+  uint32_t setClock(const uint32_t clk_hz, const uint32_t cpu_clk_hz) {
+    _base_brr = scaleBRR(_base_brr, clk_hz);
+    _brr = scaleBRR(_brr, clk_hz);
+    _fallback_brr = scaleBRR(_fallback_brr, clk_hz);
+    _clk_hz = clk_hz;
+    _cycles_per_ms = cpu_clk_hz / 1000U;
+    return _brr;
+  }
+
+  /**
+   * @brief Tracks the link quality, called for every received message
+   *
+   * @param error_cnt Number of UART errors since startup
+   */
+  void onMessage(const uint32_t error_cnt) {
+    if (error_cnt == _msg_error_cnt) {
+      _link_error_cnt = error_cnt;
+    }
+    _msg_error_cnt = error_cnt;
+  }
+
+  /**
+   * @brief Checks timeouts and link failures, called while waiting for messages
+   *
+   * @param cycles     CPU cycle counter
+   * @param error_cnt  Number of UART errors since startup
+   * @param brr        Receives BRR value to set if the action is not LINK_KEEP
+   */
+  LinkAction poll(const uint32_t cycles, const uint32_t error_cnt, uint32_t& brr) {
+    if (_apply_brr) {
+      _apply_brr = false;
+      _switch_cycles = cycles;
+      _link_error_cnt = error_cnt;
+      _msg_error_cnt = error_cnt;
+      brr = _brr;
+      return LINK_SET_BRR;
+    }
+
+    if ((_state == STATE_CONFIRM) && ((cycles - _switch_cycles) >= (_cycles_per_ms * CONFIRM_TIMEOUT_MS))) {
+      // Host has not confirmed the new rate, return to the previous rate
+      _num_fallbacks++;
+      _brr = _fallback_brr;
+      _state = (_brr == _base_brr) ? STATE_BASE : STATE_ACTIVE;
+      _switch_cycles = cycles;
+      _link_error_cnt = error_cnt;
+      _msg_error_cnt = error_cnt;
+      brr = _brr;
+      return LINK_SET_BRR;
+    }
+
+    if ((_state != STATE_BASE) && ((error_cnt - _link_error_cnt) >= LINK_ERROR_LIMIT)) {
+      // Link failed at the switched rate, start again with the base rate and auto-baud
+      _num_link_failures++;
+      _brr = _base_brr;
+      _state = STATE_BASE;
+      _link_error_cnt = error_cnt;
+      _msg_error_cnt = error_cnt;
+      brr = _brr;
+      return LINK_RESTART;
+    }
+
+    return LINK_KEEP;
+  }
+
+ private:
+  enum State : uint8_t {
+    STATE_BASE = 0U,     //!< Base rate (default or auto-baud)
+    STATE_CONFIRM = 1U,  //!< Switched, waiting for confirmation
+    STATE_ACTIVE = 2U,   //!< Switched and confirmed
+  };
+
+  uint32_t lookupBRR(const uint32_t baud) const {
+    for (uint32_t idx = 0U; idx < BAUD_RATES.size(); idx++) {
+      if (BAUD_RATES[idx] == baud) {
+        return calcBRR(_clk_hz, baud);
+      }
+    }
+    return 0U;
+  }
+
+  uint32_t getMaxBaud() const {
+    uint32_t max_baud = DEFAULT_BAUD;
+    for (uint32_t idx = 0U; idx < BAUD_RATES.size(); idx++) {
+      if ((calcBRR(_clk_hz, BAUD_RATES[idx]) != 0U) && (BAUD_RATES[idx] > max_baud)) {
+        max_baud = BAUD_RATES[idx];
+      }
+    }
+    return max_baud;
+  }
+
+  uint32_t scaleBRR(const uint32_t brr, const uint32_t clk_hz) const {
+    return static_cast<uint32_t>((static_cast<uint64_t>(brr) * clk_hz + _clk_hz / 2U) / _clk_hz);
+  }
+
+  State _state = {STATE_BASE};
+  uint32_t _clk_hz;
+  uint32_t _cycles_per_ms;
+  uint32_t _base_brr;
+  uint32_t _brr;
+  uint32_t _fallback_brr;
+  uint32_t _switch_baud = {DEFAULT_BAUD};
+  bool _apply_brr = {false};
+
+  uint32_t _switch_cycles = {0U};
+  uint32_t _link_error_cnt = {0U};
+  uint32_t _msg_error_cnt = {0U};
+
+  // Diagnostic counters (read via debugger)
+  uint32_t _num_switches = {0U};
+  uint32_t _num_fallbacks = {0U};
+  uint32_t _num_link_failures = {0U};
+  uint32_t _num_autobaud_errors = {0U};
+};
+
+};  // namespace ext
+
+#endif /* BAUD_SWITCH_H_ */
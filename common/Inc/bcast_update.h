@@ -0,0 +1,239 @@
+/**
+ * @file bcast_update.h
+ * @author agent (agent@local)
+ * @brief Update of many identical nodes with broadcast page data and NACK bitmaps
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * All nodes take the same page data from broadcast frames, so the bus time of an update does not grow with
+ * the number of nodes. Broadcast requests are never answered directly, only the status is reported by every
+ * node in its own response slot.
+ *
+ * Protocol (broadcast requests, data LE):
+ *  1. REQ_EXT_BCAST_OPEN: data[0..1] = first page id, data[2..3] = number of pages. All pages of the range are
+ *     marked as missing.
+ *  2. For each page: REQ_EXT_BCAST_PAGE (data: page id), PAGE_SIZE / 8 data blocks of 8 bytes on the broadcast
+ *     data ID and REQ_EXT_BCAST_PAGE_END (data: CRC-32 of the page). A node writes the page if all blocks
+ *     are received and the CRC matches. Pages which are not missing anymore are ignored.
+ *  3. REQ_EXT_BCAST_STATUS: every node answers SLOT_TIME_US * slot index after the request with one response
+ *     per bitmap word (packet_id: word index, data: bitmap of missing pages, bit n = page 32 * index + n).
+ *     The result is RES_OK if no page is missing, RES_ERR otherwise (or if no update is open).
+ *  4. The host repeats step 2 for the union of the missing pages and step 3 until all nodes report RES_OK.
+ *
+ * REQ_EXT_BCAST_STATUS sent to a single node is answered immediately with the bitmap word data[0].
+ */
+
+#ifndef BCAST_UPDATE_H_
+#define BCAST_UPDATE_H_
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <francor/franklyboot/handler.h>
+#include <francor/franklyboot/msg.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ext_msg.h"
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+namespace ext {
+
+/**
+ * @brief Broadcast update state of one node
+ *
+ * @tparam FLASH_START_ADDR  Address of flash page 0
+ * @tparam APP_FIRST_PAGE    First application page
+ * @tparam FLASH_SIZE        Size of the flash in bytes
+ * @tparam PAGE_SIZE         Size of a flash page in bytes
+ */
+template <uint32_t FLASH_START_ADDR, uint32_t APP_FIRST_PAGE, uint32_t FLASH_SIZE, uint32_t PAGE_SIZE>
+class BroadcastUpdate {
+ public:
+  static constexpr uint32_t BLOCK_SIZE = {8U};
+  static constexpr uint32_t NUM_BLOCKS = {PAGE_SIZE / BLOCK_SIZE};
+  static constexpr uint32_t NUM_PAGES = {FLASH_SIZE / PAGE_SIZE};
+  static constexpr uint32_t NUM_BITMAP_WORDS = {(NUM_PAGES + 31U) / 32U};
+  static constexpr uint32_t SLOT_TIME_US = {1000U};
+
+  /**
+   * @param slot_idx    Response slot of the node
+   * @param cpu_clk_hz  Clock of the cycle counter in Hz
+   */
+  constexpr BroadcastUpdate(const uint32_t slot_idx, const uint32_t cpu_clk_hz)
+      : _slot_idx(slot_idx), _cycles_per_us(cpu_clk_hz / 1000000U) {}
+
+  /**
+   * @brief Sets the response slot of the node
+   */
+  void setSlot(const uint32_t slot_idx) { _slot_idx = slot_idx; }
+
+  /**
+   * @brief Sets the clock of the cycle counter after a system clock change
+   */
+  void setClock(const uint32_t cpu_clk_hz) { _cycles_per_us = cpu_clk_hz / 1000000U; }
+
+  /**
+   * @brief Processes broadcast request
+   *
+   * @param request Broadcast request
+   * @param cycles  CPU cycle counter at reception (start of the response slots)
+   * @return true if the request was a broadcast update request (no response is sent)
+   */
+  bool processBroadcast(const franklyboot::msg::Msg& request, const uint32_t cycles) {
+    if (isRequest(request, REQ_EXT_BCAST_OPEN)) {
+      open(getDataWord(request) & 0xFFFFU, getDataWord(request) >> 16U);
+      return true;
+    }
+
+    if (isRequest(request, REQ_EXT_BCAST_PAGE)) {
+      const uint32_t page_id = getDataWord(request);
+      _page_active = (page_id < NUM_PAGES) && isPageMissing(page_id);
+      _page_id = page_id;
+      _block_idx = 0U;
+      return true;
+    }
+
+    if (isRequest(request, REQ_EXT_BCAST_PAGE_END)) {
+      if (_page_active) {
+        _page_active = false;
+        if (writePage(getDataWord(request))) {
+          _missing[_page_id / 32U] &= ~(1U << (_page_id % 32U));
+          _num_pages_written++;
+        } else {
+          _num_page_errors++;
+        }
+      }
+      return true;
+    }
+
+    if (isRequest(request, REQ_EXT_BCAST_STATUS)) {
+      _status_pending = true;
+      _status_word_idx = 0U;
+      _status_cycles = cycles;
+      return true;
+    }
+
+    return false;
+  }
+
+  /**
+   * @brief Processes status request sent to the node
+   *
+   * @return true if the request was a status request and the response is set
+   */
+  bool processRequest(const franklyboot::msg::Msg& request, franklyboot::msg::Msg& response) {
+    if (!isRequest(request, REQ_EXT_BCAST_STATUS)) {
+      return false;
+    }
+
+    response = createStatusResponse(request.data[0U]);
+    return true;
+  }
+
+  /**
+   * @brief Returns true while pages of an open update are missing (the host streams page data without waiting)
+   */
+  bool isActive() const { return _open && isAnyPageMissing(); }
+
+  /**
+   * @brief Feeds data block received on the broadcast data ID
+   */
+  void feed(const uint8_t* block) {
+    if (!_page_active) {
+      return;
+    }
+
+    if (_block_idx < NUM_BLOCKS) {
+      memcpy(&_page[_block_idx * BLOCK_SIZE], block, BLOCK_SIZE);
+    }
+    _block_idx++;
+  }
+
+  /**
+   * @brief Returns the next status response when the response slot of the node is reached
+   *
+   * @param cycles    CPU cycle counter
+   * @param response  Receives the status response
+   * @return true if the response is set
+   */
+  bool poll(const uint32_t cycles, franklyboot::msg::Msg& response) {
+    if (!_status_pending || ((cycles - _status_cycles) < (_slot_idx * SLOT_TIME_US * _cycles_per_us))) {
+      return false;
+    }
+
+    response = createStatusResponse(_status_word_idx);
+    _status_word_idx++;
+    _status_pending = (_status_word_idx < NUM_BITMAP_WORDS);
+    return true;
+  }
+
+ private:
+  void open(const uint32_t first_page, const uint32_t num_pages) {
+    for (uint32_t idx = 0U; idx < NUM_BITMAP_WORDS; idx++) {
+      _missing[idx] = 0U;
+    }
+
+    _open = (first_page >= APP_FIRST_PAGE) && (num_pages > 0U) && ((first_page + num_pages) <= NUM_PAGES);
+    if (_open) {
+      for (uint32_t page_id = first_page; page_id < (first_page + num_pages); page_id++) {
+        _missing[page_id / 32U] |= (1U << (page_id % 32U));
+      }
+    }
+
+    _page_active = false;
+    _status_pending = false;
+  }
+
+  bool writePage(const uint32_t page_crc) {
+    const uint32_t page_address = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(_page));
+    if ((_block_idx != NUM_BLOCKS) || (franklyboot::hwi::calculateCRC(page_address, PAGE_SIZE) != page_crc)) {
+      return false;
+    }
+
+    const uint32_t dst_address = FLASH_START_ADDR + _page_id * PAGE_SIZE;
+    return franklyboot::hwi::eraseFlashPage(_page_id) &&
+           franklyboot::hwi::writeDataBufferToFlash(dst_address, _page_id, _page, PAGE_SIZE);
+  }
+
+  franklyboot::msg::Msg createStatusResponse(const uint32_t word_idx) const {
+    const uint32_t missing = (word_idx < NUM_BITMAP_WORDS) ? _missing[word_idx] : 0U;
+    const bool complete = _open && !isAnyPageMissing();
+    return createResponse(REQ_EXT_BCAST_STATUS, complete ? franklyboot::msg::RES_OK : franklyboot::msg::RES_ERR,
+                          static_cast<uint8_t>(word_idx), missing);
+  }
+
+  bool isPageMissing(const uint32_t page_id) const { return ((_missing[page_id / 32U] >> (page_id % 32U)) & 1U) != 0U; }
+
+  bool isAnyPageMissing() const {
+    for (uint32_t idx = 0U; idx < NUM_BITMAP_WORDS; idx++) {
+      if (_missing[idx] != 0U) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  alignas(8) uint8_t _page[PAGE_SIZE] = {};
+  uint32_t _missing[NUM_BITMAP_WORDS] = {};
+
+  bool _open = {false};
+  bool _page_active = {false};
+  uint32_t _page_id = {0U};
+  uint32_t _block_idx = {0U};
+
+  uint32_t _slot_idx;
+  uint32_t _cycles_per_us;
+  bool _status_pending = {false};
+  uint32_t _status_word_idx = {0U};
+  uint32_t _status_cycles = {0U};
+
+  // Diagnostic counters (read via debugger)
+  uint32_t _num_pages_written = {0U};
+  uint32_t _num_page_errors = {0U};
+};
+
+};  // namespace ext
+
+#endif /* BCAST_UPDATE_H_ */
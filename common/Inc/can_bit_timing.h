@@ -0,0 +1,75 @@
+/**
+ * @file can_bit_timing.h
+ * @author agent (agent@local)
+ * @brief Calculation of CAN bit timing from the kernel clock
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * The bit timing is recalculated whenever the board changes its clock profile, so the bit rate on the bus
+ * stays the same. The calculation has no device dependencies, the board writes the register fields.
+ */
+
+#ifndef CAN_BIT_TIMING_H_
+#define CAN_BIT_TIMING_H_
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <stdint.h>
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+namespace ext {
+
+/**
+ * Bit timing in time quanta (register fields hold the values minus one)
+ */
+struct CanBitTiming {
+  uint32_t prescaler;  //!< Kernel clock cycles per time quantum
+  uint32_t tseg1;      //!< Time quanta before the sample point (propagation and phase segment 1)
+  uint32_t tseg2;      //!< Time quanta after the sample point (phase segment 2)
+};
+
+/**
+ * @brief Calculates the bit timing with the most time quanta per bit, which the segment limits allow
+ *
+ * @param clk_hz          Kernel clock in Hz
+ * @param bit_rate        Bit rate in bit/s
+ * @param sample_point    Sample point in 1/1000 of the bit time
+ * @param max_prescaler   Largest prescaler value
+ * @param max_tseg1       Largest time segment 1 in time quanta
+ * @param max_tseg2       Largest time segment 2 in time quanta
+ * @param timing          Receives the bit timing
+ * @return false if the bit rate is not reachable exactly with the kernel clock
+ */
+constexpr bool calcCanBitTiming(const uint32_t clk_hz, const uint32_t bit_rate, const uint32_t sample_point,
+                                const uint32_t max_prescaler, const uint32_t max_tseg1, const uint32_t max_tseg2,
+                                CanBitTiming& timing) {
+  constexpr uint32_t MIN_TQ_PER_BIT = {8U};
+
+  for (uint32_t prescaler = 1U; prescaler <= max_prescaler; prescaler++) {
+    const uint32_t clk_per_bit = prescaler * bit_rate;
+    if ((clk_hz % clk_per_bit) != 0U) {
+      continue;
+    }
+
+    const uint32_t num_tq = clk_hz / clk_per_bit;
+    if (num_tq < MIN_TQ_PER_BIT) {
+      return false;
+    }
+
+    uint32_t tseg2 = (num_tq * (1000U - sample_point) + 500U) / 1000U;
+    tseg2 = (tseg2 == 0U) ? 1U : tseg2;
+    const uint32_t tseg1 = num_tq - 1U - tseg2;
+    if ((tseg1 <= max_tseg1) && (tseg2 <= max_tseg2)) {
+      timing = {prescaler, tseg1, tseg2};
+      return true;
+    }
+  }
+
+  return false;
+}
+
+};  // namespace ext
+
+#endif /* CAN_BIT_TIMING_H_ */
@@ -0,0 +1,156 @@
+/**
+ * @file crc32.h
+ * @author agent (agent@local)
+ * @brief Portable CRC-32 (IEEE 802.3) with slicing-by-8 and compile time generated tables
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * Software fallback for devices without CRC unit (or if it can not be used). The CRC is the same as
+ * calculated by the bootloader host (reflected, polynomial 0xEDB88320, initial value and final XOR
+ * 0xFFFFFFFF). The tables are generated by the compiler and placed in read-only memory, so no runtime
+ * initialization is needed. Aligned data is processed 8 bytes per iteration with word reads
+ * (little endian targets only).
+ */
+
+#ifndef CRC32_H_
+#define CRC32_H_
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <stdint.h>
+#include <string.h>
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+namespace crc {
+
+constexpr uint32_t POLYNOMIAL = {0xEDB88320U};
+constexpr uint32_t INIT_VALUE = {0xFFFFFFFFU};
+constexpr uint32_t NUM_SLICES = {8U};
+
+/**
+ * Lookup tables for slicing-by-8, table[0] is the classic byte-wise table
+ */
+struct Tables {
+  uint32_t table[NUM_SLICES][256U];
+};
+
+/**
+ * @brief Generates lookup tables (evaluated at compile time)
+ */
+constexpr Tables createTables() {
+  Tables tables = {};
+
+  for (uint32_t idx = 0U; idx < 256U; idx++) {
+    uint32_t crc = idx;
+    for (uint32_t bit = 0U; bit < 8U; bit++) {
+      crc = ((crc & 1U) != 0U) ? ((crc >> 1U) ^ POLYNOMIAL) : (crc >> 1U);
+    }
+    tables.table[0U][idx] = crc;
+  }
+
+  for (uint32_t idx = 0U; idx < 256U; idx++) {
+    for (uint32_t slice = 1U; slice < NUM_SLICES; slice++) {
+      const uint32_t prev = tables.table[slice - 1U][idx];
+      tables.table[slice][idx] = (prev >> 8U) ^ tables.table[0U][prev & 0xFFU];
+    }
+  }
+
+  return tables;
+}
+
+inline constexpr Tables TABLES = createTables();
+
+static_assert(TABLES.table[0U][1U] == 0x77073096U, "CRC-32 table does not match IEEE 802.3");
+static_assert(TABLES.table[0U][255U] == 0x2D02EF8DU, "CRC-32 table does not match IEEE 802.3");
+
+/**
+ * @brief Updates running CRC (without initial value and final XOR) with the given data
+ */
+inline uint32_t update(uint32_t crc, const uint8_t* data, uint32_t num_bytes) {
+  const auto& tbl = TABLES.table;
+
+  // Byte-wise until data is word aligned
+  while ((num_bytes > 0U) && ((reinterpret_cast<uintptr_t>(data) & 0x3U) != 0U)) {
+    crc = (crc >> 8U) ^ tbl[0U][(crc ^ *data) & 0xFFU];
+    data++;
+    num_bytes--;
+  }
+
+  // Slicing-by-8 with aligned word reads
+  while (num_bytes >= 8U) {
+    uint32_t lo = 0U;
+    uint32_t hi = 0U;
+    memcpy(&lo, &data[0U], sizeof(lo));
+    memcpy(&hi, &data[4U], sizeof(hi));
+    lo ^= crc;
+
+    crc = tbl[7U][lo & 0xFFU] ^ tbl[6U][(lo >> 8U) & 0xFFU] ^ tbl[5U][(lo >> 16U) & 0xFFU] ^ tbl[4U][lo >> 24U] ^
+          tbl[3U][hi & 0xFFU] ^ tbl[2U][(hi >> 8U) & 0xFFU] ^ tbl[1U][(hi >> 16U) & 0xFFU] ^ tbl[0U][hi >> 24U];
+
+    data += 8U;
+    num_bytes -= 8U;
+  }
+
+  // Remaining bytes
+  while (num_bytes > 0U) {
+    crc = (crc >> 8U) ^ tbl[0U][(crc ^ *data) & 0xFFU];
+    data++;
+    num_bytes--;
+  }
+
+  return crc;
+}
+
+/**
+ * @brief Multiplies two polynomials modulo the CRC polynomial (reflected representation)
+ */
+constexpr uint32_t multModP(uint32_t a, uint32_t b) {
+  uint32_t product = 0U;
+  for (uint32_t mask = (1U << 31U); mask != 0U; mask >>= 1U) {
+    if ((a & mask) != 0U) {
+      product ^= b;
+    }
+    b = ((b & 1U) != 0U) ? ((b >> 1U) ^ POLYNOMIAL) : (b >> 1U);
+  }
+  return product;
+}
+
+/**
+ * @brief Returns operator to append num_bytes to a CRC (x^(8 * num_bytes) modulo the CRC polynomial)
+ */
+constexpr uint32_t shiftOperator(uint32_t num_bytes) {
+  uint32_t result = (1U << 31U);  // x^0
+  uint32_t power = (1U << 23U);   // x^8
+  while (num_bytes != 0U) {
+    if ((num_bytes & 1U) != 0U) {
+      result = multModP(power, result);
+    }
+    power = multModP(power, power);
+    num_bytes >>= 1U;
+  }
+  return result;
+}
+
+/**
+ * @brief Returns CRC-32 of the concatenation of block A and block B
+ *
+ * @param crc_a  CRC-32 of block A
+ * @param crc_b  CRC-32 of block B
+ * @param op_b   shiftOperator() of the length of block B
+ */
+constexpr uint32_t combine(const uint32_t crc_a, const uint32_t crc_b, const uint32_t op_b) {
+  return multModP(op_b, crc_a) ^ crc_b;
+}
+
+/**
+ * @brief Calculates CRC-32 of the given data
+ */
+inline uint32_t calculate(const uint8_t* data, const uint32_t num_bytes) {
+  return ~update(INIT_VALUE, data, num_bytes);
+}
+
+};  // namespace crc
+
+#endif /* CRC32_H_ */
@@ -0,0 +1,134 @@
+/**
+ * @file discovery.h
+ * @author agent (agent@local)
+ * @brief Enumeration of all bootloader nodes on a bus with one broadcast request
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * The host sends REQ_EXT_DISCOVER to the broadcast ID (data[0]: number of slots, 0 = NUM_SLOTS). Every node
+ * answers once in the slot given by the hash of its unique ID, SLOT_TIME_US * slot after the request. Nodes
+ * in the same slot are ordered by the arbitration of their response IDs, the slots spread the answers and
+ * separate nodes configured with the same node ID.
+ *
+ * The answer consists of NUM_INFO_WORDS responses to REQ_EXT_DISCOVER (RES_OK, packet_id: word index):
+ *  0. Vendor ID
+ *  1. Product ID
+ *  2. Bootloader version
+ *  3. Hash of the unique ID (identifies the node if node IDs are duplicated)
+ */
+
+#ifndef DISCOVERY_H_
+#define DISCOVERY_H_
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <francor/franklyboot/msg.h>
+#include <stdint.h>
+
+#include "ext_msg.h"
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+namespace ext {
+
+/**
+ * @brief Returns 32 bit hash of the 96 bit unique ID (all bits of the ID affect all bits of the hash)
+ */
+constexpr uint32_t hashUniqueID(const uint32_t uid_0, const uint32_t uid_1, const uint32_t uid_2) {
+  uint32_t hash = uid_0;
+  for (const uint32_t word : {uid_1, uid_2, 0U}) {
+    hash ^= hash >> 16U;
+    hash *= 0x45D9F3BU;
+    hash ^= hash >> 16U;
+    hash ^= word;
+  }
+  return hash;
+}
+
+/**
+ * @brief Answers discovery requests in the slot of the node
+ */
+class Discovery {
+ public:
+  static constexpr uint32_t NUM_SLOTS = {64U};
+  static constexpr uint32_t SLOT_TIME_US = {1000U};
+  static constexpr uint32_t NUM_INFO_WORDS = {4U};
+
+  /**
+   * @param cpu_clk_hz Clock of the cycle counter in Hz
+   */
+  explicit constexpr Discovery(const uint32_t cpu_clk_hz) : _cycles_per_us(cpu_clk_hz / 1000000U) {}
+
+  /**
+   * @brief Sets the clock of the cycle counter after a system clock change
+   */
+  void setClock(const uint32_t cpu_clk_hz) { _cycles_per_us = cpu_clk_hz / 1000000U; }
+
+  /**
+   * @brief Sets the information sent in the answer
+   */
+  void setDeviceInfo(const uint32_t vendor_id, const uint32_t product_id, const uint32_t version,
+                     const uint32_t uid_hash) {
+    _info[0U] = vendor_id;
+    _info[1U] = product_id;
+    _info[2U] = version;
+    _info[3U] = uid_hash;
+  }
+
+  /**
+   * @brief Processes broadcast request
+   *
+   * @param request Broadcast request
+   * @param cycles  CPU cycle counter at reception (start of the slots)
+   * @return true if the request was a discovery request (answered by poll())
+   */
+  bool processBroadcast(const franklyboot::msg::Msg& request, const uint32_t cycles) {
+    if (!isRequest(request, REQ_EXT_DISCOVER)) {
+      return false;
+    }
+
+    const uint32_t num_slots = (request.data[0U] != 0U) ? request.data[0U] : NUM_SLOTS;
+    _slot_idx = _info[3U] % num_slots;
+    _request_cycles = cycles;
+    _info_idx = 0U;
+    _pending = true;
+    _num_requests++;
+    return true;
+  }
+
+  /**
+   * @brief Returns the next response of the answer when the slot of the node is reached
+   *
+   * @param cycles    CPU cycle counter
+   * @param response  Receives the response
+   * @return true if the response is set
+   */
+  bool poll(const uint32_t cycles, franklyboot::msg::Msg& response) {
+    if (!_pending || ((cycles - _request_cycles) < (_slot_idx * SLOT_TIME_US * _cycles_per_us))) {
+      return false;
+    }
+
+    response = createResponse(REQ_EXT_DISCOVER, franklyboot::msg::RES_OK, static_cast<uint8_t>(_info_idx),
+                              _info[_info_idx]);
+    _info_idx++;
+    _pending = (_info_idx < NUM_INFO_WORDS);
+    return true;
+  }
+
+ private:
+  uint32_t _info[NUM_INFO_WORDS] = {};
+  uint32_t _cycles_per_us;
+
+  bool _pending = {false};
+  uint32_t _slot_idx = {0U};
+  uint32_t _info_idx = {0U};
+  uint32_t _request_cycles = {0U};
+
+  // Diagnostic counter (read via debugger)
+  uint32_t _num_requests = {0U};
+};
+
+};  // namespace ext
+
+#endif /* DISCOVERY_H_ */
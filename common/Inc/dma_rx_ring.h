@@ -0,0 +1,116 @@
+/**
+ * @file dma_rx_ring.h
+ * @author agent (agent@local)
+ * @brief Serial reception ring buffer written by a DMA channel in circular mode
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * The DMA writes the received bytes into the buffer and counts its transfer counter (CNDTR) down from SIZE,
+ * it is reloaded with SIZE after the last byte of the buffer. The ISRs (DMA half/full transfer and UART idle
+ * line) publish the bytes written since their last call, the main loop reads them. Head and tail count bytes
+ * continuously, so data overwritten before it is read is detected as overrun. The half transfer interrupt
+ * guarantees a publish at least every SIZE / 2 bytes.
+ *
+ * The class has no device dependencies, the DMA channel is configured by the board.
+ */
+
+#ifndef DMA_RX_RING_H_
+#define DMA_RX_RING_H_
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <stdint.h>
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+namespace ext {
+
+/**
+ * @brief Ring buffer of a circular DMA reception
+ *
+ * @tparam SIZE Size of the buffer in bytes (must be a power of two)
+ */
+template <uint32_t SIZE>
+class DmaRxRing {
+ public:
+  static_assert((SIZE & (SIZE - 1U)) == 0U, "SIZE must be a power of two");
+
+  /**
+   * @brief Returns the buffer written by the DMA (memory address of the channel)
+   */
+  volatile uint8_t* getBuffer() { return _buffer; }
+
+  /**
+   * @brief Publishes the bytes written by the DMA since the last call, called by the ISRs
+   *
+   * @param ndtr Transfer counter of the DMA channel (CNDTR)
+   */
+  void publish(const uint32_t ndtr) {
+    const uint32_t dma_pos = SIZE - ndtr;
+    _head = _head + ((dma_pos - _dma_pos) & MASK);
+    _dma_pos = dma_pos;
+  }
+
+  /**
+   * @brief Returns the number of bytes published since startup
+   */
+  uint32_t getHead() const { return _head; }
+
+  /**
+   * @brief Returns the number of bytes read since startup
+   */
+  uint32_t getTail() const { return _tail; }
+
+  /**
+   * @brief Returns true and drops all pending bytes if the DMA has overwritten unread data
+   */
+  bool checkOverrun() {
+    const uint32_t head = _head;
+
+    if ((head - _tail) > SIZE) {
+      _tail = head;
+      _num_overruns = _num_overruns + 1U;
+      return true;
+    }
+
+    return false;
+  }
+
+  /**
+   * @brief Reads the next published byte
+   */
+  bool pop(uint8_t& byte) {
+    if (_tail != _head) {
+      byte = _buffer[_tail & MASK];
+      _tail++;
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Drops all received data including the bytes not published yet (called with the ISRs disabled)
+   *
+   * @param ndtr Transfer counter of the DMA channel (CNDTR)
+   */
+  void drop(const uint32_t ndtr) {
+    publish(ndtr);
+    _tail = _head;
+  }
+
+ private:
+  static constexpr uint32_t MASK = {SIZE - 1U};
+
+  volatile uint8_t _buffer[SIZE] = {};
+  volatile uint32_t _head = {0U};
+  volatile uint32_t _dma_pos = {0U};
+  uint32_t _tail = {0U};
+
+  // Diagnostic counter (read via debugger)
+  volatile uint32_t _num_overruns = {0U};
+};
+
+};  // namespace ext
+
+#endif /* DMA_RX_RING_H_ */
@@ -0,0 +1,51 @@
+/**
+ * @file ext_config.h
+ * @author agent (agent@local)
+ * @brief Build options of the board extensions
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * Every extension is included by default. Boards with a small bootloader area exclude extensions with
+ * FRANKLYBOOT_EXT_<NAME>=0 (make EXT_<NAME>=0, see make/extensions.mk). The request dispatch of an excluded
+ * extension is removed, so its code is dropped by the linker (--gc-sections) and its requests are passed
+ * to the bootloader handler, which answers them as unknown.
+ */
+
+#ifndef EXT_CONFIG_H_
+#define EXT_CONFIG_H_
+
+#ifndef FRANKLYBOOT_EXT_PAGE_STREAM
+#define FRANKLYBOOT_EXT_PAGE_STREAM 1
+#endif
+
+#ifndef FRANKLYBOOT_EXT_REQ_WINDOW
+#define FRANKLYBOOT_EXT_REQ_WINDOW 1
+#endif
+
+#ifndef FRANKLYBOOT_EXT_PAGE_PATCH
+#define FRANKLYBOOT_EXT_PAGE_PATCH 1
+#endif
+
+#ifndef FRANKLYBOOT_EXT_BAUD_SWITCH
+#define FRANKLYBOOT_EXT_BAUD_SWITCH 1
+#endif
+
+#ifndef FRANKLYBOOT_EXT_FRAME_MODE
+#define FRANKLYBOOT_EXT_FRAME_MODE 1
+#endif
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+namespace ext {
+
+constexpr bool EXT_PAGE_STREAM = {FRANKLYBOOT_EXT_PAGE_STREAM != 0};  //!< REQ_EXT_PAGE_STREAM (page_stream.h)
+constexpr bool EXT_REQ_WINDOW = {FRANKLYBOOT_EXT_REQ_WINDOW != 0};    //!< REQ_EXT_WINDOW_* (req_window.h)
+constexpr bool EXT_PAGE_PATCH = {FRANKLYBOOT_EXT_PAGE_PATCH != 0};    //!< REQ_EXT_PATCH_* (page_patch.h)
+constexpr bool EXT_BAUD_SWITCH = {FRANKLYBOOT_EXT_BAUD_SWITCH != 0};  //!< REQ_EXT_BAUD_SWITCH (baud_switch.h)
+constexpr bool EXT_FRAME_MODE = {FRANKLYBOOT_EXT_FRAME_MODE != 0};    //!< REQ_EXT_FRAME_MODE (frame_codec.h)
+
+};  // namespace ext
+
+#endif /* EXT_CONFIG_H_ */
@@ -0,0 +1,78 @@
+/**
+ * @file ext_msg.h
+ * @author agent (agent@local)
+ * @brief Board extension requests handled by the firmware examples in front of the bootloader handler
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * Extension requests use the range 0xF000 - 0xFFFF, which is not used by the bootloader library.
+ * They are encoded in the same 8 byte message format as all other requests.
+ */
+
+#ifndef EXT_MSG_H_
+#define EXT_MSG_H_
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <francor/franklyboot/msg.h>
+#include <stdint.h>
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+namespace ext {
+
+/**
+ * Extension request types
+ */
+enum ExtRequestType : uint16_t {
+  REQ_EXT_PAGE_STREAM = 0xF001U,       //!< Open bulk page stream (data: number of bytes, LE)
+  REQ_EXT_WINDOW_OPEN = 0xF002U,       //!< Open request window (data[0]: window size, 0 = close)
+  REQ_EXT_WINDOW_STATUS = 0xF003U,     //!< Window status (expected packet_id, credits, reorder bitmap)
+  REQ_EXT_FLASH_SKIP_STATS = 0xF004U,  //!< Number of skipped pages and pages programmed without erase
+  REQ_EXT_PATCH_OPEN = 0xF005U,        //!< Open delta patch or compressed image (data: size in bytes, LE)
+  REQ_EXT_PATCH_DATA = 0xF006U,        //!< Next 4 bytes of the delta patch or compressed image
+  REQ_EXT_BAUD_SWITCH = 0xF007U,       //!< Switch or confirm serial baud rate (data: baud rate, LE)
+  REQ_EXT_FRAME_MODE = 0xF008U,        //!< Select framed (data[0] = 1) or raw (data[0] = 0) serial mode
+  REQ_EXT_BCAST_OPEN = 0xF009U,        //!< Open broadcast update (data: first page id, number of pages, LE)
+  REQ_EXT_BCAST_PAGE = 0xF00AU,        //!< Broadcast page header (data: page id, LE)
+  REQ_EXT_BCAST_PAGE_END = 0xF00BU,    //!< Broadcast page trailer (data: CRC-32 of the page, LE)
+  REQ_EXT_BCAST_STATUS = 0xF00CU,      //!< Bitmap of missing pages of the broadcast update
+  REQ_EXT_DISCOVER = 0xF00DU,          //!< Enumerate nodes (data[0]: number of slots, 0 = default)
+  REQ_EXT_NODE_ID_ASSIGN = 0xF00EU,    //!< Assign node ID (packet_id) to node with unique ID hash (data, LE)
+};
+
+/**
+ * @brief Returns true if the request is the given extension request
+ */
+inline bool isRequest(const franklyboot::msg::Msg& msg, const ExtRequestType type) {
+  return static_cast<uint16_t>(msg.request) == static_cast<uint16_t>(type);
+}
+
+/**
+ * @brief Creates response to an extension request
+ */
+inline franklyboot::msg::Msg createResponse(const ExtRequestType type, const franklyboot::msg::ResultType result,
+                                            const uint8_t packet_id, const uint32_t data) {
+  franklyboot::msg::Msg response;
+  response.request = static_cast<franklyboot::msg::RequestType>(type);
+  response.result = result;
+  response.packet_id = packet_id;
+  response.data[0U] = static_cast<uint8_t>(data);
+  response.data[1U] = static_cast<uint8_t>(data >> 8U);
+  response.data[2U] = static_cast<uint8_t>(data >> 16U);
+  response.data[3U] = static_cast<uint8_t>(data >> 24U);
+  return response;
+}
+
+/**
+ * @brief Returns data of a message as little endian word
+ */
+inline uint32_t getDataWord(const franklyboot::msg::Msg& msg) {
+  return static_cast<uint32_t>(msg.data[0U]) | (static_cast<uint32_t>(msg.data[1U]) << 8U) |
+         (static_cast<uint32_t>(msg.data[2U]) << 16U) | (static_cast<uint32_t>(msg.data[3U]) << 24U);
+}
+
+};  // namespace ext
+
+#endif /* EXT_MSG_H_ */
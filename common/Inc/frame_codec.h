@@ -0,0 +1,238 @@
+/**
+ * @file frame_codec.h
+ * @author agent (agent@local)
+ * @brief Optional framed mode of the serial line with sync marker, length field and CRC-8
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * In raw mode the serial line carries the 8 byte messages without delimiter and integrity check. A lost
+ * byte misaligns the following messages until the line is idle, corrupt messages are processed.
+ *
+ * Framed mode wraps every message (requests, responses and raw blocks of a page stream):
+ *
+ *  | FRAME_SYNC_MARKER | length | payload (length bytes) | CRC-8 of length and payload |
+ *
+ * The receiver searches the marker, checks the length and the CRC and drops the frame otherwise. After a
+ * failed frame the search continues with the byte following the rejected marker, so the receiver is in sync
+ * again with the next complete frame. The CRC-8 (polynomial 0x07, initial value 0x00) has a Hamming distance
+ * of 4 for the frame size, so every error of up to 3 bits is detected.
+ *
+ * REQ_EXT_FRAME_MODE (data[0]: 1 = framed, 0 = raw) is answered with RES_OK (data[0]: mode) in the previous
+ * mode. The new mode is used from the next message on, the host has to wait for the response before it
+ * sends the next request.
+ */
+
+#ifndef FRAME_CODEC_H_
+#define FRAME_CODEC_H_
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <francor/franklyboot/msg.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <array>
+
+#include "ext_msg.h"
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+namespace ext {
+
+constexpr uint8_t FRAME_SYNC_MARKER = {0xA5U};
+constexpr uint32_t FRAME_OVERHEAD = {3U};  // Sync marker, length and CRC-8
+constexpr uint8_t CRC8_POLYNOMIAL = {0x07U};
+
+/**
+ * @brief Generates CRC-8 lookup table (evaluated at compile time)
+ */
+constexpr std::array<uint8_t, 256U> createCRC8Table() {
+  std::array<uint8_t, 256U> table = {};
+
+  for (uint32_t idx = 0U; idx < 256U; idx++) {
+    uint8_t crc = static_cast<uint8_t>(idx);
+    for (uint32_t bit = 0U; bit < 8U; bit++) {
+      crc = ((crc & 0x80U) != 0U) ? static_cast<uint8_t>((crc << 1U) ^ CRC8_POLYNOMIAL)
+                                  : static_cast<uint8_t>(crc << 1U);
+    }
+    table[idx] = crc;
+  }
+
+  return table;
+}
+
+inline constexpr std::array<uint8_t, 256U> CRC8_TABLE = createCRC8Table();
+
+static_assert(CRC8_TABLE[1U] == 0x07U, "CRC-8 table does not match polynomial 0x07");
+static_assert(CRC8_TABLE[255U] == 0xF3U, "CRC-8 table does not match polynomial 0x07");
+
+/**
+ * @brief Calculates CRC-8 of the given data
+ */
+inline uint8_t calculateCRC8(const uint8_t* data, const uint32_t num_bytes) {
+  uint8_t crc = 0U;
+  for (uint32_t idx = 0U; idx < num_bytes; idx++) {
+    crc = CRC8_TABLE[crc ^ data[idx]];
+  }
+  return crc;
+}
+
+/**
+ * @brief Encoder and resynchronising decoder of the framed mode
+ *
+ * @tparam PAYLOAD_SIZE Size of the messages (only frames with this length are accepted)
+ */
+template <uint32_t PAYLOAD_SIZE>
+class FrameCodec {
+ public:
+  static_assert((PAYLOAD_SIZE > 0U) && (PAYLOAD_SIZE <= 0xFFU), "PAYLOAD_SIZE must fit into the length field");
+
+  static constexpr uint32_t FRAME_SIZE = {PAYLOAD_SIZE + FRAME_OVERHEAD};
+
+  /**
+   * @brief Processes extension request to select the mode
+   *
+   * @return true if the request was a frame mode request and the response is set
+   */
+  bool processRequest(const franklyboot::msg::Msg& request, franklyboot::msg::Msg& response) {
+    if (!isRequest(request, REQ_EXT_FRAME_MODE)) {
+      return false;
+    }
+
+    const uint8_t mode = request.data[0U];
+    if (mode > 1U) {
+      response = createResponse(REQ_EXT_FRAME_MODE, franklyboot::msg::RES_ERR, request.packet_id, _enabled);
+      return true;
+    }
+
+    _switch_pending = true;
+    _switch_enabled = (mode != 0U);
+    response = createResponse(REQ_EXT_FRAME_MODE, franklyboot::msg::RES_OK, request.packet_id, mode);
+    return true;
+  }
+
+  /**
+   * @brief Returns true if framed mode is active
+   */
+  bool isEnabled() const { return _enabled; }
+
+  /**
+   * @brief Returns to raw mode (e.g. if the host restarts the link)
+   */
+  void disable() {
+    _enabled = false;
+    _switch_pending = false;
+    resetDecoder();
+  }
+
+  /**
+   * @brief Encodes message for transmission in the active mode
+   *
+   * The response to REQ_EXT_FRAME_MODE is the last message encoded in the previous mode. The decoder state is
+   * not touched, it belongs to the receiving side (Core1 on the Pico), which calls resetDecoder() when it sees
+   * isEnabled() change.
+   *
+   * @param msg     Message in wire format (PAYLOAD_SIZE bytes)
+   * @param buffer  Receives the encoded message (FRAME_SIZE bytes)
+   * @return Number of bytes to transmit
+   */
+  uint32_t encode(const uint8_t* msg, uint8_t* buffer) {
+    uint32_t num_bytes = PAYLOAD_SIZE;
+    if (_enabled) {
+      buffer[0U] = FRAME_SYNC_MARKER;
+      buffer[1U] = static_cast<uint8_t>(PAYLOAD_SIZE);
+      memcpy(&buffer[2U], msg, PAYLOAD_SIZE);
+      buffer[FRAME_SIZE - 1U] = calculateCRC8(&buffer[1U], PAYLOAD_SIZE + 1U);
+      num_bytes = FRAME_SIZE;
+    } else {
+      memcpy(buffer, msg, PAYLOAD_SIZE);
+    }
+
+    const uint16_t request = static_cast<uint16_t>(msg[0U]) | static_cast<uint16_t>(msg[1U] << 8U);
+    if (_switch_pending && (request == static_cast<uint16_t>(REQ_EXT_FRAME_MODE))) {
+      _switch_pending = false;
+      _enabled = _switch_enabled;
+    }
+
+    return num_bytes;
+  }
+
+  /**
+   * @brief Feeds received byte into the decoder (framed mode only)
+   *
+   * @param byte  Received byte
+   * @param msg   Receives the message (PAYLOAD_SIZE bytes) if a valid frame is complete
+   * @return true if a valid frame is complete
+   */
+  bool decode(const uint8_t byte, uint8_t* msg) {
+    _rx_frame[_rx_len] = byte;
+    _rx_len++;
+
+    for (;;) {
+      if (_rx_len == 0U) {
+        return false;
+      }
+
+      if (_rx_frame[0U] != FRAME_SYNC_MARKER) {
+        dropBytes(1U);
+        _num_skipped_bytes++;
+        continue;
+      }
+
+      if (_rx_len < 2U) {
+        return false;
+      }
+
+      if (_rx_frame[1U] != PAYLOAD_SIZE) {
+        dropBytes(1U);
+        _num_length_errors++;
+        continue;
+      }
+
+      if (_rx_len < FRAME_SIZE) {
+        return false;
+      }
+
+      if (calculateCRC8(&_rx_frame[1U], PAYLOAD_SIZE + 1U) != _rx_frame[FRAME_SIZE - 1U]) {
+        // Search next marker within the rejected frame
+        dropBytes(1U);
+        _num_crc_errors++;
+        continue;
+      }
+
+      memcpy(msg, &_rx_frame[2U], PAYLOAD_SIZE);
+      dropBytes(FRAME_SIZE);
+      _num_frames++;
+      return true;
+    }
+  }
+
+  /**
+   * @brief Discards a partially received frame
+   */
+  void resetDecoder() { _rx_len = 0U; }
+
+ private:
+  void dropBytes(const uint32_t num_bytes) {
+    _rx_len -= num_bytes;
+    memmove(&_rx_frame[0U], &_rx_frame[num_bytes], _rx_len);
+  }
+
+  volatile bool _enabled = {false};
+  bool _switch_pending = {false};
+  bool _switch_enabled = {false};
+
+  uint8_t _rx_frame[FRAME_SIZE] = {};
+  uint32_t _rx_len = {0U};
+
+  // Diagnostic counters (read via debugger)
+  uint32_t _num_frames = {0U};         //!< Valid frames received
+  uint32_t _num_crc_errors = {0U};     //!< Frames dropped because of a CRC mismatch
+  uint32_t _num_length_errors = {0U};  //!< Markers dropped because of an invalid length
+  uint32_t _num_skipped_bytes = {0U};  //!< Bytes skipped while searching the marker
+};
+
+};  // namespace ext
+
+#endif /* FRAME_CODEC_H_ */
@@ -0,0 +1,121 @@
+/**
+ * @file frame_sync.h
+ * @author agent (agent@local)
+ * @brief Message framing of the serial byte stream at idle gaps detected by the UART
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * The serial line carries 8 byte messages without delimiter. The host sends a message without pause between
+ * its bytes, so an idle line of a fixed number of bit times (UART receiver timeout or idle line detection)
+ * marks the end of the received data. A message which is incomplete at a gap is dropped and the next byte
+ * starts a new message. Back to back messages (request window) have no gaps and are split by their size.
+ *
+ * The UART ISR records the number of received bytes at each gap, the main loop checks the gaps against
+ * its read position before reading the next byte. The timing depends on the baud rate only, not on the
+ * system clock or the loop time of the main loop.
+ */
+
+#ifndef FRAME_SYNC_H_
+#define FRAME_SYNC_H_
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <stdint.h>
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+namespace ext {
+
+/**
+ * @brief Gap positions of the serial byte stream written by the UART ISR and read by the main loop
+ *
+ * @tparam NUM_GAPS Number of gap positions buffered (must be a power of two)
+ */
+template <uint32_t NUM_GAPS>
+class FrameSync {
+ public:
+  static_assert((NUM_GAPS & (NUM_GAPS - 1U)) == 0U, "NUM_GAPS must be a power of two");
+
+  /**
+   * @brief Records gap after the received data, called by the UART ISR
+   *
+   * @param byte_cnt Number of bytes received since startup
+   */
+  void markGap(const uint32_t byte_cnt) {
+    const uint32_t head = _gap_head;
+    if ((head - _gap_tail) >= NUM_GAPS) {
+      _num_gap_overruns++;
+      return;
+    }
+
+    _gaps[head & GAP_MASK] = byte_cnt;
+    _gap_head = head + 1U;
+    _num_gaps++;
+  }
+
+  /**
+   * @brief Checks for a gap at the read position, called by the main loop before reading the next byte
+   *
+   * @param byte_cnt  Number of bytes read since startup
+   * @param msg_idx   Number of bytes of the current message read so far
+   * @return true if the current message is incomplete and has to be dropped
+   */
+  bool checkGap(const uint32_t byte_cnt, const uint32_t msg_idx) {
+    bool gap = false;
+
+    // Gaps before the read position are left from dropped data
+    while (_gap_tail != _gap_head) {
+      const uint32_t gap_pos = _gaps[_gap_tail & GAP_MASK];
+      if (static_cast<int32_t>(gap_pos - byte_cnt) > 0) {
+        break;
+      }
+
+      gap = (gap_pos == byte_cnt);
+      _gap_tail = _gap_tail + 1U;
+    }
+
+    if (gap && (msg_idx != 0U)) {
+      _num_resyncs++;
+      return true;
+    }
+
+    return false;
+  }
+
+  /**
+   * @brief Discards all recorded gaps, called if the received data is dropped
+   */
+  void reset() { _gap_tail = _gap_head; }
+
+  /**
+   * @brief Returns the number of gaps recorded by the UART ISR
+   */
+  uint32_t getNumGaps() const { return _num_gaps; }
+
+  /**
+   * @brief Returns the number of incomplete messages dropped at a gap
+   */
+  uint32_t getNumResyncs() const { return _num_resyncs; }
+
+  /**
+   * @brief Returns the number of gaps lost because the buffer of gap positions was full
+   */
+  uint32_t getNumGapOverruns() const { return _num_gap_overruns; }
+
+ private:
+  static constexpr uint32_t GAP_MASK = {NUM_GAPS - 1U};
+
+  volatile uint32_t _gaps[NUM_GAPS] = {};
+  volatile uint32_t _gap_head = {0U};
+  volatile uint32_t _gap_tail = {0U};
+
+  // Diagnostic counters (read via debugger)
+  volatile uint32_t _num_gaps = {0U};          //!< Gaps detected by the UART
+  volatile uint32_t _num_resyncs = {0U};       //!< Incomplete messages dropped at a gap
+  volatile uint32_t _num_gap_overruns = {0U};  //!< Gaps not recorded because the main loop lagged behind
+};
+
+};  // namespace ext
+
+#endif /* FRAME_SYNC_H_ */
@@ -0,0 +1,127 @@
+/**
+ * @file isr_queue.h
+ * @author agent (agent@local)
+ * @brief Fixed size queue between the main loop and an ISR (TX queues and CAN RX ring of the boards)
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * One side pushes, the other side pops. The head counter is only written by the producer, the tail counter
+ * only by the consumer. Both count continuously and are masked on access, so all SIZE slots are usable and
+ * (head - tail) is the number of queued elements also after the counters wrap around.
+ *
+ * The slot is written before the head is advanced and read before the tail is advanced. A compiler barrier
+ * keeps this order, the boards run producer and consumer on the same core (ISR and main loop), so no memory
+ * barrier is required. The queue never blocks: the producer checks isFull() and decides whether to wait or to
+ * drop the element (e.g. TX timeout, RX overrun).
+ *
+ * The class has no device dependencies, so the index arithmetic is tested on the host.
+ */
+
+#ifndef ISR_QUEUE_H_
+#define ISR_QUEUE_H_
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <stdint.h>
+
+#include <atomic>
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+namespace ext {
+
+/**
+ * @brief Queue between the main loop and an ISR
+ *
+ * @tparam T     Element type
+ * @tparam SIZE  Number of elements (must be a power of two)
+ */
+template <typename T, uint32_t SIZE>
+class IsrQueue {
+ public:
+  static_assert((SIZE > 0U) && ((SIZE & (SIZE - 1U)) == 0U), "SIZE must be a power of two");
+
+  /**
+   * @brief Resets the counters (only while producer and consumer are stopped, e.g. queue in uninitialized RAM)
+   */
+  void reset() {
+    _head = 0U;
+    _tail = 0U;
+  }
+
+  /**
+   * @brief Returns number of queued elements
+   */
+  uint32_t getNumQueued() const { return _head - _tail; }
+
+  /**
+   * @brief Returns true if no element is queued
+   */
+  bool isEmpty() const { return _head == _tail; }
+
+  /**
+   * @brief Returns true if all slots are occupied (producer side)
+   */
+  bool isFull() const { return (_head - _tail) >= SIZE; }
+
+  /**
+   * @brief Returns the free slot written by the next push() (producer side, only if not full)
+   */
+  T& back() { return _buffer[_head & MASK]; }
+
+  /**
+   * @brief Publishes the slot returned by back() (producer side)
+   */
+  void push() {
+    std::atomic_signal_fence(std::memory_order_release);
+    _head = _head + 1U;
+  }
+
+  /**
+   * @brief Copies element into the queue (producer side)
+   *
+   * @return false if the queue is full, the element is not queued
+   */
+  bool push(const T& element) {
+    if (isFull()) {
+      return false;
+    }
+
+    back() = element;
+    push();
+    return true;
+  }
+
+  /**
+   * @brief Returns the oldest element (consumer side, only if not empty)
+   */
+  T& front() {
+    std::atomic_signal_fence(std::memory_order_acquire);
+    return _buffer[_tail & MASK];
+  }
+
+  /**
+   * @brief Releases the slot of the oldest element (consumer side)
+   */
+  void pop() {
+    std::atomic_signal_fence(std::memory_order_release);
+    _tail = _tail + 1U;
+  }
+
+  /**
+   * @brief Drops all queued elements (consumer side)
+   */
+  void clear() { _tail = _head; }
+
+ private:
+  static constexpr uint32_t MASK = {SIZE - 1U};
+
+  T _buffer[SIZE];
+  volatile uint32_t _head = {0U};
+  volatile uint32_t _tail = {0U};
+};
+
+};  // namespace ext
+
+#endif /* ISR_QUEUE_H_ */
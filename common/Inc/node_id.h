@@ -0,0 +1,198 @@
+/**
+ * @file node_id.h
+ * @author agent (agent@local)
+ * @brief Node ID of a bus node derived from the unique ID or assigned at runtime and stored persistently
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * Without stored assignment the board uses its default node ID: the configured one, or the one derived from
+ * the hash of the unique ID (see hashUniqueID()) so that all nodes can run the same binary. Default IDs of
+ * identical nodes collide, they are resolved by the host:
+ *
+ *  1. REQ_EXT_DISCOVER lists all nodes with their unique ID hash (answers of nodes with the same ID are
+ *     separated by their slots, see discovery.h).
+ *  2. REQ_EXT_NODE_ID_ASSIGN to the broadcast ID (packet_id: node ID, data: unique ID hash, LE) assigns
+ *     the node ID to the addressed node. NODE_ID_DEFAULT returns to the default node ID.
+ *  3. The node applies the assignment and answers with its new node ID: RES_OK (packet_id: node ID, data:
+ *     unique ID hash). RES_ERR if the node ID is invalid or the assignment could not be stored, the node
+ *     ID is not changed then.
+ *
+ * Without persistent storage an assignment holds until the next reset. With storage, assignments are stored
+ * as records of two words (write once memory, e.g. OTP). The last valid record is used, every assignment
+ * takes the next free record. To save records, an assignment of the stored node ID is not stored again and
+ * at most MAX_STORES_PER_BOOT assignments are stored per power cycle.
+ */
+
+#ifndef NODE_ID_H_
+#define NODE_ID_H_
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <francor/franklyboot/msg.h>
+#include <stdint.h>
+
+#include "ext_msg.h"
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+namespace ext {
+
+constexpr uint32_t NODE_ID_RECORD_MAGIC = {0x4449444EU};  // "NDID"
+constexpr uint32_t NODE_ID_DEFAULT = {0xFFU};
+
+/**
+ * Stored node ID assignment (erased: all bits set)
+ */
+struct NodeIDRecord {
+  uint32_t magic;  //!< NODE_ID_RECORD_MAGIC
+  uint32_t value;  //!< Node ID in the low half word, inverted node ID in the high half word
+};
+
+/**
+ * @brief Node ID of the board
+ *
+ * @tparam NUM_NODE_IDS Number of valid node IDs (0 to NUM_NODE_IDS - 1)
+ * @tparam NUM_RECORDS  Number of records reserved for assignments
+ */
+template <uint32_t NUM_NODE_IDS, uint32_t NUM_RECORDS>
+class NodeID {
+ public:
+  static_assert(NUM_NODE_IDS < NODE_ID_DEFAULT, "NODE_ID_DEFAULT must not be a valid node ID");
+
+  static constexpr uint32_t MAX_STORES_PER_BOOT = {1U};
+
+  /**
+   * Action the board has to execute after processBroadcast()
+   */
+  enum AssignAction : uint8_t {
+    ASSIGN_NONE = 0U,    //!< No assignment request
+    ASSIGN_IGNORE = 1U,  //!< Assignment of another node (not answered)
+    ASSIGN_REJECT = 2U,  //!< Invalid node ID or no record left: call finishAssignment(false)
+    ASSIGN_APPLY = 3U,   //!< Nothing to store: call finishAssignment(true)
+    ASSIGN_STORE = 4U,   //!< Store record of getRecord() and call finishAssignment()
+  };
+
+  /**
+   * @brief Determines the node ID from the stored records or the default node ID
+   *
+   * @param records         Reserved records (NUM_RECORDS), nullptr without persistent storage
+   * @param uid_hash        Hash of the unique ID
+   * @param default_node_id Node ID without stored assignment
+   * @return Node ID
+   */
+  uint32_t load(const volatile NodeIDRecord* records, const uint32_t uid_hash, const uint32_t default_node_id) {
+    _uid_hash = uid_hash;
+    _default_node_id = default_node_id;
+    _persistent = (records != nullptr);
+    _stored_node_id = NODE_ID_DEFAULT;
+    _num_records = 0U;
+    _num_stores = 0U;
+
+    for (uint32_t idx = 0U; _persistent && (idx < NUM_RECORDS); idx++) {
+      const uint32_t magic = records[idx].magic;
+      const uint32_t value = records[idx].value;
+      if ((magic == 0xFFFFFFFFU) && (value == 0xFFFFFFFFU)) {
+        break;
+      }
+
+      // Records with invalid content (e.g. programming interrupted) are skipped
+      _num_records = idx + 1U;
+      if ((magic == NODE_ID_RECORD_MAGIC) && ((value >> 16U) == (~value & 0xFFFFU))) {
+        _stored_node_id = value & 0xFFFFU;
+      }
+    }
+
+    if (_stored_node_id >= NUM_NODE_IDS) {
+      _stored_node_id = NODE_ID_DEFAULT;
+    }
+    _node_id = resolve(_stored_node_id);
+    return _node_id;
+  }
+
+  /**
+   * @brief Returns the node ID
+   */
+  uint32_t getNodeID() const { return _node_id; }
+
+  /**
+   * @brief Processes broadcast request
+   */
+  AssignAction processBroadcast(const franklyboot::msg::Msg& request) {
+    if (!isRequest(request, REQ_EXT_NODE_ID_ASSIGN)) {
+      return ASSIGN_NONE;
+    }
+
+    if (getDataWord(request) != _uid_hash) {
+      return ASSIGN_IGNORE;
+    }
+
+    _assign_node_id = request.packet_id;
+    _store_pending = false;
+    if ((_assign_node_id >= NUM_NODE_IDS) && (_assign_node_id != NODE_ID_DEFAULT)) {
+      return ASSIGN_REJECT;
+    }
+
+    if (!_persistent || (_assign_node_id == _stored_node_id)) {
+      return ASSIGN_APPLY;
+    }
+
+    if ((_num_records >= NUM_RECORDS) || (_num_stores >= MAX_STORES_PER_BOOT)) {
+      return ASSIGN_REJECT;
+    }
+
+    _store_pending = true;
+    return ASSIGN_STORE;
+  }
+
+  /**
+   * @brief Returns the record to store for the pending assignment (ASSIGN_STORE)
+   */
+  void getRecord(uint32_t& record_idx, NodeIDRecord& record) const {
+    record_idx = _num_records;
+    record.magic = NODE_ID_RECORD_MAGIC;
+    record.value = _assign_node_id | ((~_assign_node_id & 0xFFFFU) << 16U);
+  }
+
+  /**
+   * @brief Applies the pending assignment
+   *
+   * @param applied true if the assignment is applied (and its record stored for ASSIGN_STORE)
+   * @return Response to the assignment
+   */
+  franklyboot::msg::Msg finishAssignment(const bool applied) {
+    if (_store_pending) {
+      // A failed record is skipped by load(), it counts as used
+      _num_records++;
+      _num_stores++;
+      _store_pending = false;
+      if (applied) {
+        _stored_node_id = _assign_node_id;
+      }
+    }
+
+    if (applied) {
+      _node_id = resolve(_assign_node_id);
+    }
+
+    return createResponse(REQ_EXT_NODE_ID_ASSIGN, applied ? franklyboot::msg::RES_OK : franklyboot::msg::RES_ERR,
+                          static_cast<uint8_t>(_node_id), _uid_hash);
+  }
+
+ private:
+  uint32_t resolve(const uint32_t node_id) const { return (node_id == NODE_ID_DEFAULT) ? _default_node_id : node_id; }
+
+  uint32_t _uid_hash = {0U};
+  uint32_t _default_node_id = {0U};
+  uint32_t _node_id = {0U};
+  bool _persistent = {false};
+  uint32_t _stored_node_id = {NODE_ID_DEFAULT};
+  uint32_t _num_records = {0U};
+  uint32_t _num_stores = {0U};
+  uint32_t _assign_node_id = {NODE_ID_DEFAULT};
+  bool _store_pending = {false};
+};
+
+};  // namespace ext
+
+#endif /* NODE_ID_H_ */
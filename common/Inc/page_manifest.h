@@ -0,0 +1,205 @@
+/**
+ * @file page_manifest.h
+ * @author agent (agent@local)
+ * @brief Flash resident manifest of per-page CRCs for incremental application validation
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * The manifest stores the CRC-32 of every application page. The last page is hashed without the
+ * application CRC word at the end of flash. Because CRC-32 can be combined, the CRC of the complete
+ * application follows from the page CRCs without reading the application:
+ *
+ *  - Update: erased or written pages are marked as unknown and the stored manifest is invalidated
+ *    on the first change. Before the application is started, only the unknown pages are hashed
+ *    and the manifest is written again.
+ *  - Boot: the manifest is checked by its own CRC, the combined page CRCs must match the application
+ *    CRC word and a few randomly sampled pages are hashed and compared. If the manifest is not
+ *    valid the board falls back to hashing the complete application.
+ *
+ * The class has no device dependencies, flash access is done by the board.
+ */
+
+#ifndef PAGE_MANIFEST_H_
+#define PAGE_MANIFEST_H_
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <stdint.h>
+
+#include "crc32.h"
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+namespace ext {
+
+/**
+ * @brief Per-page CRC manifest of the application
+ *
+ * @tparam APP_START_ADDR  Address of the first application page
+ * @tparam PAGE_SIZE       Size of a flash page in bytes
+ * @tparam NUM_PAGES       Number of application pages (the application CRC is the last word of the last page)
+ */
+template <uint32_t APP_START_ADDR, uint32_t PAGE_SIZE, uint32_t NUM_PAGES>
+class PageManifest {
+ public:
+  static constexpr uint32_t MAGIC = {0x314E414DU};  // "MAN1"
+  static constexpr uint32_t APP_CRC_ADDR = {APP_START_ADDR + NUM_PAGES * PAGE_SIZE - 4U};
+
+  /**
+   * Manifest as stored in flash
+   */
+  struct Data {
+    uint32_t magic;
+    uint32_t page_size;
+    uint32_t num_pages;
+    uint32_t page_crc[NUM_PAGES];
+    uint32_t manifest_crc;  // CRC of all previous fields
+  };
+
+  /**
+   * @brief Returns address of the application page
+   */
+  static constexpr uint32_t getPageAddress(const uint32_t page_idx) { return APP_START_ADDR + page_idx * PAGE_SIZE; }
+
+  /**
+   * @brief Returns number of hashed bytes of the application page (last page without application CRC)
+   */
+  static constexpr uint32_t getPageLength(const uint32_t page_idx) {
+    return (page_idx == (NUM_PAGES - 1U)) ? (PAGE_SIZE - 4U) : PAGE_SIZE;
+  }
+
+  /**
+   * @brief Returns true if the stored manifest is complete and not corrupted
+   */
+  static bool isValid(const Data& data) {
+    return (data.magic == MAGIC) && (data.page_size == PAGE_SIZE) && (data.num_pages == NUM_PAGES) &&
+           (data.manifest_crc == calcManifestCRC(data));
+  }
+
+  /**
+   * @brief Returns CRC of the complete application combined from the page CRCs
+   */
+  static uint32_t combinePageCRCs(const Data& data) {
+    constexpr uint32_t OP_PAGE = crc::shiftOperator(PAGE_SIZE);
+    constexpr uint32_t OP_LAST_PAGE = crc::shiftOperator(PAGE_SIZE - 4U);
+
+    uint32_t app_crc = data.page_crc[0U];
+    for (uint32_t idx = 1U; idx < NUM_PAGES; idx++) {
+      app_crc = crc::combine(app_crc, data.page_crc[idx], (idx == (NUM_PAGES - 1U)) ? OP_LAST_PAGE : OP_PAGE);
+    }
+    return app_crc;
+  }
+
+  /**
+   * @brief Validates the application with the stored manifest and hashes num_samples random pages
+   *
+   * @param data         Stored manifest
+   * @param app_crc      Application CRC word at the end of flash
+   * @param calc_crc     Function calculating the CRC-32 of (address, length)
+   * @param seed         Random value selecting the sampled pages
+   * @param num_samples  Number of pages to hash
+   */
+  template <typename CalcCRCFn>
+  static bool verify(const Data& data, const uint32_t app_crc, CalcCRCFn&& calc_crc, uint32_t seed,
+                     const uint32_t num_samples) {
+    if (!isValid(data) || (combinePageCRCs(data) != app_crc)) {
+      return false;
+    }
+
+    for (uint32_t sample = 0U; sample < num_samples; sample++) {
+      seed = seed * 1664525U + 1013904223U;
+      const uint32_t page_idx = seed % NUM_PAGES;
+      if (calc_crc(getPageAddress(page_idx), getPageLength(page_idx)) != data.page_crc[page_idx]) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * @brief Takes stored manifest as base for an update
+   *
+   * @return false if the stored manifest is not valid (all pages are unknown)
+   */
+  bool load(const Data& stored) {
+    const bool valid = isValid(stored);
+    _data = stored;
+    for (uint32_t idx = 0U; idx < NUM_PAGES; idx++) {
+      _page_known[idx] = valid;
+    }
+    _dirty = !valid;
+    return valid;
+  }
+
+  /**
+   * @brief Marks all pages as unknown (stored manifest does not match the application)
+   */
+  void clear() {
+    for (uint32_t idx = 0U; idx < NUM_PAGES; idx++) {
+      _page_known[idx] = false;
+    }
+    _dirty = true;
+  }
+
+  /**
+   * @brief Marks erased or written page as unknown
+   *
+   * @return true if this is the first change since the manifest was stored (stored manifest must be invalidated)
+   */
+  bool invalidatePage(const uint32_t page_idx) {
+    const bool first_change = !_dirty;
+    if (page_idx < NUM_PAGES) {
+      _page_known[page_idx] = false;
+    }
+    _dirty = true;
+    return first_change;
+  }
+
+  /**
+   * @brief Returns true if the manifest has to be stored again
+   */
+  bool isDirty() const { return _dirty; }
+
+  /**
+   * @brief Hashes all unknown pages and completes the manifest for storing
+   *
+   * @param calc_crc Function calculating the CRC-32 of (address, length)
+   * @return Manifest to store
+   */
+  template <typename CalcCRCFn>
+  const Data& update(CalcCRCFn&& calc_crc) {
+    for (uint32_t idx = 0U; idx < NUM_PAGES; idx++) {
+      if (!_page_known[idx]) {
+        _data.page_crc[idx] = calc_crc(getPageAddress(idx), getPageLength(idx));
+        _page_known[idx] = true;
+        _num_hashed_pages++;
+      }
+    }
+
+    _data.magic = MAGIC;
+    _data.page_size = PAGE_SIZE;
+    _data.num_pages = NUM_PAGES;
+    _data.manifest_crc = calcManifestCRC(_data);
+    _dirty = false;
+
+    return _data;
+  }
+
+ private:
+  static uint32_t calcManifestCRC(const Data& data) {
+    return crc::calculate(reinterpret_cast<const uint8_t*>(&data), sizeof(Data) - sizeof(data.manifest_crc));
+  }
+
+  Data _data;
+  bool _page_known[NUM_PAGES] = {};
+  bool _dirty = {true};
+
+  // Diagnostic counter (read via debugger)
+  uint32_t _num_hashed_pages = {0U};
+};
+
+};  // namespace ext
+
+#endif /* PAGE_MANIFEST_H_ */
@@ -0,0 +1,405 @@
+/**
+ * @file page_patch.h
+ * @author agent (agent@local)
+ * @brief Streaming delta patch applier and decompressor for differential and compressed application updates
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * The host sends a patch generated by tools/franklyboot_patch.py instead of the complete application.
+ * New pages are built in a page sized buffer from blocks of the old application in flash, LZ77 matches
+ * of the new application, literal data and fill runs (e.g. erased 0xFF areas), and are written with
+ * hwi::eraseFlashPage() and hwi::writeDataBufferToFlash().
+ *
+ * A patch without old application (old size 0) is the compressed transfer mode: the application is
+ * decompressed with matches only. The match window is the part of the new application written so far
+ * (read from flash) and the page buffer, so no additional RAM is needed.
+ *
+ * Protocol:
+ *  1. Host sends REQ_EXT_PATCH_OPEN with the patch size in bytes. The device acknowledges with RES_OK.
+ *  2. Host sends the patch with REQ_EXT_PATCH_DATA requests, 4 bytes per request (LE, the last request
+ *     is padded). Each request is answered with RES_OK and the number of written pages in the data field.
+ *     If the patch is not valid, the request and all following ones are answered with RES_ERR and the
+ *     patch offset of the error. The host falls back to a full update then.
+ *  Windowed requests are supported, so the host keeps the link busy while pages are written.
+ *
+ * Patch format (little endian, varint = LEB128, zigzag = signed varint):
+ *  - Header: magic "FBP1", page size, old size, CRC-32 of the old application (old size bytes from the
+ *    first application page, 0 if the old size is 0). The header is checked against the flash before
+ *    anything is written.
+ *  - Page records until the end of the patch: page id (varint), operations, OP_END.
+ *    Operations start with a token byte: operation in bits 5 - 7, length in bits 0 - 4. Length 31 is
+ *    followed by a varint, which is added to it.
+ *    - OP_COPY:    source offset relative to the destination (zigzag)
+ *    - OP_LITERAL: data bytes
+ *    - OP_FILL:    value byte
+ *    - OP_MATCH:   source offset relative to the destination (zigzag)
+ *    - OP_END:     CRC-32 of the new page (the page must be complete)
+ *
+ * Pages are patched in place: copies may only read old application pages which were not written by the
+ * patch before, matches only pages written before or the current page before the destination. The
+ * generator orders the pages accordingly, the applier rejects other copies and matches.
+ * Apart from the page buffer, the applier needs a bitmap of the written pages and a few words of state.
+ */
+
+#ifndef PAGE_PATCH_H_
+#define PAGE_PATCH_H_
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <francor/franklyboot/handler.h>
+#include <francor/franklyboot/msg.h>
+#include <stdint.h>
+
+#include "ext_msg.h"
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+namespace ext {
+
+/**
+ * @brief In place patch applier
+ *
+ * @tparam FLASH_START_ADDR  Address of flash page 0
+ * @tparam APP_FIRST_PAGE    First application page
+ * @tparam FLASH_SIZE        Size of the flash in bytes
+ * @tparam PAGE_SIZE         Size of a flash page in bytes
+ */
+template <uint32_t FLASH_START_ADDR, uint32_t APP_FIRST_PAGE, uint32_t FLASH_SIZE, uint32_t PAGE_SIZE>
+class PagePatch {
+ public:
+  static constexpr uint32_t MAGIC = {0x31504246U};  // "FBP1"
+  static constexpr uint32_t HEADER_SIZE = {16U};
+  static constexpr uint32_t NUM_PAGES = {FLASH_SIZE / PAGE_SIZE};
+  static constexpr uint32_t APP_START_ADDR = {FLASH_START_ADDR + APP_FIRST_PAGE * PAGE_SIZE};
+  static constexpr uint32_t APP_SIZE = {FLASH_SIZE - APP_FIRST_PAGE * PAGE_SIZE};
+
+  /**
+   * Patch operations
+   */
+  enum PatchOp : uint8_t {
+    OP_END = 0U,      //!< Page complete, followed by CRC-32 of the page
+    OP_COPY = 1U,     //!< Copy from old application
+    OP_LITERAL = 2U,  //!< Literal data
+    OP_FILL = 3U,     //!< Run of one byte value
+    OP_MATCH = 4U,    //!< Copy from new application (LZ77 match)
+  };
+
+  /**
+   * @brief Processes patch extension requests
+   *
+   * @return true if the request was a patch request and the response is set
+   */
+  bool processRequest(const franklyboot::msg::Msg& request, franklyboot::msg::Msg& response) {
+    if (isRequest(request, REQ_EXT_PATCH_OPEN)) {
+      open(getDataWord(request));
+      response = createResponse(REQ_EXT_PATCH_OPEN, franklyboot::msg::RES_OK, request.packet_id, _patch_size);
+      return true;
+    }
+
+    if (!isRequest(request, REQ_EXT_PATCH_DATA)) {
+      return false;
+    }
+
+    for (uint32_t idx = 0U; (idx < 4U) && (_state != STATE_ERROR) && (_num_received < _patch_size); idx++) {
+      if (!feed(request.data[idx])) {
+        _state = STATE_ERROR;
+        _error_offset = _num_received;
+      }
+      _num_received++;
+    }
+
+    // Patch must end after a complete page record
+    const bool record_complete = (_state == STATE_PAGE_ID) && (_shift == 0U);
+    if ((_state != STATE_ERROR) && (_num_received >= _patch_size) && !record_complete) {
+      _state = STATE_ERROR;
+      _error_offset = _num_received;
+    }
+
+    if (_state == STATE_ERROR) {
+      response = createResponse(REQ_EXT_PATCH_DATA, franklyboot::msg::RES_ERR, request.packet_id, _error_offset);
+    } else {
+      response = createResponse(REQ_EXT_PATCH_DATA, franklyboot::msg::RES_OK, request.packet_id, _num_pages_written);
+    }
+    return true;
+  }
+
+ private:
+  enum State : uint8_t {
+    STATE_IDLE,
+    STATE_HEADER,
+    STATE_PAGE_ID,
+    STATE_OP,
+    STATE_LENGTH,
+    STATE_OFFSET,
+    STATE_LITERAL,
+    STATE_FILL,
+    STATE_CRC,
+    STATE_ERROR,
+  };
+
+  void open(const uint32_t patch_size) {
+    _state = (patch_size >= HEADER_SIZE) ? STATE_HEADER : STATE_ERROR;
+    _patch_size = patch_size;
+    _num_received = 0U;
+    _num_pages_written = 0U;
+    _error_offset = 0U;
+    resetVarint();
+
+    for (uint32_t idx = 0U; idx < NUM_BITMAP_WORDS; idx++) {
+      _page_written[idx] = 0U;
+    }
+  }
+
+  /**
+   * @brief Processes next byte of the patch
+   *
+   * @return false if the patch is not valid
+   */
+  bool feed(const uint8_t byte) {
+    switch (_state) {
+      case STATE_HEADER:
+        _header[_num_received] = byte;
+        return (_num_received < (HEADER_SIZE - 1U)) || checkHeader();
+
+      case STATE_PAGE_ID:
+        if (decodeVarint(byte)) {
+          return startPage();
+        }
+        return true;
+
+      case STATE_OP:
+        _op = byte >> 5U;
+        if (_op == OP_END) {
+          resetVarint();
+          _state = STATE_CRC;
+          return (byte == 0U);
+        }
+        _value = byte & TOKEN_LENGTH_MASK;
+        if (_op > OP_MATCH) {
+          return false;
+        }
+        if (_value < TOKEN_LENGTH_MASK) {
+          return startOp();
+        }
+        _state = STATE_LENGTH;
+        return true;
+
+      case STATE_LENGTH:
+        if (decodeVarint(byte)) {
+          _value += TOKEN_LENGTH_MASK;
+          return startOp();
+        }
+        return true;
+
+      case STATE_OFFSET:
+        if (decodeVarint(byte)) {
+          return (_op == OP_COPY) ? copyFromFlash() : copyFromImage();
+        }
+        return true;
+
+      case STATE_LITERAL:
+        _page[_page_pos++] = byte;
+        _remaining--;
+        if (_remaining == 0U) {
+          _state = STATE_OP;
+        }
+        return true;
+
+      case STATE_FILL:
+        for (uint32_t idx = 0U; idx < _remaining; idx++) {
+          _page[_page_pos++] = byte;
+        }
+        _state = STATE_OP;
+        return true;
+
+      case STATE_CRC:
+        _value |= static_cast<uint32_t>(byte) << _shift;
+        _shift += 8U;
+        if (_shift == 32U) {
+          return writePage();
+        }
+        return true;
+
+      default:
+        return false;
+    }
+  }
+
+  bool checkHeader() {
+    const uint32_t magic = readHeaderWord(0U);
+    const uint32_t page_size = readHeaderWord(1U);
+    _old_size = readHeaderWord(2U);
+    const uint32_t old_crc = readHeaderWord(3U);
+
+    _state = STATE_PAGE_ID;
+    return (magic == MAGIC) && (page_size == PAGE_SIZE) && (_old_size <= APP_SIZE) && ((_old_size % 4U) == 0U) &&
+           ((_old_size == 0U) || (franklyboot::hwi::calculateCRC(APP_START_ADDR, _old_size) == old_crc));
+  }
+
+  bool startPage() {
+    _page_id = _value;
+    _page_pos = 0U;
+    _state = STATE_OP;
+    return (_page_id >= APP_FIRST_PAGE) && (_page_id < NUM_PAGES) && !isPageWritten(_page_id);
+  }
+
+  bool startOp() {
+    _remaining = _value;
+    if ((_remaining == 0U) || (_remaining > (PAGE_SIZE - _page_pos))) {
+      return false;
+    }
+
+    if ((_op == OP_COPY) || (_op == OP_MATCH)) {
+      _state = STATE_OFFSET;
+    } else {
+      _state = (_op == OP_LITERAL) ? STATE_LITERAL : STATE_FILL;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Returns source address of a copy or match (offset is zigzag encoded and relative to the destination)
+   */
+  uint32_t getSourceAddress() const {
+    const int32_t offset = static_cast<int32_t>(_value >> 1U) ^ -static_cast<int32_t>(_value & 1U);
+    return FLASH_START_ADDR + _page_id * PAGE_SIZE + _page_pos + static_cast<uint32_t>(offset);
+  }
+
+  bool copyFromFlash() {
+    const uint32_t src_address = getSourceAddress();
+
+    // Source must be part of the old application and must not be overwritten already
+    if ((src_address < APP_START_ADDR) || ((src_address - APP_START_ADDR) > _old_size) ||
+        (_remaining > (_old_size - (src_address - APP_START_ADDR)))) {
+      return false;
+    }
+
+    const uint32_t first_page = (src_address - FLASH_START_ADDR) / PAGE_SIZE;
+    const uint32_t last_page = (src_address + _remaining - 1U - FLASH_START_ADDR) / PAGE_SIZE;
+    for (uint32_t page_id = first_page; page_id <= last_page; page_id++) {
+      if (isPageWritten(page_id)) {
+        return false;
+      }
+    }
+
+    for (uint32_t idx = 0U; idx < _remaining; idx++) {
+      _page[_page_pos++] = franklyboot::hwi::readByteFromFlash(src_address + idx);
+    }
+
+    _state = STATE_OP;
+    return true;
+  }
+
+  /**
+   * @brief Copies match of the new application
+   *
+   * Sources in the current page are read from the page buffer byte by byte, so overlapping matches
+   * repeat a pattern. Other sources must be in pages written by this patch.
+   */
+  bool copyFromImage() {
+    const uint32_t page_address = FLASH_START_ADDR + _page_id * PAGE_SIZE;
+    const uint32_t src_address = getSourceAddress();
+
+    for (uint32_t idx = 0U; idx < _remaining; idx++) {
+      const uint32_t address = src_address + idx;
+      const uint32_t src_pos = address - page_address;
+
+      if (src_pos < _page_pos) {
+        _page[_page_pos] = _page[src_pos];
+      } else if ((address >= FLASH_START_ADDR) && (address < (FLASH_START_ADDR + FLASH_SIZE)) &&
+                 isPageWritten((address - FLASH_START_ADDR) / PAGE_SIZE)) {
+        _page[_page_pos] = franklyboot::hwi::readByteFromFlash(address);
+      } else {
+        return false;
+      }
+      _page_pos++;
+    }
+
+    _state = STATE_OP;
+    return true;
+  }
+
+  bool writePage() {
+    const uint32_t page_crc = _value;
+    resetVarint();
+    _state = STATE_PAGE_ID;
+
+    const uint32_t page_address = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(_page));
+    if ((_page_pos != PAGE_SIZE) || (franklyboot::hwi::calculateCRC(page_address, PAGE_SIZE) != page_crc)) {
+      return false;
+    }
+
+    _page_written[_page_id / 32U] |= (1U << (_page_id % 32U));
+
+    const uint32_t dst_address = FLASH_START_ADDR + _page_id * PAGE_SIZE;
+    if (!franklyboot::hwi::eraseFlashPage(_page_id) ||
+        !franklyboot::hwi::writeDataBufferToFlash(dst_address, _page_id, _page, PAGE_SIZE)) {
+      return false;
+    }
+
+    _num_pages_written++;
+    return true;
+  }
+
+  /**
+   * @brief Decodes varint byte-wise
+   *
+   * @return true if the value is complete (the decoder is reset for the next value)
+   */
+  bool decodeVarint(const uint8_t byte) {
+    if (_shift == 0U) {
+      _value = 0U;
+    }
+    if (_shift < 32U) {
+      _value |= static_cast<uint32_t>(byte & 0x7FU) << _shift;
+    }
+    _shift += 7U;
+
+    const bool complete = ((byte & 0x80U) == 0U);
+    if (complete) {
+      _shift = 0U;
+    }
+    return complete;
+  }
+
+  void resetVarint() {
+    _value = 0U;
+    _shift = 0U;
+  }
+
+  uint32_t readHeaderWord(const uint32_t idx) const {
+    return static_cast<uint32_t>(_header[idx * 4U]) | (static_cast<uint32_t>(_header[idx * 4U + 1U]) << 8U) |
+           (static_cast<uint32_t>(_header[idx * 4U + 2U]) << 16U) |
+           (static_cast<uint32_t>(_header[idx * 4U + 3U]) << 24U);
+  }
+
+  bool isPageWritten(const uint32_t page_id) const {
+    return ((_page_written[page_id / 32U] >> (page_id % 32U)) & 1U) != 0U;
+  }
+
+  static constexpr uint32_t NUM_BITMAP_WORDS = {(NUM_PAGES + 31U) / 32U};
+  static constexpr uint32_t TOKEN_LENGTH_MASK = {0x1FU};
+
+  alignas(8) uint8_t _page[PAGE_SIZE];
+  uint8_t _header[HEADER_SIZE];
+  uint32_t _page_written[NUM_BITMAP_WORDS] = {};
+
+  State _state = {STATE_IDLE};
+  uint8_t _op = {OP_END};
+  uint32_t _patch_size = {0U};
+  uint32_t _num_received = {0U};
+  uint32_t _old_size = {0U};
+  uint32_t _page_id = {0U};
+  uint32_t _page_pos = {0U};
+  uint32_t _remaining = {0U};
+  uint32_t _value = {0U};
+  uint32_t _shift = {0U};
+
+  uint32_t _num_pages_written = {0U};
+  uint32_t _error_offset = {0U};
+};
+
+};  // namespace ext
+
+#endif /* PAGE_PATCH_H_ */
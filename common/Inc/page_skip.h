@@ -0,0 +1,213 @@
+/**
+ * @file page_skip.h
+ * @author agent (agent@local)
+ * @brief Skips erase and programming of flash pages which already hold the new data
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * The host erases a page right before the page buffer is written to it. The board defers the erase until
+ * the write request and compares the page buffer with the flash content first:
+ *
+ *  - Identical: erase and programming are skipped.
+ *  - Only bits are cleared and every programming unit is either equal, erased or programmed to zero:
+ *    the page is programmed without erase. The board skips programming units which are already equal.
+ *  - Otherwise the page is erased and programmed as requested.
+ *
+ * A deferred erase of a page which is not written next is executed before the flash is accessed otherwise.
+ * Erase and programming are only skipped for complete pages, so the result always matches the requests.
+ *
+ * REQ_EXT_FLASH_SKIP_STATS is answered with the number of skipped pages in data[0..1] and the number of
+ * pages programmed without erase in data[2..3] (LE). The request data is ignored.
+ *
+ * The class has no device dependencies, flash access is done by the board.
+ */
+
+#ifndef PAGE_SKIP_H_
+#define PAGE_SKIP_H_
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <francor/franklyboot/msg.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ext_msg.h"
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+namespace ext {
+
+/**
+ * Result of the comparison of new data with the flash content
+ */
+enum PageCompareResult : uint8_t {
+  PAGE_IDENTICAL = 0U,       //!< Flash holds the data already
+  PAGE_PROGRAM_ONLY = 1U,    //!< Data can be programmed without erase
+  PAGE_ERASE_REQUIRED = 2U,  //!< Flash must be erased before programming
+};
+
+/**
+ * @brief Compares new data with the flash content, 8 bytes per iteration (LDRD on Cortex-M4)
+ *
+ * @tparam PROGRAM_UNIT  Programming unit in bytes (2: half-word, 8: double word). A unit can only be
+ *                       programmed if it is erased or programmed to zero. 0 for NOR flash, which can clear
+ *                       any bit without erase.
+ * @param flash_ptr      Flash content (8 byte aligned)
+ * @param data_ptr       New data (4 byte aligned)
+ * @param num_bytes      Number of bytes (multiple of 8, otherwise the erase is always required)
+ */
+template <uint32_t PROGRAM_UNIT>
+inline PageCompareResult comparePage(const uint8_t* flash_ptr, const uint8_t* data_ptr, const uint32_t num_bytes) {
+  static_assert((PROGRAM_UNIT == 0U) || (PROGRAM_UNIT == 2U) || (PROGRAM_UNIT == 4U) || (PROGRAM_UNIT == 8U),
+                "PROGRAM_UNIT must be 0, 2, 4 or 8");
+
+  if ((num_bytes % 8U) != 0U) {
+    return PAGE_ERASE_REQUIRED;
+  }
+
+  PageCompareResult result = PAGE_IDENTICAL;
+  for (uint32_t offset = 0U; offset < num_bytes; offset += 8U) {
+    uint64_t flash_value = 0U;
+    uint64_t data_value = 0U;
+    memcpy(&flash_value, &flash_ptr[offset], sizeof(flash_value));
+    memcpy(&data_value, &data_ptr[offset], sizeof(data_value));
+
+    if (flash_value == data_value) {
+      continue;
+    }
+
+    if constexpr (PROGRAM_UNIT == 0U) {
+      if ((flash_value & data_value) != data_value) {
+        return PAGE_ERASE_REQUIRED;
+      }
+    } else {
+      constexpr uint32_t UNIT_BITS = PROGRAM_UNIT * 8U;
+      constexpr uint64_t UNIT_MASK = (UNIT_BITS == 64U) ? ~0ULL : ((1ULL << (UNIT_BITS % 64U)) - 1ULL);
+
+      for (uint32_t shift = 0U; shift < 64U; shift += UNIT_BITS) {
+        const uint64_t flash_unit = (flash_value >> shift) & UNIT_MASK;
+        const uint64_t data_unit = (data_value >> shift) & UNIT_MASK;
+        if ((flash_unit != data_unit) && (flash_unit != UNIT_MASK) && (data_unit != 0U)) {
+          return PAGE_ERASE_REQUIRED;
+        }
+      }
+    }
+
+    result = PAGE_PROGRAM_ONLY;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Deferred page erase and page skipping
+ *
+ * @tparam FLASH_START_ADDR  Address of flash page 0
+ * @tparam PAGE_SIZE         Size of a flash page in bytes
+ * @tparam PROGRAM_UNIT      Programming unit in bytes, see comparePage()
+ */
+template <uint32_t FLASH_START_ADDR, uint32_t PAGE_SIZE, uint32_t PROGRAM_UNIT>
+class PageSkip {
+ public:
+  static constexpr uint32_t NO_PAGE = {0xFFFFFFFFU};
+
+  /**
+   * Flash operations needed to write the page buffer
+   */
+  enum WriteAction : uint8_t {
+    WRITE_SKIP = 0U,           //!< Nothing to do
+    WRITE_PROGRAM = 1U,        //!< Program without erase
+    WRITE_ERASE_PROGRAM = 2U,  //!< Erase page and program
+  };
+
+  /**
+   * @brief Processes extension request for the skip statistics
+   *
+   * @return true if the request was a skip statistics request and the response is set
+   */
+  bool processRequest(const franklyboot::msg::Msg& request, franklyboot::msg::Msg& response) const {
+    if (!isRequest(request, REQ_EXT_FLASH_SKIP_STATS)) {
+      return false;
+    }
+
+    const uint32_t stats = (_num_skipped & 0xFFFFU) | ((_num_program_only & 0xFFFFU) << 16U);
+    response = createResponse(REQ_EXT_FLASH_SKIP_STATS, franklyboot::msg::RES_OK, request.packet_id, stats);
+    return true;
+  }
+
+  /**
+   * @brief Defers erase of the page until it is written
+   *
+   * @return Page whose deferred erase has to be executed now (NO_PAGE if none)
+   */
+  uint32_t deferErase(const uint32_t page_id) {
+    const uint32_t prev_page_id = (_erase_page_id != page_id) ? _erase_page_id : NO_PAGE;
+    _erase_page_id = page_id;
+    return prev_page_id;
+  }
+
+  /**
+   * @brief Takes deferred erase, which has to be executed before the flash is accessed
+   *
+   * @param write_page_id Page written next, its erase stays deferred
+   * @return Page to erase now (NO_PAGE if none)
+   */
+  uint32_t takeDeferredErase(const uint32_t write_page_id = NO_PAGE) {
+    if (_erase_page_id == write_page_id) {
+      return NO_PAGE;
+    }
+
+    const uint32_t page_id = _erase_page_id;
+    _erase_page_id = NO_PAGE;
+    return page_id;
+  }
+
+  /**
+   * @brief Decides which flash operations are needed to write the data (deferred erase of other pages
+   *        must be taken before and the flash must be idle)
+   */
+  WriteAction prepareWrite(const uint32_t page_id, const uint32_t dst_address, const uint8_t* data_ptr,
+                           const uint32_t num_bytes) {
+    const bool erase_requested = (_erase_page_id == page_id);
+    const bool complete_page = (dst_address == (FLASH_START_ADDR + page_id * PAGE_SIZE)) && (num_bytes == PAGE_SIZE);
+    _erase_page_id = NO_PAGE;
+
+    if (erase_requested && !complete_page) {
+      _num_erased++;
+      return WRITE_ERASE_PROGRAM;
+    }
+
+    switch (comparePage<PROGRAM_UNIT>(reinterpret_cast<const uint8_t*>(dst_address), data_ptr, num_bytes)) {
+      case PAGE_IDENTICAL:
+        _num_skipped++;
+        return WRITE_SKIP;
+
+      case PAGE_PROGRAM_ONLY:
+        if (erase_requested) {
+          _num_program_only++;
+        }
+        return WRITE_PROGRAM;
+
+      default:
+        if (erase_requested) {
+          _num_erased++;
+          return WRITE_ERASE_PROGRAM;
+        }
+        return WRITE_PROGRAM;
+    }
+  }
+
+ private:
+  uint32_t _erase_page_id = {NO_PAGE};
+
+  uint32_t _num_skipped = {0U};
+  uint32_t _num_program_only = {0U};
+
+  // Diagnostic counter (read via debugger)
+  uint32_t _num_erased = {0U};
+};
+
+};  // namespace ext
+
+#endif /* PAGE_SKIP_H_ */
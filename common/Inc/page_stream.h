@@ -0,0 +1,175 @@
+/**
+ * @file page_stream.h
+ * @author agent (agent@local)
+ * @brief Bulk page streaming into the page buffer of the bootloader handler
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * Protocol:
+ *  1. Host sends REQ_EXT_PAGE_STREAM with the number of bytes (multiple of 8, max. one page).
+ *     The device clears the page buffer and acknowledges with RES_OK.
+ *  2. Host sends the page bytes raw in blocks of 8 bytes, followed by one trailer block. The first
+ *     4 bytes of the trailer are the CRC the device reports for the page buffer
+ *     (REQ_PAGE_BUFFER_CALC_CRC), the other bytes are ignored.
+ *  3. Device acknowledges the page once with REQ_EXT_PAGE_STREAM, RES_OK if the CRC matches and
+ *     RES_ERR otherwise. The calculated CRC is returned in the data field.
+ *  4. Host writes the page buffer to flash with the normal requests.
+ *
+ * Every block is fed into the handler as local REQ_PAGE_BUFFER_WRITE_WORD requests, so no additional
+ * page sized buffer is needed. The stream is aborted if no block is received within the timeout.
+ *
+ * Transports carrying several blocks per frame (CAN-FD) take only the pending blocks (getPendingBlocks())
+ * from a frame. The rest of the frame after the trailer, e.g. the padding to the next valid CAN-FD length,
+ * is discarded. The blocks start with a new frame and requests following the trailer start with a new frame.
+ */
+
+#ifndef PAGE_STREAM_H_
+#define PAGE_STREAM_H_
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <francor/franklyboot/msg.h>
+#include <stdint.h>
+
+#include "ext_msg.h"
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+namespace ext {
+
+/**
+ * @brief Bulk page stream state machine
+ *
+ * @tparam HandlerType  Type of the bootloader handler
+ * @tparam PAGE_SIZE    Maximum number of bytes of a stream
+ */
+template <typename HandlerType, uint32_t PAGE_SIZE>
+class PageStream {
+ public:
+  static constexpr uint32_t BLOCK_SIZE = {8U};
+
+  explicit PageStream(HandlerType& handler) : _handler(handler) {}
+
+  /**
+   * @brief Returns true if raw page blocks are expected instead of requests
+   */
+  bool isActive() const { return _active; }
+
+  /**
+   * @brief Returns number of raw blocks still expected including the trailer (0 if no stream is open)
+   */
+  uint32_t getPendingBlocks() const { return _active ? (_num_blocks - _block_idx + 1U) : 0U; }
+
+  /**
+   * @brief Processes extension request to open a page stream
+   *
+   * @return true if the request was a stream request and the response is set
+   */
+  bool processRequest(const franklyboot::msg::Msg& request, franklyboot::msg::Msg& response) {
+    if (!isRequest(request, REQ_EXT_PAGE_STREAM)) {
+      return false;
+    }
+
+    const uint32_t num_bytes = getDataWord(request);
+    const bool num_bytes_valid = (num_bytes > 0U) && (num_bytes <= PAGE_SIZE) && ((num_bytes % BLOCK_SIZE) == 0U);
+
+    franklyboot::msg::ResultType result = franklyboot::msg::RES_ERR;
+    if (num_bytes_valid && processLocal(franklyboot::msg::REQ_PAGE_BUFFER_CLEAR, nullptr)) {
+      _active = true;
+      _write_error = false;
+      _num_blocks = num_bytes / BLOCK_SIZE;
+      _block_idx = 0U;
+      _idle_cnt = 0U;
+      _packet_id = request.packet_id;
+      result = franklyboot::msg::RES_OK;
+    }
+
+    response = createResponse(REQ_EXT_PAGE_STREAM, result, request.packet_id, num_bytes);
+    return true;
+  }
+
+  /**
+   * @brief Feeds next raw block of the stream
+   *
+   * @return true if the trailer was received and the response is set
+   */
+  bool feed(const uint8_t* block, franklyboot::msg::Msg& response) {
+    _idle_cnt = 0U;
+
+    if (_block_idx < _num_blocks) {
+      _write_error |= !processLocal(franklyboot::msg::REQ_PAGE_BUFFER_WRITE_WORD, &block[0U]);
+      _write_error |= !processLocal(franklyboot::msg::REQ_PAGE_BUFFER_WRITE_WORD, &block[4U]);
+      _block_idx++;
+      return false;
+    }
+
+    // Trailer block: compare CRC of page buffer
+    franklyboot::msg::Msg crc_response;
+    const bool crc_valid = processLocal(franklyboot::msg::REQ_PAGE_BUFFER_CALC_CRC, nullptr, &crc_response);
+    const uint32_t crc_calc = getDataWord(crc_response);
+    const uint32_t crc_host = static_cast<uint32_t>(block[0U]) | (static_cast<uint32_t>(block[1U]) << 8U) |
+                              (static_cast<uint32_t>(block[2U]) << 16U) | (static_cast<uint32_t>(block[3U]) << 24U);
+
+    const bool success = !_write_error && crc_valid && (crc_calc == crc_host);
+    response = createResponse(REQ_EXT_PAGE_STREAM, success ? franklyboot::msg::RES_OK : franklyboot::msg::RES_ERR,
+                              _packet_id, crc_calc);
+    _active = false;
+    return true;
+  }
+
+  /**
+   * @brief Aborts the stream, following data is handled as requests again
+   */
+  void abort() { _active = false; }
+
+  /**
+   * @brief Called while waiting for data, aborts the stream after the given number of idle calls
+   */
+  void checkTimeout(const uint32_t timeout_cnt) {
+    if (_active) {
+      _idle_cnt++;
+      if (_idle_cnt >= timeout_cnt) {
+        abort();
+      }
+    }
+  }
+
+ private:
+  /**
+   * @brief Processes request in the handler without transmitting the response
+   *
+   * @return true if the handler returned RES_OK
+   */
+  bool processLocal(const franklyboot::msg::RequestType type, const uint8_t* data,
+                    franklyboot::msg::Msg* response_ptr = nullptr) {
+    franklyboot::msg::Msg request;
+    request.request = type;
+    request.result = franklyboot::msg::RES_NONE;
+    request.packet_id = 0U;
+    for (uint32_t idx = 0U; idx < request.data.size(); idx++) {
+      request.data[idx] = (data != nullptr) ? data[idx] : 0U;
+    }
+
+    _handler.processRequest(request);
+    const auto response = _handler.getResponse();
+    if (response_ptr != nullptr) {
+      *response_ptr = response;
+    }
+
+    return (response.result == franklyboot::msg::RES_OK);
+  }
+
+  HandlerType& _handler;
+
+  bool _active = {false};
+  bool _write_error = {false};
+  uint32_t _num_blocks = {0U};
+  uint32_t _block_idx = {0U};
+  uint32_t _idle_cnt = {0U};
+  uint8_t _packet_id = {0U};
+};
+
+};  // namespace ext
+
+#endif /* PAGE_STREAM_H_ */
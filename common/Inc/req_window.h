@@ -0,0 +1,173 @@
+/**
+ * @file req_window.h
+ * @author agent (agent@local)
+ * @brief Sliding window of outstanding requests sequenced by packet_id
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * Without window every request is answered before the host sends the next one, so the round trip time
+ * limits the throughput. In windowed mode the host keeps up to the granted number of requests in flight:
+ *
+ *  - REQ_EXT_WINDOW_OPEN: data[0] is the requested window size (0 closes the window). The device answers
+ *    with the granted window size (credits) in data[0]. The packet_id of the open request is the sequence
+ *    number preceding the first windowed request.
+ *  - Windowed requests use packet_id as sequence number (mod 256) and are processed strictly in order.
+ *    Requests received ahead of a missing one are buffered. Every request is answered with its own
+ *    packet_id, so responses are cumulative acknowledges.
+ *  - REQ_EXT_WINDOW_STATUS: answered with packet_id = next expected sequence number, data[0] = free
+ *    credits and data[1..3] = bitmap of buffered requests following the expected one (bit 0 = expected + 1).
+ *    The device sends it unsolicited as soon as a gap is detected, so the host retransmits exactly the
+ *    missing requests. The host polls it if it does not get responses anymore.
+ *  - Retransmitted requests which are already processed are not processed again. Their response is sent
+ *    again from the response cache (lost response).
+ *  - A page stream open request must be the last outstanding request, the raw blocks are not sequenced.
+ */
+
+#ifndef REQ_WINDOW_H_
+#define REQ_WINDOW_H_
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <francor/franklyboot/msg.h>
+#include <stdint.h>
+
+#include "ext_msg.h"
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+namespace ext {
+
+/**
+ * @brief Request window with reorder buffer and response cache
+ *
+ * @tparam MAX_WINDOW Maximum number of outstanding requests the device grants (limited by RX buffer size)
+ */
+template <uint32_t MAX_WINDOW>
+class RequestWindow {
+ public:
+  static_assert((MAX_WINDOW > 0U) && (MAX_WINDOW <= 16U), "MAX_WINDOW must be in range 1 - 16");
+  static_assert((MAX_WINDOW & (MAX_WINDOW - 1U)) == 0U, "MAX_WINDOW must be a power of two");
+
+  /**
+   * @brief Returns true if requests are sequenced
+   */
+  bool isActive() const { return (_window_size != 0U); }
+
+  /**
+   * @brief Processes request in windowed mode or window extension request
+   *
+   * @param request   Received request
+   * @param process   Function processing a request in order and returning the response
+   * @param transmit  Function transmitting a response
+   * @return false if the request was not handled (window closed and no window request)
+   */
+  template <typename ProcessFn, typename TransmitFn>
+  bool processRequest(const franklyboot::msg::Msg& request, ProcessFn&& process, TransmitFn&& transmit) {
+    if (isRequest(request, REQ_EXT_WINDOW_OPEN)) {
+      open(request);
+      transmit(createResponse(REQ_EXT_WINDOW_OPEN, franklyboot::msg::RES_OK, request.packet_id, _window_size));
+      return true;
+    }
+
+    if (isRequest(request, REQ_EXT_WINDOW_STATUS)) {
+      transmit(createStatus());
+      return true;
+    }
+
+    if (!isActive()) {
+      return false;
+    }
+
+    const uint8_t seq_offset = static_cast<uint8_t>(request.packet_id - _expected_seq);
+
+    if (seq_offset == 0U) {
+      // Next request in order: process it and all directly following buffered requests
+      processInOrder(request, process, transmit);
+      while (_pending_valid[_expected_seq % MAX_WINDOW]) {
+        _pending_valid[_expected_seq % MAX_WINDOW] = false;
+        _num_pending--;
+        processInOrder(_pending[_expected_seq % MAX_WINDOW], process, transmit);
+      }
+    } else if (seq_offset < _window_size) {
+      // Request ahead of a missing one: buffer it and report the gap once
+      const uint32_t slot = request.packet_id % MAX_WINDOW;
+      if (!_pending_valid[slot]) {
+        _pending[slot] = request;
+        _pending_valid[slot] = true;
+        _num_pending++;
+        _num_reordered++;
+
+        if (_num_pending == 1U) {
+          transmit(createStatus());
+        }
+      }
+    } else if (seq_offset >= (256U - _window_size)) {
+      // Retransmission of a processed request: resend cached response
+      const uint32_t slot = request.packet_id % MAX_WINDOW;
+      if (_response_valid[slot] && (_responses[slot].packet_id == request.packet_id)) {
+        transmit(_responses[slot]);
+        _num_duplicates++;
+      }
+    } else {
+      // Outside of window
+      transmit(createStatus());
+    }
+
+    return true;
+  }
+
+ private:
+  void open(const franklyboot::msg::Msg& request) {
+    const uint32_t requested = request.data[0U];
+    _window_size = (requested < MAX_WINDOW) ? requested : MAX_WINDOW;
+    _expected_seq = static_cast<uint8_t>(request.packet_id + 1U);
+    _num_pending = 0U;
+
+    for (uint32_t idx = 0U; idx < MAX_WINDOW; idx++) {
+      _pending_valid[idx] = false;
+      _response_valid[idx] = false;
+    }
+  }
+
+  template <typename ProcessFn, typename TransmitFn>
+  void processInOrder(const franklyboot::msg::Msg& request, ProcessFn&& process, TransmitFn&& transmit) {
+    const uint32_t slot = request.packet_id % MAX_WINDOW;
+
+    _responses[slot] = process(request);
+    _responses[slot].packet_id = request.packet_id;
+    _response_valid[slot] = true;
+    _expected_seq++;
+
+    transmit(_responses[slot]);
+  }
+
+  franklyboot::msg::Msg createStatus() const {
+    uint32_t bitmap = 0U;
+    for (uint32_t idx = 0U; (idx + 1U) < _window_size; idx++) {
+      if (_pending_valid[(_expected_seq + idx + 1U) % MAX_WINDOW]) {
+        bitmap |= (1U << idx);
+      }
+    }
+
+    const uint32_t credits = _window_size - _num_pending;
+    return createResponse(REQ_EXT_WINDOW_STATUS, franklyboot::msg::RES_OK, _expected_seq, credits | (bitmap << 8U));
+  }
+
+  uint32_t _window_size = {0U};
+  uint8_t _expected_seq = {0U};
+  uint32_t _num_pending = {0U};
+
+  franklyboot::msg::Msg _pending[MAX_WINDOW];
+  bool _pending_valid[MAX_WINDOW] = {};
+  franklyboot::msg::Msg _responses[MAX_WINDOW];
+  bool _response_valid[MAX_WINDOW] = {};
+
+  // Diagnostic counters (read via debugger)
+  uint32_t _num_reordered = {0U};
+  uint32_t _num_duplicates = {0U};
+};
+
+};  // namespace ext
+
+#endif /* REQ_WINDOW_H_ */
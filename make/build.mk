@@ -63,6 +63,18 @@ size:
 	@$(SIZE) $(BUILD_DIR)/$(PROJECT_NAME).elf
 	@echo "--------------------------------------------------------------------"
 
+# Fails if text and data of the image exceed the flash area of the bootloader (FLASH_LIMIT in bytes) or if data,
+# bss and the heap and stack reserve (._user_heap_stack, counted as bss) exceed the RAM (RAM_LIMIT in bytes)
+.PHONY: size-check
+size-check:
+	@$(SIZE) $(BUILD_DIR)/$(PROJECT_NAME).elf | awk -v limit=$(FLASH_LIMIT) -v ram_limit=$(RAM_LIMIT) 'NR == 2 { \
+		used = $$1 + $$2; \
+		ram_used = $$2 + $$3; \
+		printf "$(PROJECT_NAME): %d of %d bytes flash used, %d free\n", used, limit, limit - used; \
+		if (ram_limit != "") \
+			printf "$(PROJECT_NAME): %d of %d bytes RAM used, %d free\n", ram_used, ram_limit, ram_limit - ram_used; \
+		exit ((limit != "" && used > limit) || (ram_limit != "" && ram_used > ram_limit)) }'
+
 .PHONY: objcopy
 objcopy:
 	@echo ""
@@ -0,0 +1,20 @@
+# Build Options of the Extensions ---------------------------------------------
+#
+# 1: extension included (default), 0: excluded from the image, e.g.
+#   make EXT_PAGE_PATCH=0 EXT_FRAME_MODE=0
+# A board Makefile changes the default of an extension by setting it before including this file.
+#
+# Excluded extension requests are answered as unknown by the bootloader handler.
+# Run make clean after changing an option (objects do not depend on the defines).
+
+EXT_PAGE_STREAM ?= 1
+EXT_REQ_WINDOW  ?= 1
+EXT_PAGE_PATCH  ?= 1
+EXT_BAUD_SWITCH ?= 1
+EXT_FRAME_MODE  ?= 1
+
+DEFINES += FRANKLYBOOT_EXT_PAGE_STREAM=$(EXT_PAGE_STREAM)
+DEFINES += FRANKLYBOOT_EXT_REQ_WINDOW=$(EXT_REQ_WINDOW)
+DEFINES += FRANKLYBOOT_EXT_PAGE_PATCH=$(EXT_PAGE_PATCH)
+DEFINES += FRANKLYBOOT_EXT_BAUD_SWITCH=$(EXT_BAUD_SWITCH)
+DEFINES += FRANKLYBOOT_EXT_FRAME_MODE=$(EXT_FRAME_MODE)
@@ -0,0 +1,83 @@
+/**
+ * @file bench_crc32.cpp
+ * @author agent (agent@local)
+ * @brief Throughput of byte-wise table lookup vs. slicing-by-8 CRC-32
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * Both variants use the tables of crc32.h. The ratio between them is the interesting number, the host
+ * throughput itself does not predict the Cortex-M throughput (no data cache, flash wait states).
+ *
+ * Usage: bench_crc32 [num_mbytes]
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "crc32.h"
+
+// Benchmark ----------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Classic byte-wise CRC-32 (table[0] only)
+ */
+static uint32_t updateBytewise(uint32_t crc, const uint8_t* data, uint32_t num_bytes) {
+  while (num_bytes > 0U) {
+    crc = (crc >> 8U) ^ crc::TABLES.table[0U][(crc ^ *data) & 0xFFU];
+    data++;
+    num_bytes--;
+  }
+  return crc;
+}
+
+template <typename UpdateFn>
+static double measure(UpdateFn&& update, const std::vector<uint8_t>& data, const uint32_t block_size,
+                      const uint32_t total_bytes, uint32_t& result) {
+  const uint32_t num_blocks = total_bytes / block_size;
+  uint32_t crc = 0U;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t block_idx = 0U; block_idx < num_blocks; block_idx++) {
+    const uint32_t offset = (block_idx * block_size) % (data.size() - block_size + 1U);
+    crc ^= ~update(crc::INIT_VALUE, &data[offset], block_size);
+  }
+  const double time_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  result = crc;
+  return (static_cast<double>(num_blocks) * block_size) / time_s / 1.0e6;
+}
+
+// Main ---------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv) {
+  const uint32_t num_mbytes = (argc > 1) ? std::strtoul(argv[1], nullptr, 0) : 64U;
+  const uint32_t total_bytes = num_mbytes * 1024U * 1024U;
+
+  std::vector<uint8_t> data(256U * 1024U);
+  for (uint32_t idx = 0U; idx < data.size(); idx++) {
+    data[idx] = static_cast<uint8_t>(idx * 2654435761U >> 24U);
+  }
+
+  bool valid = true;
+
+  std::printf("%u MiB per measurement\n\n", num_mbytes);
+  std::printf("%8s %14s %14s %8s\n", "block", "byte [MB/s]", "slice8 [MB/s]", "speedup");
+
+  for (const uint32_t block_size : {16U, 64U, 256U, 2048U, 65536U}) {
+    uint32_t result_bytewise = 0U;
+    uint32_t result_slicing = 0U;
+    const double bytewise = measure(updateBytewise, data, block_size, total_bytes, result_bytewise);
+    const double slicing = measure(crc::update, data, block_size, total_bytes, result_slicing);
+
+    std::printf("%8u %14.1f %14.1f %7.2fx%s\n", block_size, bytewise, slicing, slicing / bytewise,
+                (result_bytewise == result_slicing) ? "" : "  MISMATCH");
+    valid = valid && (result_bytewise == result_slicing);
+  }
+
+  return valid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
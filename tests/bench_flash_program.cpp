@@ -0,0 +1,155 @@
+/**
+ * @file bench_flash_program.cpp
+ * @author agent (agent@local)
+ * @brief Timing model of the asynchronous flash programming of the L431 with CAN reception
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * Cycle stepped model of one 2 KB page write (flash job) while the host keeps sending CAN frames:
+ *
+ *  - Flash: double words take T_PROG_DW, rows of 32 double words in fast programming mode T_PROG_ROW
+ *    (typical values of the STM32L431 datasheet). Interrupts are masked while a row is programmed.
+ *  - CAN: frames arrive in the RX FIFO (3 frames), the RX ISR moves them into the RAM ring buffer
+ *    unless interrupts are masked. A frame arriving at a full FIFO is lost.
+ *  - Main loop: starts the next programming step when the flash is idle (flashPoll()), then processes
+ *    one received frame. Code is fetched from flash, so it stalls while the flash is busy.
+ *  - Host: either waits for the response of every request, or streams frames back to back (request
+ *    window, broadcast update).
+ *
+ * The policies are double words only, rows whenever possible and rows only while the host waits and the
+ * RX ring is empty (firmware default). Lost frames must be zero for the firmware default.
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <initializer_list>
+
+// Model --------------------------------------------------------------------------------------------------------------
+
+constexpr double CPU_CLK_MHZ = {80.0};
+constexpr uint32_t us(const double time_us) { return static_cast<uint32_t>(time_us * CPU_CLK_MHZ); }
+
+constexpr uint32_t PAGE_SIZE = {2048U};
+constexpr uint32_t ROW_SIZE = {256U};
+constexpr uint32_t T_PROG_DW = {us(81.7)};    // Double word programming time (typ.)
+constexpr uint32_t T_PROG_ROW = {us(1910)};   // Row programming time in fast programming mode (typ.)
+constexpr uint32_t T_POLL = {us(2.0)};        // Main loop iteration up to the start of the next step
+constexpr uint32_t T_PROCESS = {us(15.0)};    // Processing of one request in the main loop
+constexpr uint32_t T_FRAME = {us(250.0)};     // 8 byte CAN frame at 500 kbit/s (incl. stuff bits)
+constexpr uint32_t RX_FIFO_SIZE = {3U};
+
+enum Policy { DOUBLE_WORDS, ROWS_ALWAYS, ROWS_GATED };
+enum HostMode { HOST_WAITING, HOST_STREAMING };
+
+struct Result {
+  double page_time_us;
+  uint32_t num_rows;
+  uint32_t num_double_words;
+  uint32_t num_lost_frames;
+  uint32_t num_processed;
+};
+
+static Result simulate(const Policy policy, const HostMode host_mode) {
+  Result result = {};
+
+  uint32_t programmed = 0U;
+  uint32_t flash_busy_until = 0U;
+  uint32_t irq_masked_until = 0U;
+  uint32_t main_busy_until = 0U;
+  uint32_t rx_fifo = 0U;
+  uint32_t rx_ring = 0U;
+  uint32_t next_frame = T_FRAME;
+  bool request_outstanding = true;
+  bool process_turn = false;
+
+  uint32_t cycle = 0U;
+  for (; programmed < PAGE_SIZE || cycle < flash_busy_until; cycle++) {
+    // Host and bus: a waiting host sends the next request after the response to the previous one
+    if (cycle == next_frame) {
+      if (rx_fifo < RX_FIFO_SIZE) {
+        rx_fifo++;
+      } else {
+        result.num_lost_frames++;
+      }
+      next_frame = (host_mode == HOST_STREAMING) ? (cycle + T_FRAME) : 0U;
+      request_outstanding = true;
+    }
+
+    // RX ISR
+    if ((cycle >= irq_masked_until) && (rx_fifo > 0U)) {
+      rx_ring += rx_fifo;
+      rx_fifo = 0U;
+    }
+
+    // Main loop (stalled while the flash is busy)
+    if ((cycle < flash_busy_until) || (cycle < main_busy_until)) {
+      continue;
+    }
+
+    // Iterations alternate between flashPoll() and processing of one received frame
+    if ((programmed < PAGE_SIZE) && !process_turn) {
+      process_turn = true;
+      const bool row_possible = ((programmed % ROW_SIZE) == 0U) && ((PAGE_SIZE - programmed) >= ROW_SIZE);
+      const bool row_allowed = (policy == ROWS_ALWAYS) ||
+                               ((policy == ROWS_GATED) && (host_mode == HOST_WAITING) && (rx_ring == 0U));
+
+      if (row_possible && row_allowed) {
+        flash_busy_until = cycle + T_POLL + T_PROG_ROW;
+        irq_masked_until = flash_busy_until;
+        programmed += ROW_SIZE;
+        result.num_rows++;
+      } else {
+        flash_busy_until = cycle + T_POLL + T_PROG_DW;
+        programmed += 8U;
+        result.num_double_words++;
+      }
+      continue;
+    }
+
+    process_turn = false;
+    if (rx_ring > 0U) {
+      rx_ring--;
+      result.num_processed++;
+      main_busy_until = cycle + T_PROCESS;
+      if ((host_mode == HOST_WAITING) && request_outstanding) {
+        // Response and next request on the bus
+        request_outstanding = false;
+        next_frame = main_busy_until + 2U * T_FRAME;
+      }
+    }
+  }
+
+  result.page_time_us = cycle / CPU_CLK_MHZ;
+  return result;
+}
+
+// Main ---------------------------------------------------------------------------------------------------------------
+
+int main() {
+  const char* policy_names[] = {"double words", "rows always", "rows gated"};
+  const char* host_names[] = {"waiting", "streaming"};
+  bool valid = true;
+
+  std::printf("2 KB page at %.0f MHz, DW %.1f us, row %.0f us, CAN frame %.0f us\n\n", CPU_CLK_MHZ,
+              T_PROG_DW / CPU_CLK_MHZ, T_PROG_ROW / CPU_CLK_MHZ, T_FRAME / CPU_CLK_MHZ);
+  std::printf("%-10s %-13s %10s %6s %6s %6s\n", "host", "policy", "page [ms]", "rows", "dw", "lost");
+
+  for (const HostMode host_mode : {HOST_WAITING, HOST_STREAMING}) {
+    for (const Policy policy : {DOUBLE_WORDS, ROWS_ALWAYS, ROWS_GATED}) {
+      const Result result = simulate(policy, host_mode);
+      std::printf("%-10s %-13s %10.2f %6u %6u %6u\n", host_names[host_mode], policy_names[policy],
+                  result.page_time_us / 1000.0, result.num_rows, result.num_double_words, result.num_lost_frames);
+
+      // Firmware default must never lose frames
+      if ((policy == ROWS_GATED) && (result.num_lost_frames != 0U)) {
+        valid = false;
+      }
+    }
+  }
+
+  return valid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,182 @@
+/**
+ * @file bench_frame_codec_ber.cpp
+ * @author agent (agent@local)
+ * @brief Delivery rate and goodput of the framed serial mode with random bit errors on the line
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * Random 8 byte messages are sent back to back in framed mode, independent bit errors with the given bit error
+ * rate (BER) are injected into the byte stream and the stream is decoded by a second codec. Delivered messages
+ * are matched against the sent ones:
+ *
+ *  - delivered:  messages received unchanged (frames with a bit error are dropped)
+ *  - goodput:    payload bytes delivered per byte on the line
+ *  - undetected: corrupt messages accepted by the CRC-8
+ *
+ * Raw mode is listed for comparison: it has no framing overhead, but every message with a bit error is processed.
+ * The benchmark fails if framed mode does not deliver all messages unchanged without bit errors.
+ *
+ * Usage: bench_frame_codec_ber [num_msgs]
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "frame_codec.h"
+
+using namespace franklyboot;
+
+// Simulation ---------------------------------------------------------------------------------------------------------
+
+constexpr uint32_t MSG_SIZE = {8U};
+constexpr uint32_t MATCH_WINDOW = {32U};  // Sent messages searched for a delivered one (lost frames in between)
+
+using Codec = ext::FrameCodec<MSG_SIZE>;
+
+struct Result {
+  uint32_t num_delivered;
+  uint32_t num_undetected;
+  uint32_t num_line_bytes;
+};
+
+/**
+ * @brief Switches codec to framed mode like the boards (request, response encoded in the previous mode)
+ */
+static void enableFramedMode(Codec& codec) {
+  const msg::Msg request = ext::createResponse(ext::REQ_EXT_FRAME_MODE, msg::RES_NONE, 0U, 1U);
+  msg::Msg response = {};
+  codec.processRequest(request, response);
+
+  uint8_t msg[MSG_SIZE] = {};
+  uint8_t frame[Codec::FRAME_SIZE] = {};
+  msg[0U] = static_cast<uint8_t>(response.request);
+  msg[1U] = static_cast<uint8_t>(response.request >> 8U);
+  codec.encode(msg, frame);
+}
+
+/**
+ * @brief Flips independent bits of the stream with the given probability
+ */
+static void injectBitErrors(std::vector<uint8_t>& stream, const double ber, std::mt19937& rng) {
+  if (ber <= 0.0) {
+    return;
+  }
+
+  // Distance to the next bit error
+  std::geometric_distribution<uint64_t> next_error(ber);
+  const uint64_t num_bits = stream.size() * 8U;
+  for (uint64_t bit = next_error(rng); bit < num_bits; bit += next_error(rng) + 1U) {
+    stream[bit / 8U] ^= static_cast<uint8_t>(1U << (bit % 8U));
+  }
+}
+
+/**
+ * @brief Matches delivered messages in order against the sent ones
+ */
+static void matchMessages(const std::vector<uint8_t>& sent, const std::vector<uint8_t>& delivered, Result& result) {
+  const uint32_t num_sent = static_cast<uint32_t>(sent.size() / MSG_SIZE);
+  uint32_t next = 0U;
+
+  for (uint32_t idx = 0U; idx < (delivered.size() / MSG_SIZE); idx++) {
+    const uint8_t* msg = &delivered[idx * MSG_SIZE];
+    bool found = false;
+    for (uint32_t candidate = next; (candidate < num_sent) && (candidate < (next + MATCH_WINDOW)); candidate++) {
+      if (memcmp(msg, &sent[candidate * MSG_SIZE], MSG_SIZE) == 0) {
+        next = candidate + 1U;
+        found = true;
+        break;
+      }
+    }
+
+    if (found) {
+      result.num_delivered++;
+    } else {
+      result.num_undetected++;
+    }
+  }
+}
+
+static Result runFramed(const std::vector<uint8_t>& sent, const double ber, std::mt19937& rng) {
+  Codec tx_codec;
+  Codec rx_codec;
+  enableFramedMode(tx_codec);
+  enableFramedMode(rx_codec);
+
+  std::vector<uint8_t> stream;
+  uint8_t frame[Codec::FRAME_SIZE] = {};
+  for (uint32_t idx = 0U; idx < (sent.size() / MSG_SIZE); idx++) {
+    const uint32_t num_bytes = tx_codec.encode(&sent[idx * MSG_SIZE], frame);
+    stream.insert(stream.end(), frame, frame + num_bytes);
+  }
+  injectBitErrors(stream, ber, rng);
+
+  std::vector<uint8_t> delivered;
+  uint8_t msg[MSG_SIZE] = {};
+  for (const uint8_t byte : stream) {
+    if (rx_codec.decode(byte, msg)) {
+      delivered.insert(delivered.end(), msg, msg + MSG_SIZE);
+    }
+  }
+
+  Result result = {0U, 0U, static_cast<uint32_t>(stream.size())};
+  matchMessages(sent, delivered, result);
+  return result;
+}
+
+static Result runRaw(const std::vector<uint8_t>& sent, const double ber, std::mt19937& rng) {
+  std::vector<uint8_t> stream = sent;
+  injectBitErrors(stream, ber, rng);
+
+  Result result = {0U, 0U, static_cast<uint32_t>(stream.size())};
+  for (uint32_t idx = 0U; idx < (sent.size() / MSG_SIZE); idx++) {
+    if (memcmp(&stream[idx * MSG_SIZE], &sent[idx * MSG_SIZE], MSG_SIZE) == 0) {
+      result.num_delivered++;
+    } else {
+      result.num_undetected++;
+    }
+  }
+  return result;
+}
+
+// Main ---------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv) {
+  const uint32_t num_msgs = (argc > 1) ? std::strtoul(argv[1], nullptr, 0) : 100000U;
+
+  std::mt19937 rng(1234U);
+  std::uniform_int_distribution<uint32_t> random_byte(0U, 0xFFU);
+  std::vector<uint8_t> sent(num_msgs * MSG_SIZE);
+  for (uint8_t& byte : sent) {
+    byte = static_cast<uint8_t>(random_byte(rng));
+  }
+
+  bool valid = true;
+
+  std::printf("%u messages of %u bytes, framed mode %u bytes per frame\n\n", num_msgs, MSG_SIZE, Codec::FRAME_SIZE);
+  std::printf("%8s %6s %11s %9s %11s\n", "BER", "mode", "delivered", "goodput", "undetected");
+
+  for (const double ber : {0.0, 1.0e-5, 1.0e-4, 1.0e-3, 1.0e-2}) {
+    const Result framed = runFramed(sent, ber, rng);
+    const Result raw = runRaw(sent, ber, rng);
+
+    for (const auto& [name, result] : {std::make_pair("framed", framed), std::make_pair("raw", raw)}) {
+      std::printf("%8.0e %6s %10.2f%% %9.3f %11u\n", ber, name, 100.0 * result.num_delivered / num_msgs,
+                  static_cast<double>(result.num_delivered * MSG_SIZE) / result.num_line_bytes,
+                  result.num_undetected);
+    }
+
+    if ((ber == 0.0) && ((framed.num_delivered != num_msgs) || (framed.num_undetected != 0U))) {
+      valid = false;
+    }
+  }
+
+  return valid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
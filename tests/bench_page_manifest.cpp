@@ -0,0 +1,105 @@
+/**
+ * @file bench_page_manifest.cpp
+ * @author agent (agent@local)
+ * @brief Boot validation time vs. image size: full application hash vs. page manifest
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * For every image size the simulator validates the application by hashing all of it and with the page
+ * manifest (manifest CRC, combine of all page CRCs, hash of the sampled pages). It counts the hashed bytes
+ * and CRC combine operations and converts them into the validation time of the device with a simple cost
+ * model. The host time of both variants is printed as well.
+ *
+ * Usage: bench_page_manifest [hash_mbytes_per_s] [combine_us]
+ *   hash_mbytes_per_s  Flash read and CRC throughput of the device (RP2040 DMA sniffer from XIP: 20)
+ *   combine_us         Time of one crc::combine() on the device (Cortex-M0+ at 125 MHz: 2)
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "page_manifest.h"
+
+// Benchmark ----------------------------------------------------------------------------------------------------------
+
+constexpr uint32_t APP_START_ADDR = {0x10000000U};
+constexpr uint32_t PAGE_SIZE = {4096U};
+constexpr uint32_t NUM_SAMPLES = {8U};
+
+struct CostModel {
+  double hash_bytes_per_us;
+  double combine_us;
+};
+
+/**
+ * @brief Validates an image of NUM_PAGES pages both ways and prints the results
+ */
+template <uint32_t NUM_PAGES>
+static bool runImageSize(const CostModel& model) {
+  using Manifest = ext::PageManifest<APP_START_ADDR, PAGE_SIZE, NUM_PAGES>;
+
+  std::vector<uint8_t> flash(NUM_PAGES * PAGE_SIZE);
+  std::mt19937 rng(NUM_PAGES);
+  for (uint8_t& byte : flash) {
+    byte = static_cast<uint8_t>(rng());
+  }
+  const uint32_t app_crc = crc::calculate(flash.data(), flash.size() - 4U);
+  memcpy(&flash[flash.size() - 4U], &app_crc, sizeof(app_crc));
+
+  uint32_t num_hashed_bytes = 0U;
+  auto calc_crc = [&flash, &num_hashed_bytes](const uint32_t address, const uint32_t length) {
+    num_hashed_bytes += length;
+    return crc::calculate(&flash[address - APP_START_ADDR], length);
+  };
+
+  static Manifest manifest;
+  const typename Manifest::Data data = manifest.update(calc_crc);
+
+  // Full hash (fallback without manifest)
+  num_hashed_bytes = 0U;
+  auto start = std::chrono::steady_clock::now();
+  const bool full_valid = (calc_crc(APP_START_ADDR, flash.size() - 4U) == app_crc);
+  const double full_host_us =
+      std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  const double full_dev_us = num_hashed_bytes / model.hash_bytes_per_us;
+
+  // Page manifest: the manifest itself, the combine of all page CRCs and the sampled pages are hashed
+  num_hashed_bytes = sizeof(typename Manifest::Data) - 4U;
+  start = std::chrono::steady_clock::now();
+  const bool manifest_valid = Manifest::verify(data, app_crc, calc_crc, 0x12345678U, NUM_SAMPLES);
+  const double manifest_host_us =
+      std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  const double manifest_dev_us = num_hashed_bytes / model.hash_bytes_per_us + (NUM_PAGES - 1U) * model.combine_us;
+
+  std::printf("%8u %6u %12.0f %12.0f %8.1fx %12.1f %12.1f\n", NUM_PAGES * PAGE_SIZE / 1024U, NUM_PAGES,
+              full_dev_us, manifest_dev_us, full_dev_us / manifest_dev_us, full_host_us, manifest_host_us);
+
+  return full_valid && manifest_valid;
+}
+
+// Main ---------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv) {
+  const CostModel model = {(argc > 1) ? std::strtod(argv[1], nullptr) : 20.0,
+                           (argc > 2) ? std::strtod(argv[2], nullptr) : 2.0};
+
+  std::printf("Page size %u, %u sampled pages, device model: %.1f MB/s hash, %.1f us per combine\n\n", PAGE_SIZE,
+              NUM_SAMPLES, model.hash_bytes_per_us, model.combine_us);
+  std::printf("%8s %6s %12s %12s %9s %12s %12s\n", "size[KB]", "pages", "full [us]", "manif. [us]", "speedup",
+              "host full", "host manif.");
+
+  bool valid = true;
+  valid = runImageSize<4U>(model) && valid;
+  valid = runImageSize<16U>(model) && valid;
+  valid = runImageSize<64U>(model) && valid;
+  valid = runImageSize<256U>(model) && valid;
+  valid = runImageSize<511U>(model) && valid;
+
+  return valid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,308 @@
+/**
+ * @file bench_req_window.cpp
+ * @author agent (agent@local)
+ * @brief Throughput of the request window over a simulated serial link with latency and message loss
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * Discrete event simulation of host, link and device. Both directions of the link serialize the 8 byte
+ * messages at the baud rate and add a fixed latency (USB serial adapter). The device processes one request
+ * at a time. The host keeps up to the window size of requests in flight, retransmits the requests missing
+ * in a WINDOW_STATUS and polls the status after a timeout without progress.
+ *
+ * Every run checks that all requests are processed exactly once and in order, the benchmark fails otherwise.
+ *
+ * Usage: bench_req_window [num_requests] [latency_us] [baud_rate]
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "req_window.h"
+
+using namespace franklyboot;
+
+// Simulation ---------------------------------------------------------------------------------------------------------
+
+constexpr uint32_t MAX_WINDOW = {16U};
+constexpr double PROCESS_TIME_US = {20.0};
+constexpr uint8_t FIRST_SEQ = {0xF0U};  // Sequence numbers wrap around early in every run
+
+struct LinkConfig {
+  double msg_time_us;  //!< Serialization time of one message
+  double latency_us;   //!< One way latency
+  double loss_rate;    //!< Probability of a lost message
+};
+
+struct RunResult {
+  double time_us;
+  uint32_t num_sent;
+  uint32_t num_retransmits;
+  uint32_t num_polls;
+  bool valid;
+};
+
+/**
+ * One direction of the link
+ */
+class Link {
+ public:
+  explicit Link(const LinkConfig& config) : _config(config) {}
+
+  /**
+   * @brief Returns arrival time of a message sent at the given time
+   */
+  double send(const double time_us) {
+    _free_us = std::max(time_us, _free_us) + _config.msg_time_us;
+    return _free_us + _config.latency_us;
+  }
+
+ private:
+  const LinkConfig& _config;
+  double _free_us = {0.0};
+};
+
+class Simulation {
+ public:
+  Simulation(const LinkConfig& config, const uint32_t window, const uint32_t num_requests)
+      : _config(config), _window(window), _num_requests(num_requests), _to_device(config), _to_host(config) {}
+
+  RunResult run() {
+    _acked.assign(_num_requests, false);
+    _last_sent_us.assign(_num_requests, -1.0e12);
+    _rto_us = 4.0 * (_config.latency_us + _config.msg_time_us) + _window * (_config.msg_time_us + PROCESS_TIME_US);
+
+    // Open window and start sending when it is granted
+    sendOpen();
+
+    while (!_events.empty()) {
+      const Event event = _events.top();
+      _events.pop();
+      _now_us = event.time_us;
+      event.action();
+
+      if (_base >= _num_requests) {
+        break;
+      }
+    }
+
+    const bool valid = (_base >= _num_requests) && (_processed.size() == _num_requests) && _in_order;
+    return {_now_us, _num_sent, _num_retransmits, _num_polls, valid};
+  }
+
+ private:
+  struct Event {
+    double time_us;
+    uint64_t order;
+    std::function<void()> action;
+
+    bool operator>(const Event& other) const {
+      return (time_us > other.time_us) || ((time_us == other.time_us) && (order > other.order));
+    }
+  };
+
+  void schedule(const double time_us, std::function<void()> action) {
+    _events.push({time_us, _event_cnt++, std::move(action)});
+  }
+
+  bool isLost() { return std::bernoulli_distribution(_config.loss_rate)(_rng); }
+
+  void sendToDevice(const double time_us, const msg::Msg& request) {
+    const double arrival_us = _to_device.send(time_us);
+    if (!isLost()) {
+      schedule(arrival_us, [this, request]() { deviceReceive(request); });
+    }
+  }
+
+  void sendToHost(const double time_us, const msg::Msg& response) {
+    const double arrival_us = _to_host.send(time_us);
+    if (!isLost()) {
+      schedule(arrival_us, [this, response]() { hostReceive(response); });
+    }
+  }
+
+  // Device -----------------------------------------------------------------------------------------------------------
+
+  void deviceReceive(const msg::Msg& request) {
+    _device_free_us = std::max(_now_us, _device_free_us);
+
+    _req_window.processRequest(
+        request,
+        [this](const msg::Msg& req) {
+          const uint32_t idx = ext::getDataWord(req);
+          _in_order = _in_order && (idx == _processed.size());
+          _processed.push_back(idx);
+          _device_free_us += PROCESS_TIME_US;
+          return ext::createResponse(static_cast<ext::ExtRequestType>(req.request), msg::RES_OK, 0U, idx);
+        },
+        [this](const msg::Msg& response) { sendToHost(_device_free_us, response); });
+  }
+
+  // Host -------------------------------------------------------------------------------------------------------------
+
+  uint32_t seqToIdx(const uint8_t seq) const {
+    return _base + static_cast<uint8_t>(seq - static_cast<uint8_t>(FIRST_SEQ + _base));
+  }
+
+  void sendOpen() {
+    sendToDevice(_now_us, ext::createResponse(ext::REQ_EXT_WINDOW_OPEN, msg::RES_NONE,
+                                              static_cast<uint8_t>(FIRST_SEQ - 1U), _window));
+    schedule(_now_us + _rto_us, [this]() {
+      if (!_opened) {
+        sendOpen();
+      }
+    });
+  }
+
+  void sendRequest(const uint32_t idx) {
+    if (_last_sent_us[idx] >= 0.0) {
+      _num_retransmits++;
+    }
+    _last_sent_us[idx] = _now_us;
+    _num_sent++;
+    sendToDevice(_now_us, ext::createResponse(static_cast<ext::ExtRequestType>(msg::REQ_PING), msg::RES_NONE,
+                                              static_cast<uint8_t>(FIRST_SEQ + idx), idx));
+  }
+
+  void ackUpTo(const uint32_t idx_end) {
+    for (uint32_t idx = _base; idx < idx_end; idx++) {
+      _acked[idx] = true;
+    }
+    advance();
+  }
+
+  void advance() {
+    const uint32_t base = _base;
+    while ((_base < _num_requests) && _acked[_base]) {
+      _base++;
+    }
+    if (_base != base) {
+      _progress_us = _now_us;
+    }
+
+    while ((_next < _num_requests) && ((_next - _base) < _window)) {
+      sendRequest(_next);
+      _next++;
+    }
+    armTimeout();
+  }
+
+  void armTimeout() {
+    const double progress_us = _progress_us;
+    schedule(_now_us + _rto_us, [this, progress_us]() {
+      if ((_progress_us == progress_us) && (_base < _num_requests)) {
+        _num_polls++;
+        sendToDevice(_now_us, ext::createResponse(ext::REQ_EXT_WINDOW_STATUS, msg::RES_NONE, 0U, 0U));
+        armTimeout();
+      }
+    });
+  }
+
+  void hostReceive(const msg::Msg& response) {
+    if (ext::isRequest(response, ext::REQ_EXT_WINDOW_OPEN)) {
+      if (!_opened) {
+        _opened = true;
+        _progress_us = _now_us;
+        advance();
+      }
+      return;
+    }
+
+    if (!_opened) {
+      return;
+    }
+
+    if (ext::isRequest(response, ext::REQ_EXT_WINDOW_STATUS)) {
+      // All requests before the expected one are processed, retransmit the missing ones
+      const uint32_t expected = seqToIdx(response.packet_id);
+      if (expected > _next) {
+        return;
+      }
+      ackUpTo(expected);
+
+      const uint32_t bitmap = ext::getDataWord(response) >> 8U;
+      for (uint32_t idx = expected; idx < _next; idx++) {
+        const bool buffered = (idx > expected) && ((bitmap >> (idx - expected - 1U)) & 1U);
+        if (!buffered && !_acked[idx] && ((_now_us - _last_sent_us[idx]) > _rto_us / 2.0)) {
+          sendRequest(idx);
+        }
+      }
+      return;
+    }
+
+    // Responses are cumulative acknowledges (requests are processed in order)
+    const uint32_t idx = seqToIdx(response.packet_id);
+    if (idx < _next) {
+      ackUpTo(idx + 1U);
+    }
+  }
+
+  const LinkConfig& _config;
+  const uint32_t _window;
+  const uint32_t _num_requests;
+
+  Link _to_device;
+  Link _to_host;
+  std::mt19937 _rng{1234U};
+  std::priority_queue<Event, std::vector<Event>, std::greater<Event>> _events;
+  uint64_t _event_cnt = {0U};
+  double _now_us = {0.0};
+
+  ext::RequestWindow<MAX_WINDOW> _req_window;
+  double _device_free_us = {0.0};
+  std::vector<uint32_t> _processed;
+  bool _in_order = {true};
+
+  bool _opened = {false};
+  uint32_t _base = {0U};
+  uint32_t _next = {0U};
+  std::vector<bool> _acked;
+  std::vector<double> _last_sent_us;
+  double _progress_us = {0.0};
+  double _rto_us = {0.0};
+  uint32_t _num_sent = {0U};
+  uint32_t _num_retransmits = {0U};
+  uint32_t _num_polls = {0U};
+};
+
+// Main ---------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv) {
+  const uint32_t num_requests = (argc > 1) ? std::strtoul(argv[1], nullptr, 0) : 4096U;
+  const double latency_us = (argc > 2) ? std::strtod(argv[2], nullptr) : 1000.0;
+  const double baud_rate = (argc > 3) ? std::strtod(argv[3], nullptr) : 921600.0;
+
+  bool valid = true;
+
+  std::printf("%u requests, latency %.0f us, %.0f baud, processing %.0f us\n\n", num_requests, latency_us,
+              baud_rate, PROCESS_TIME_US);
+  std::printf("%6s %6s %12s %12s %8s %8s %8s\n", "loss", "window", "time [ms]", "req/s", "speedup", "retrans",
+              "polls");
+
+  for (const double loss_rate : {0.0, 0.001, 0.01}) {
+    const LinkConfig config = {80.0 * 1.0e6 / baud_rate, latency_us, loss_rate};
+    double base_time_us = 0.0;
+
+    for (const uint32_t window : {1U, 2U, 4U, 8U, 16U}) {
+      Simulation sim(config, window, num_requests);
+      const RunResult result = sim.run();
+      if (window == 1U) {
+        base_time_us = result.time_us;
+      }
+
+      std::printf("%5.1f%% %6u %12.1f %12.0f %7.2fx %8u %8u%s\n", loss_rate * 100.0, window, result.time_us / 1000.0,
+                  num_requests / (result.time_us / 1.0e6), base_time_us / result.time_us, result.num_retransmits,
+                  result.num_polls, result.valid ? "" : "  FAILED");
+      valid = valid && result.valid;
+    }
+  }
+
+  return valid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
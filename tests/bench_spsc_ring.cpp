@@ -0,0 +1,92 @@
+/**
+ * @file bench_spsc_ring.cpp
+ * @author agent (agent@local)
+ * @brief Throughput of the inter core ring buffer between two threads for different chunk sizes
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * The producer pushes a byte counter in chunks of the given size, the consumer pops and checks it. The host
+ * numbers show the cost of the index synchronization per call relative to the copied data, they do not
+ * predict the RP2040 throughput.
+ *
+ * Usage: bench_spsc_ring [num_mbytes]
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "spsc_ring.h"
+
+// Benchmark ----------------------------------------------------------------------------------------------------------
+
+constexpr uint32_t RING_SIZE = {1024U};
+
+/**
+ * @brief Transfers num_bytes between two threads and returns the throughput in MB/s (negative on data error)
+ */
+static double runTransfer(const uint32_t num_bytes, const uint32_t chunk_size) {
+  static SPSCRing<uint8_t, RING_SIZE> ring;
+  ring.reset();
+
+  const auto start = std::chrono::steady_clock::now();
+
+  std::thread producer([num_bytes, chunk_size]() {
+    std::vector<uint8_t> data(chunk_size);
+    uint32_t num_pushed = 0U;
+    while (num_pushed < num_bytes) {
+      const uint32_t count = std::min(chunk_size, num_bytes - num_pushed);
+      for (uint32_t idx = 0U; idx < count; idx++) {
+        data[idx] = static_cast<uint8_t>(num_pushed + idx);
+      }
+      const uint32_t num_transferred = ring.push(data.data(), count);
+      num_pushed += num_transferred;
+      if (num_transferred == 0U) {
+        std::this_thread::yield();  // Hosts with a single CPU
+      }
+    }
+  });
+
+  std::vector<uint8_t> data(chunk_size);
+  uint32_t num_popped = 0U;
+  bool valid = true;
+  while (num_popped < num_bytes) {
+    const uint32_t count = ring.pop(data.data(), chunk_size);
+    for (uint32_t idx = 0U; idx < count; idx++) {
+      valid = valid && (data[idx] == static_cast<uint8_t>(num_popped + idx));
+    }
+    num_popped += count;
+    if (count == 0U) {
+      std::this_thread::yield();
+    }
+  }
+
+  producer.join();
+  const double time_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return valid ? (num_bytes / time_s / 1.0e6) : -1.0;
+}
+
+// Main ---------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv) {
+  const uint32_t num_mbytes = (argc > 1) ? std::strtoul(argv[1], nullptr, 0) : 16U;
+  const uint32_t num_bytes = num_mbytes * 1024U * 1024U;
+
+  bool valid = true;
+
+  std::printf("%u MiB through SPSCRing<uint8_t, %u>\n\n", num_mbytes, RING_SIZE);
+  std::printf("%8s %12s\n", "chunk", "MB/s");
+
+  for (const uint32_t chunk_size : {1U, 8U, 64U, 256U, 1024U}) {
+    const double mb_per_s = runTransfer(num_bytes, chunk_size);
+    std::printf("%8u %12.1f%s\n", chunk_size, mb_per_s, (mb_per_s < 0.0) ? "  FAILED" : "");
+    valid = valid && (mb_per_s >= 0.0);
+  }
+
+  return valid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
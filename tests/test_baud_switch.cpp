@@ -0,0 +1,245 @@
+/**
+ * @file test_baud_switch.cpp
+ * @author agent (agent@local)
+ * @brief Test of the baud rate switch (BRR calculation, sync byte measurement, switch, confirmation, fallback)
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+
+#include "baud_switch.h"
+
+using namespace franklyboot;
+
+// Helpers ------------------------------------------------------------------------------------------------------------
+
+// G431: LPUART1 on the 170 MHz system clock, F303: USART2 with 16 times oversampling
+using LpuartBaudSwitch = ext::BaudSwitch<256U, 0x300U, 0xFFFFFU>;
+using UsartBaudSwitch = ext::BaudSwitch<1U, 16U, 0xFFFFU>;
+
+constexpr uint32_t LPUART_CLK_HZ = {170000000U};
+constexpr uint32_t CYCLES_PER_MS = {LPUART_CLK_HZ / 1000U};
+constexpr uint32_t CONFIRM_TIMEOUT_CYCLES = {LpuartBaudSwitch::CONFIRM_TIMEOUT_MS * CYCLES_PER_MS};
+
+/**
+ * @brief Sends baud switch request, returns the response
+ */
+template <typename BaudSwitch>
+msg::Msg requestBaud(BaudSwitch& baud_switch, const uint32_t baud, const uint8_t packet_id = 1U) {
+  const msg::Msg request = ext::createResponse(ext::REQ_EXT_BAUD_SWITCH, msg::RES_NONE, packet_id, baud);
+  msg::Msg response;
+  EXPECT_TRUE(baud_switch.processRequest(request, response));
+  EXPECT_EQ(response.packet_id, packet_id);
+  return response;
+}
+
+/**
+ * @brief Returns edge timestamps of the sync byte with the given bit time in cycles
+ */
+std::array<uint32_t, ext::SYNC_NUM_EDGES> createSyncEdges(const double bit_cycles, const uint32_t start_cycles) {
+  std::array<uint32_t, ext::SYNC_NUM_EDGES> edge_cycles;
+  for (uint32_t idx = 0U; idx < ext::SYNC_NUM_EDGES; idx++) {
+    edge_cycles[idx] = start_cycles + static_cast<uint32_t>(bit_cycles * idx + 0.5);
+  }
+  return edge_cycles;
+}
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+TEST(BaudSwitch, CalcBRR) {
+  // BRR = 256 * 170 MHz / baud (rounded)
+  EXPECT_EQ(LpuartBaudSwitch::calcBRR(LPUART_CLK_HZ, 115200U), 377778U);
+  EXPECT_EQ(LpuartBaudSwitch::calcBRR(LPUART_CLK_HZ, 2000000U), 21760U);
+
+  // BRR = kernel clock / baud
+  EXPECT_EQ(UsartBaudSwitch::calcBRR(72000000U, 115200U), 625U);
+  EXPECT_EQ(UsartBaudSwitch::calcBRR(8000000U, 230400U), 35U);
+}
+
+TEST(BaudSwitch, CalcBRRLimits) {
+  // LPUART: BRR from 0x300 to 0xFFFFF
+  EXPECT_EQ(LpuartBaudSwitch::calcBRR(3U * 115200U, 115200U), 0x300U);
+  EXPECT_EQ(LpuartBaudSwitch::calcBRR(767000U, 256000U), 0U);
+  EXPECT_EQ(LpuartBaudSwitch::calcBRR(0xFFFFFU, 256U), 0xFFFFFU);
+  EXPECT_EQ(LpuartBaudSwitch::calcBRR(0x100000U, 256U), 0U);
+  EXPECT_EQ(LpuartBaudSwitch::calcBRR(LPUART_CLK_HZ, 9600U), 0U);
+
+  // USART with 16 times oversampling: BRR from 16 to 0xFFFF
+  EXPECT_EQ(UsartBaudSwitch::calcBRR(32000000U, 2000000U), 16U);
+  EXPECT_EQ(UsartBaudSwitch::calcBRR(30000000U, 2000000U), 0U);
+  EXPECT_EQ(UsartBaudSwitch::calcBRR(0xFFFFU, 1U), 0xFFFFU);
+  EXPECT_EQ(UsartBaudSwitch::calcBRR(0x10000U, 1U), 0U);
+}
+
+TEST(BaudSwitch, CalcBRRDeviation) {
+  // 8 MHz: 230400 baud is 0.8 % off, 460800 baud 2.1 % and 921600 baud 3.5 %
+  EXPECT_NE(UsartBaudSwitch::calcBRR(8000000U, 230400U), 0U);
+  EXPECT_EQ(UsartBaudSwitch::calcBRR(8000000U, 460800U), 0U);
+  EXPECT_EQ(UsartBaudSwitch::calcBRR(8000000U, 921600U), 0U);
+
+  // Unsupported rates are answered with the highest supported rate
+  UsartBaudSwitch baud_switch(8000000U);
+  msg::Msg response = requestBaud(baud_switch, 460800U);
+  EXPECT_EQ(response.result, msg::RES_ERR);
+  EXPECT_EQ(ext::getDataWord(response), 230400U);
+
+  response = requestBaud(baud_switch, 123456U);
+  EXPECT_EQ(response.result, msg::RES_ERR);
+  EXPECT_EQ(ext::getDataWord(response), 230400U);
+}
+
+TEST(BaudSwitch, MeasureSyncBRR) {
+  const double bit_cycles = static_cast<double>(LPUART_CLK_HZ) / 115200.0;
+  const uint32_t expected_brr = LpuartBaudSwitch::calcBRR(LPUART_CLK_HZ, 115200U);
+
+  auto edge_cycles = createSyncEdges(bit_cycles, 1000U);
+  EXPECT_NEAR(LpuartBaudSwitch::measureSyncBRR(edge_cycles.data()), expected_brr, 256U);
+
+  // Cycle counter wraps around within the sync byte
+  edge_cycles = createSyncEdges(bit_cycles, 0xFFFFF000U);
+  EXPECT_NEAR(LpuartBaudSwitch::measureSyncBRR(edge_cycles.data()), expected_brr, 256U);
+
+  // USART scale: BRR = cycles per bit
+  edge_cycles = createSyncEdges(625.0, 0U);
+  EXPECT_EQ(UsartBaudSwitch::measureSyncBRR(edge_cycles.data()), 625U);
+}
+
+TEST(BaudSwitch, MeasureSyncEdgeTolerance) {
+  const double bit_cycles = 1000.0;
+
+  // Edge within a quarter bit time of its expected position is accepted
+  auto edge_cycles = createSyncEdges(bit_cycles, 0U);
+  edge_cycles[4U] += 250U;
+  EXPECT_NE(LpuartBaudSwitch::measureSyncBRR(edge_cycles.data()), 0U);
+  edge_cycles[4U] -= 500U;
+  EXPECT_NE(LpuartBaudSwitch::measureSyncBRR(edge_cycles.data()), 0U);
+
+  // More than a quarter bit time off (e.g. other byte than 0x55 or a glitch) is rejected
+  edge_cycles = createSyncEdges(bit_cycles, 0U);
+  edge_cycles[4U] += 251U;
+  EXPECT_EQ(LpuartBaudSwitch::measureSyncBRR(edge_cycles.data()), 0U);
+
+  edge_cycles = createSyncEdges(bit_cycles, 0U);
+  edge_cycles[1U] = edge_cycles[2U];
+  EXPECT_EQ(LpuartBaudSwitch::measureSyncBRR(edge_cycles.data()), 0U);
+}
+
+TEST(BaudSwitch, SwitchAndConfirm) {
+  LpuartBaudSwitch baud_switch(LPUART_CLK_HZ);
+  const uint32_t base_brr = baud_switch.getBRR();
+  EXPECT_EQ(base_brr, LpuartBaudSwitch::calcBRR(LPUART_CLK_HZ, ext::DEFAULT_BAUD));
+
+  msg::Msg response = requestBaud(baud_switch, 921600U);
+  EXPECT_EQ(response.result, msg::RES_OK);
+  EXPECT_EQ(ext::getDataWord(response), 921600U);
+
+  // Response is transmitted at the old rate, the new rate is set with the next poll
+  uint32_t brr = 0U;
+  EXPECT_EQ(baud_switch.poll(0U, 0U, brr), LpuartBaudSwitch::LINK_SET_BRR);
+  EXPECT_EQ(brr, LpuartBaudSwitch::calcBRR(LPUART_CLK_HZ, 921600U));
+  EXPECT_EQ(baud_switch.poll(1U, 0U, brr), LpuartBaudSwitch::LINK_KEEP);
+
+  // Confirmation at the new rate keeps it after the timeout
+  response = requestBaud(baud_switch, 921600U, 2U);
+  EXPECT_EQ(response.result, msg::RES_OK);
+  EXPECT_EQ(baud_switch.poll(CONFIRM_TIMEOUT_CYCLES * 2U, 0U, brr), LpuartBaudSwitch::LINK_KEEP);
+  EXPECT_EQ(baud_switch.getBRR(), LpuartBaudSwitch::calcBRR(LPUART_CLK_HZ, 921600U));
+}
+
+TEST(BaudSwitch, FallbackWithoutConfirmation) {
+  LpuartBaudSwitch baud_switch(LPUART_CLK_HZ);
+  const uint32_t base_brr = baud_switch.getBRR();
+
+  requestBaud(baud_switch, 2000000U);
+  uint32_t brr = 0U;
+  const uint32_t switch_cycles = 0xFFFFFF00U;
+  EXPECT_EQ(baud_switch.poll(switch_cycles, 0U, brr), LpuartBaudSwitch::LINK_SET_BRR);
+
+  // Host does not confirm: the previous rate is set after the timeout (cycle counter wraps around)
+  EXPECT_EQ(baud_switch.poll(switch_cycles + CONFIRM_TIMEOUT_CYCLES - 1U, 0U, brr), LpuartBaudSwitch::LINK_KEEP);
+  EXPECT_EQ(baud_switch.poll(switch_cycles + CONFIRM_TIMEOUT_CYCLES, 0U, brr), LpuartBaudSwitch::LINK_SET_BRR);
+  EXPECT_EQ(brr, base_brr);
+  EXPECT_EQ(baud_switch.getBRR(), base_brr);
+
+  // Confirmed rate is the fallback of the next switch
+  requestBaud(baud_switch, 460800U);
+  baud_switch.poll(0U, 0U, brr);
+  requestBaud(baud_switch, 460800U);
+  requestBaud(baud_switch, 1000000U);
+  EXPECT_EQ(baud_switch.poll(10U, 0U, brr), LpuartBaudSwitch::LINK_SET_BRR);
+  EXPECT_EQ(baud_switch.poll(10U + CONFIRM_TIMEOUT_CYCLES, 0U, brr), LpuartBaudSwitch::LINK_SET_BRR);
+  EXPECT_EQ(brr, LpuartBaudSwitch::calcBRR(LPUART_CLK_HZ, 460800U));
+}
+
+TEST(BaudSwitch, ConfirmationOfOtherRateSwitchesAgain) {
+  LpuartBaudSwitch baud_switch(LPUART_CLK_HZ);
+  const uint32_t base_brr = baud_switch.getBRR();
+
+  requestBaud(baud_switch, 921600U);
+  uint32_t brr = 0U;
+  baud_switch.poll(0U, 0U, brr);
+
+  // Request of another rate before the confirmation: switch to it, the base rate stays the fallback
+  EXPECT_EQ(requestBaud(baud_switch, 460800U).result, msg::RES_OK);
+  EXPECT_EQ(baud_switch.poll(100U, 0U, brr), LpuartBaudSwitch::LINK_SET_BRR);
+  EXPECT_EQ(brr, LpuartBaudSwitch::calcBRR(LPUART_CLK_HZ, 460800U));
+  EXPECT_EQ(baud_switch.poll(100U + CONFIRM_TIMEOUT_CYCLES, 0U, brr), LpuartBaudSwitch::LINK_SET_BRR);
+  EXPECT_EQ(brr, base_brr);
+}
+
+TEST(BaudSwitch, LinkFailureRestartsAtBaseRate) {
+  LpuartBaudSwitch baud_switch(LPUART_CLK_HZ);
+
+  // Auto-baud measured base rate, out of range values are not taken
+  EXPECT_FALSE(baud_switch.setBaseBRR(0x2FFU));
+  EXPECT_TRUE(baud_switch.setBaseBRR(400000U));
+  EXPECT_EQ(baud_switch.getBRR(), 400000U);
+
+  requestBaud(baud_switch, 921600U);
+  uint32_t brr = 0U;
+  uint32_t error_cnt = 5U;
+  baud_switch.poll(0U, error_cnt, brr);
+  requestBaud(baud_switch, 921600U);
+
+  // Errors between error free messages are no link failure
+  error_cnt += LpuartBaudSwitch::LINK_ERROR_LIMIT - 1U;
+  baud_switch.onMessage(error_cnt);
+  baud_switch.onMessage(error_cnt);
+  EXPECT_EQ(baud_switch.poll(1U, error_cnt, brr), LpuartBaudSwitch::LINK_KEEP);
+
+  error_cnt += LpuartBaudSwitch::LINK_ERROR_LIMIT - 1U;
+  EXPECT_EQ(baud_switch.poll(2U, error_cnt, brr), LpuartBaudSwitch::LINK_KEEP);
+  error_cnt++;
+  EXPECT_EQ(baud_switch.poll(3U, error_cnt, brr), LpuartBaudSwitch::LINK_RESTART);
+  EXPECT_EQ(brr, 400000U);
+
+  // Errors at the base rate are handled by the auto-baud detection
+  error_cnt += LpuartBaudSwitch::LINK_ERROR_LIMIT * 2U;
+  EXPECT_EQ(baud_switch.poll(4U, error_cnt, brr), LpuartBaudSwitch::LINK_KEEP);
+}
+
+TEST(BaudSwitch, ClockChangeRescalesRates) {
+  LpuartBaudSwitch baud_switch(LPUART_CLK_HZ);
+  requestBaud(baud_switch, 921600U);
+  uint32_t brr = 0U;
+  baud_switch.poll(0U, 0U, brr);
+  requestBaud(baud_switch, 921600U);
+
+  // Half clock: half BRR for the current rate and the base rate after a link failure
+  EXPECT_EQ(baud_switch.setClock(LPUART_CLK_HZ / 2U, LPUART_CLK_HZ / 2U),
+            LpuartBaudSwitch::calcBRR(LPUART_CLK_HZ / 2U, 921600U));
+  EXPECT_EQ(baud_switch.poll(1U, LpuartBaudSwitch::LINK_ERROR_LIMIT, brr), LpuartBaudSwitch::LINK_RESTART);
+  EXPECT_EQ(brr, LpuartBaudSwitch::calcBRR(LPUART_CLK_HZ / 2U, ext::DEFAULT_BAUD));
+}
+
+TEST(BaudSwitch, OtherRequestIsNotProcessed) {
+  LpuartBaudSwitch baud_switch(LPUART_CLK_HZ);
+  const msg::Msg request = ext::createResponse(ext::REQ_EXT_DISCOVER, msg::RES_NONE, 0U, 0U);
+  msg::Msg response;
+  EXPECT_FALSE(baud_switch.processRequest(request, response));
+}
@@ -0,0 +1,288 @@
+/**
+ * @file test_bcast_update.cpp
+ * @author agent (agent@local)
+ * @brief Test of the broadcast update (page reception, NACK bitmaps of several nodes, response slots)
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+
+#include <cstring>
+#include <new>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "bcast_update.h"
+#include "crc32.h"
+
+using namespace franklyboot;
+
+// Simulated Nodes ----------------------------------------------------------------------------------------------------
+
+constexpr uint32_t FLASH_START_ADDR = {0x08000000U};
+constexpr uint32_t APP_FIRST_PAGE = {4U};
+constexpr uint32_t PAGE_SIZE = {256U};
+constexpr uint32_t FLASH_SIZE = {40U * PAGE_SIZE};
+constexpr uint32_t CPU_CLK_HZ = {80000000U};
+constexpr uint32_t CYCLES_PER_SLOT = {1000U * (CPU_CLK_HZ / 1000000U)};
+
+// Nodes are mapped to a 32 bit address, the page buffer is passed to the CRC function by its address
+constexpr uint32_t RAM_START_ADDR = {0x20000000U};
+constexpr uint32_t NUM_NODES = {3U};
+
+using TestBroadcastUpdate = ext::BroadcastUpdate<FLASH_START_ADDR, APP_FIRST_PAGE, FLASH_SIZE, PAGE_SIZE>;
+
+/**
+ * Flash of a node
+ */
+struct SimFlash {
+  SimFlash() : bytes(FLASH_SIZE, 0xFFU) {}
+
+  std::vector<uint8_t> bytes;
+  uint32_t num_erased = {0U};
+};
+
+static SimFlash* active_flash = {nullptr};  // Flash of the node processing the request
+
+namespace franklyboot::hwi {
+
+uint32_t calculateCRC(const uint32_t src_address, const uint32_t num_bytes) {
+  return crc::calculate(reinterpret_cast<const uint8_t*>(static_cast<uintptr_t>(src_address)), num_bytes);
+}
+
+bool eraseFlashPage(const uint32_t page_id) {
+  memset(&active_flash->bytes[page_id * PAGE_SIZE], 0xFF, PAGE_SIZE);
+  active_flash->num_erased++;
+  return true;
+}
+
+bool writeDataBufferToFlash(const uint32_t dst_address, const uint32_t dst_page_id, uint8_t* src_data_ptr,
+                            const uint32_t num_bytes) {
+  (void)dst_page_id;
+  memcpy(&active_flash->bytes[dst_address - FLASH_START_ADDR], src_data_ptr, num_bytes);
+  return true;
+}
+
+};  // namespace franklyboot::hwi
+
+// Helpers ------------------------------------------------------------------------------------------------------------
+
+msg::Msg createBroadcast(const ext::ExtRequestType type, const uint32_t data) {
+  return ext::createResponse(type, msg::RES_NONE, 0U, data);
+}
+
+/**
+ * Nodes on one bus, every frame is received by all nodes unless it is dropped for a node
+ */
+class BroadcastUpdateTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    void* const addr = reinterpret_cast<void*>(static_cast<uintptr_t>(RAM_START_ADDR));
+    void* mapping = mmap(addr, sizeof(TestBroadcastUpdate) * NUM_NODES, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (mapping != addr) {
+      if (mapping != MAP_FAILED) {
+        munmap(mapping, sizeof(TestBroadcastUpdate) * NUM_NODES);
+      }
+      GTEST_SKIP() << "RAM address is not available in this process";
+    }
+
+    _nodes = static_cast<TestBroadcastUpdate*>(mapping);
+    for (uint32_t idx = 0U; idx < NUM_NODES; idx++) {
+      new (&_nodes[idx]) TestBroadcastUpdate(idx, CPU_CLK_HZ);
+    }
+
+    std::mt19937 rng(7U);
+    _image.resize(FLASH_SIZE);
+    for (uint8_t& byte : _image) {
+      byte = static_cast<uint8_t>(rng());
+    }
+  }
+
+  void TearDown() override {
+    if (_nodes != nullptr) {
+      munmap(_nodes, sizeof(TestBroadcastUpdate) * NUM_NODES);
+    }
+  }
+
+  /**
+   * @brief Sends broadcast request to all nodes
+   */
+  void broadcast(const msg::Msg& request, const uint32_t cycles = 0U) {
+    for (uint32_t idx = 0U; idx < NUM_NODES; idx++) {
+      active_flash = &_flash[idx];
+      EXPECT_TRUE(_nodes[idx].processBroadcast(request, cycles));
+    }
+  }
+
+  /**
+   * @brief Sends page of the image, the data blocks are dropped for the given nodes
+   */
+  void sendPage(const uint32_t page_id, const std::set<uint32_t>& lossy_nodes = {}, const uint32_t crc_xor = 0U) {
+    broadcast(createBroadcast(ext::REQ_EXT_BCAST_PAGE, page_id));
+
+    const uint8_t* page = &_image[page_id * PAGE_SIZE];
+    for (uint32_t block = 0U; block < TestBroadcastUpdate::NUM_BLOCKS; block++) {
+      for (uint32_t idx = 0U; idx < NUM_NODES; idx++) {
+        if ((lossy_nodes.count(idx) == 0U) || (block != (page_id % TestBroadcastUpdate::NUM_BLOCKS))) {
+          _nodes[idx].feed(&page[block * TestBroadcastUpdate::BLOCK_SIZE]);
+        }
+      }
+    }
+
+    broadcast(createBroadcast(ext::REQ_EXT_BCAST_PAGE_END, crc::calculate(page, PAGE_SIZE) ^ crc_xor));
+  }
+
+  /**
+   * @brief Requests the status of all nodes and collects the responses in the order of the bus
+   *
+   * @param missing Receives the union of the missing pages of all nodes
+   * @return Number of nodes which reported RES_OK
+   */
+  uint32_t collectStatus(std::vector<uint32_t>& missing) {
+    const uint32_t request_cycles = 0xFFFFFF00U;
+    broadcast(createBroadcast(ext::REQ_EXT_BCAST_STATUS, 0U), request_cycles);
+
+    missing.assign(TestBroadcastUpdate::NUM_BITMAP_WORDS, 0U);
+    uint32_t num_complete = 0U;
+    for (uint32_t slot = 0U; slot < NUM_NODES; slot++) {
+      const uint32_t cycles = request_cycles + slot * CYCLES_PER_SLOT;
+      for (uint32_t word_idx = 0U; word_idx < TestBroadcastUpdate::NUM_BITMAP_WORDS; word_idx++) {
+        msg::Msg response = {};
+        EXPECT_TRUE(_nodes[slot].poll(cycles, response));
+        EXPECT_EQ(response.packet_id, word_idx);
+        missing[word_idx] |= ext::getDataWord(response);
+        num_complete += ((word_idx == 0U) && (response.result == msg::RES_OK)) ? 1U : 0U;
+      }
+    }
+    return num_complete;
+  }
+
+  TestBroadcastUpdate* _nodes = {nullptr};
+  SimFlash _flash[NUM_NODES];
+  std::vector<uint8_t> _image;
+};
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+TEST_F(BroadcastUpdateTest, OpenMarksPagesMissing) {
+  TestBroadcastUpdate& node = _nodes[0U];
+  broadcast(createBroadcast(ext::REQ_EXT_BCAST_OPEN, 30U | (4U << 16U)));
+  EXPECT_TRUE(node.isActive());
+
+  // Pages 30 - 33 span both bitmap words
+  msg::Msg response;
+  ASSERT_TRUE(node.processRequest(ext::createResponse(ext::REQ_EXT_BCAST_STATUS, msg::RES_NONE, 3U, 0U), response));
+  EXPECT_EQ(response.result, msg::RES_ERR);
+  EXPECT_EQ(response.packet_id, 0U);
+  EXPECT_EQ(ext::getDataWord(response), 0xC0000000U);
+
+  ASSERT_TRUE(node.processRequest(ext::createResponse(ext::REQ_EXT_BCAST_STATUS, msg::RES_NONE, 3U, 1U), response));
+  EXPECT_EQ(response.packet_id, 1U);
+  EXPECT_EQ(ext::getDataWord(response), 0x00000003U);
+
+  // Ranges outside of the application are not opened
+  for (const uint32_t range : {(APP_FIRST_PAGE - 1U) | (2U << 16U), 38U | (3U << 16U), 10U}) {
+    broadcast(createBroadcast(ext::REQ_EXT_BCAST_OPEN, range));
+    EXPECT_FALSE(node.isActive());
+    ASSERT_TRUE(node.processRequest(ext::createResponse(ext::REQ_EXT_BCAST_STATUS, msg::RES_NONE, 0U, 0U), response));
+    EXPECT_EQ(response.result, msg::RES_ERR);
+    EXPECT_EQ(ext::getDataWord(response), 0U);
+  }
+}
+
+TEST_F(BroadcastUpdateTest, PageIsWrittenWithAllBlocksAndMatchingCRC) {
+  broadcast(createBroadcast(ext::REQ_EXT_BCAST_OPEN, 10U | (3U << 16U)));
+
+  sendPage(10U, {1U});
+  sendPage(11U, {}, 0x1U);
+  sendPage(12U);
+
+  // Node 1 lost a block of page 10, page 11 has a wrong CRC on all nodes
+  std::vector<uint32_t> missing;
+  EXPECT_EQ(collectStatus(missing), 0U);
+  EXPECT_EQ(missing[0U], (1U << 10U) | (1U << 11U));
+  EXPECT_EQ(_flash[0U].num_erased, 2U);
+  EXPECT_EQ(_flash[1U].num_erased, 1U);
+  EXPECT_EQ(memcmp(&_flash[0U].bytes[10U * PAGE_SIZE], &_image[10U * PAGE_SIZE], PAGE_SIZE), 0);
+
+  // Pages which are not missing are not written again
+  sendPage(12U);
+  EXPECT_EQ(_flash[0U].num_erased, 2U);
+
+  // Blocks without page announcement are ignored
+  _nodes[0U].feed(&_image[0U]);
+  EXPECT_EQ(_flash[0U].num_erased, 2U);
+}
+
+TEST_F(BroadcastUpdateTest, NackBitmapsOfAllNodesAreAggregated) {
+  const uint32_t first_page = 28U;
+  const uint32_t num_pages = 8U;
+  broadcast(createBroadcast(ext::REQ_EXT_BCAST_OPEN, first_page | (num_pages << 16U)));
+
+  // Every node loses other pages in the first round
+  for (uint32_t page_id = first_page; page_id < (first_page + num_pages); page_id++) {
+    std::set<uint32_t> lossy_nodes;
+    if ((page_id % 3U) == 0U) {
+      lossy_nodes = {(page_id / 3U) % NUM_NODES};
+    }
+    sendPage(page_id, lossy_nodes);
+  }
+
+  // Host repeats the union of the missing pages until all nodes report RES_OK
+  std::vector<uint32_t> missing;
+  uint32_t num_rounds = 0U;
+  while (collectStatus(missing) != NUM_NODES) {
+    ASSERT_LT(num_rounds, 2U);
+    EXPECT_EQ(missing[0U], (1U << 30U));
+    EXPECT_EQ(missing[1U], (1U << (33U - 32U)));
+
+    for (uint32_t page_id = 0U; page_id < (TestBroadcastUpdate::NUM_BITMAP_WORDS * 32U); page_id++) {
+      if (((missing[page_id / 32U] >> (page_id % 32U)) & 1U) != 0U) {
+        sendPage(page_id);
+      }
+    }
+    num_rounds++;
+  }
+
+  EXPECT_EQ(num_rounds, 1U);
+  for (uint32_t idx = 0U; idx < NUM_NODES; idx++) {
+    EXPECT_FALSE(_nodes[idx].isActive());
+    EXPECT_EQ(_flash[idx].num_erased, num_pages);
+    EXPECT_EQ(memcmp(&_flash[idx].bytes[first_page * PAGE_SIZE], &_image[first_page * PAGE_SIZE],
+                     num_pages * PAGE_SIZE),
+              0);
+  }
+}
+
+TEST_F(BroadcastUpdateTest, StatusIsSentInTheSlotOfTheNodeID) {
+  TestBroadcastUpdate& node = _nodes[0U];
+  broadcast(createBroadcast(ext::REQ_EXT_BCAST_OPEN, 10U | (1U << 16U)));
+
+  // Node ID 5: slot starts 5 ms after the request (cycle counter wraps around)
+  node.setSlot(5U);
+  const uint32_t request_cycles = 0xFFFF0000U;
+  broadcast(createBroadcast(ext::REQ_EXT_BCAST_STATUS, 0U), request_cycles);
+
+  msg::Msg response;
+  EXPECT_FALSE(node.poll(request_cycles + 5U * CYCLES_PER_SLOT - 1U, response));
+  for (uint32_t word_idx = 0U; word_idx < TestBroadcastUpdate::NUM_BITMAP_WORDS; word_idx++) {
+    ASSERT_TRUE(node.poll(request_cycles + 5U * CYCLES_PER_SLOT, response));
+    EXPECT_EQ(response.packet_id, word_idx);
+    EXPECT_EQ(response.result, msg::RES_ERR);
+  }
+  EXPECT_FALSE(node.poll(request_cycles + 6U * CYCLES_PER_SLOT, response));
+
+  // Slot time follows the clock of the cycle counter
+  node.setClock(CPU_CLK_HZ / 2U);
+  broadcast(createBroadcast(ext::REQ_EXT_BCAST_STATUS, 0U), 0U);
+  EXPECT_FALSE(node.poll(5U * CYCLES_PER_SLOT / 2U - 1U, response));
+  EXPECT_TRUE(node.poll(5U * CYCLES_PER_SLOT / 2U, response));
+}
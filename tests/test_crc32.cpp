@@ -0,0 +1,85 @@
+/**
+ * @file test_crc32.cpp
+ * @author agent (agent@local)
+ * @brief Cross-check of the portable CRC-32 against zlib
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <random>
+#include <vector>
+
+#include "crc32.h"
+
+// Helpers ------------------------------------------------------------------------------------------------------------
+
+static std::vector<uint8_t> createData(const uint32_t num_bytes, const uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::vector<uint8_t> data(num_bytes);
+  for (uint8_t& byte : data) {
+    byte = static_cast<uint8_t>(rng());
+  }
+  return data;
+}
+
+static uint32_t zlibCRC(const uint8_t* data, const uint32_t num_bytes) {
+  return static_cast<uint32_t>(::crc32(0UL, data, num_bytes));
+}
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+TEST(CRC32, CheckValue) {
+  const uint8_t data[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  EXPECT_EQ(crc::calculate(data, sizeof(data)), 0xCBF43926U);
+  EXPECT_EQ(crc::calculate(data, 0U), 0U);
+}
+
+TEST(CRC32, MatchesZlibForUnalignedStartsAndAllLengths) {
+  constexpr uint32_t MAX_LENGTH = {4095U};
+  constexpr uint32_t MAX_OFFSET = {8U};
+  const auto data = createData(MAX_LENGTH + MAX_OFFSET, 1U);
+
+  // Every start offset within a double word reaches the byte-wise head, the slicing loop and the tail
+  for (uint32_t offset = 0U; offset < MAX_OFFSET; offset++) {
+    for (uint32_t length = 0U; length <= MAX_LENGTH; length++) {
+      ASSERT_EQ(crc::calculate(&data[offset], length), zlibCRC(&data[offset], length))
+          << "offset " << offset << ", length " << length;
+    }
+  }
+}
+
+TEST(CRC32, UpdateInPieces) {
+  const auto data = createData(4096U, 2U);
+  std::mt19937 rng(3U);
+
+  for (uint32_t iteration = 0U; iteration < 1000U; iteration++) {
+    const uint32_t split = rng() % data.size();
+
+    uint32_t crc = crc::update(crc::INIT_VALUE, data.data(), split);
+    crc = crc::update(crc, &data[split], data.size() - split);
+    ASSERT_EQ(~crc, zlibCRC(data.data(), data.size())) << "split " << split;
+  }
+}
+
+TEST(CRC32, CombineMatchesZlib) {
+  const auto data = createData(8192U, 4U);
+  std::mt19937 rng(5U);
+
+  for (uint32_t iteration = 0U; iteration < 1000U; iteration++) {
+    const uint32_t length_a = rng() % 4096U;
+    const uint32_t length_b = rng() % 4096U;
+    const uint32_t crc_a = crc::calculate(data.data(), length_a);
+    const uint32_t crc_b = crc::calculate(&data[length_a], length_b);
+
+    const uint32_t combined = crc::combine(crc_a, crc_b, crc::shiftOperator(length_b));
+    ASSERT_EQ(combined, static_cast<uint32_t>(::crc32_combine(crc_a, crc_b, length_b)));
+    ASSERT_EQ(combined, zlibCRC(data.data(), length_a + length_b));
+  }
+}
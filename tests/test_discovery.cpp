@@ -0,0 +1,159 @@
+/**
+ * @file test_discovery.cpp
+ * @author agent (agent@local)
+ * @brief Test of the node discovery (unique ID hash, answer slots, slot timing)
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+
+#include <bitset>
+#include <set>
+#include <vector>
+
+#include "discovery.h"
+
+using namespace franklyboot;
+
+// Helpers ------------------------------------------------------------------------------------------------------------
+
+constexpr uint32_t CPU_CLK_HZ = {80000000U};
+constexpr uint32_t CYCLES_PER_SLOT = {ext::Discovery::SLOT_TIME_US * (CPU_CLK_HZ / 1000000U)};
+
+/**
+ * @brief Returns unique ID hashes of boards of one lot (unique IDs differ in the wafer position only)
+ */
+std::vector<uint32_t> createLotHashes(const uint32_t num_nodes) {
+  std::vector<uint32_t> hashes;
+  for (uint32_t idx = 0U; idx < num_nodes; idx++) {
+    const uint32_t wafer_xy = ((10U + idx % 8U) << 16U) | (20U + idx / 8U);
+    hashes.push_back(ext::hashUniqueID(wafer_xy, 0x34325105U, 0x20383650U));
+  }
+  return hashes;
+}
+
+/**
+ * @brief Returns slot of the node answering the discovery request
+ */
+uint32_t getAnswerSlot(const uint32_t uid_hash, const uint8_t num_slots) {
+  ext::Discovery discovery(CPU_CLK_HZ);
+  discovery.setDeviceInfo(1U, 2U, 3U, uid_hash);
+  EXPECT_TRUE(discovery.processBroadcast(ext::createResponse(ext::REQ_EXT_DISCOVER, msg::RES_NONE, 0U, num_slots), 0U));
+
+  msg::Msg response;
+  uint32_t slot = 0U;
+  while (!discovery.poll(slot * CYCLES_PER_SLOT, response)) {
+    slot++;
+  }
+  return slot;
+}
+
+/**
+ * @brief Returns number of nodes sharing their slot with another node
+ */
+uint32_t countCollisions(const std::vector<uint32_t>& hashes, const uint8_t num_slots) {
+  std::vector<uint32_t> nodes_per_slot(num_slots != 0U ? num_slots : ext::Discovery::NUM_SLOTS, 0U);
+  for (const uint32_t hash : hashes) {
+    nodes_per_slot[getAnswerSlot(hash, num_slots)]++;
+  }
+
+  uint32_t num_collisions = 0U;
+  for (const uint32_t num_nodes : nodes_per_slot) {
+    num_collisions += (num_nodes > 1U) ? num_nodes : 0U;
+  }
+  return num_collisions;
+}
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+TEST(Discovery, HashUsesAllUniqueIDBits) {
+  const uint32_t uid[3U] = {0x00170030U, 0x34325105U, 0x20383650U};
+  const uint32_t hash = ext::hashUniqueID(uid[0U], uid[1U], uid[2U]);
+
+  // Every single bit flip of the unique ID changes about half of the hash bits
+  for (uint32_t word = 0U; word < 3U; word++) {
+    for (uint32_t bit = 0U; bit < 32U; bit++) {
+      uint32_t flipped[3U] = {uid[0U], uid[1U], uid[2U]};
+      flipped[word] ^= (1U << bit);
+      const uint32_t flipped_hash = ext::hashUniqueID(flipped[0U], flipped[1U], flipped[2U]);
+      const uint32_t num_changed = static_cast<uint32_t>(std::bitset<32>(hash ^ flipped_hash).count());
+      EXPECT_GE(num_changed, 4U) << "word " << word << " bit " << bit;
+    }
+  }
+}
+
+TEST(Discovery, AnswerInSlotOfTheHash) {
+  ext::Discovery discovery(CPU_CLK_HZ);
+  const uint32_t uid_hash = 0x12345678U;
+  discovery.setDeviceInfo(0x0A0B0C0DU, 0x11121314U, 0x00010203U, uid_hash);
+
+  // Default number of slots
+  const uint32_t request_cycles = 0xFFFFF000U;
+  const uint32_t slot = uid_hash % ext::Discovery::NUM_SLOTS;
+  EXPECT_TRUE(discovery.processBroadcast(ext::createResponse(ext::REQ_EXT_DISCOVER, msg::RES_NONE, 0U, 0U),
+                                         request_cycles));
+
+  msg::Msg response;
+  EXPECT_FALSE(discovery.poll(request_cycles + slot * CYCLES_PER_SLOT - 1U, response));
+
+  // All information words follow each other in the slot (cycle counter wraps around)
+  const uint32_t expected[ext::Discovery::NUM_INFO_WORDS] = {0x0A0B0C0DU, 0x11121314U, 0x00010203U, uid_hash};
+  for (uint32_t word_idx = 0U; word_idx < ext::Discovery::NUM_INFO_WORDS; word_idx++) {
+    ASSERT_TRUE(discovery.poll(request_cycles + slot * CYCLES_PER_SLOT, response));
+    EXPECT_EQ(response.result, msg::RES_OK);
+    EXPECT_EQ(response.packet_id, word_idx);
+    EXPECT_EQ(ext::getDataWord(response), expected[word_idx]);
+  }
+  EXPECT_FALSE(discovery.poll(request_cycles + (slot + 1U) * CYCLES_PER_SLOT, response));
+
+  // Number of slots of the request
+  EXPECT_EQ(getAnswerSlot(uid_hash, 16U), uid_hash % 16U);
+  EXPECT_EQ(getAnswerSlot(uid_hash, 1U), 0U);
+
+  // Other requests are not processed
+  EXPECT_FALSE(discovery.processBroadcast(ext::createResponse(ext::REQ_EXT_BCAST_STATUS, msg::RES_NONE, 0U, 0U), 0U));
+}
+
+TEST(Discovery, SlotTimeFollowsClock) {
+  ext::Discovery discovery(CPU_CLK_HZ);
+  discovery.setDeviceInfo(0U, 0U, 0U, 5U);
+  discovery.setClock(CPU_CLK_HZ / 4U);
+  EXPECT_TRUE(discovery.processBroadcast(ext::createResponse(ext::REQ_EXT_DISCOVER, msg::RES_NONE, 0U, 0U), 0U));
+
+  msg::Msg response;
+  EXPECT_FALSE(discovery.poll(5U * CYCLES_PER_SLOT / 4U - 1U, response));
+  EXPECT_TRUE(discovery.poll(5U * CYCLES_PER_SLOT / 4U, response));
+}
+
+TEST(Discovery, RepeatedRequestRestartsAnswer) {
+  ext::Discovery discovery(CPU_CLK_HZ);
+  discovery.setDeviceInfo(1U, 2U, 3U, 0U);
+
+  msg::Msg response;
+  EXPECT_TRUE(discovery.processBroadcast(ext::createResponse(ext::REQ_EXT_DISCOVER, msg::RES_NONE, 0U, 0U), 0U));
+  EXPECT_TRUE(discovery.poll(0U, response));
+  EXPECT_TRUE(discovery.poll(0U, response));
+
+  // Host repeats the request before the answer is complete: the answer starts again with the first word
+  EXPECT_TRUE(discovery.processBroadcast(ext::createResponse(ext::REQ_EXT_DISCOVER, msg::RES_NONE, 0U, 0U), 0U));
+  ASSERT_TRUE(discovery.poll(0U, response));
+  EXPECT_EQ(response.packet_id, 0U);
+}
+
+TEST(Discovery, MoreSlotsSeparateNodesOfOneLot) {
+  // Host backs off with more slots while nodes share a slot
+  const std::vector<uint32_t> hashes = createLotHashes(16U);
+  EXPECT_EQ(std::set<uint32_t>(hashes.begin(), hashes.end()).size(), hashes.size());
+
+  const uint32_t collisions_16 = countCollisions(hashes, 16U);
+  const uint32_t collisions_64 = countCollisions(hashes, 0U);
+  const uint32_t collisions_255 = countCollisions(hashes, 255U);
+  EXPECT_GT(collisions_16, 0U);
+  EXPECT_LT(collisions_64, collisions_16);
+  EXPECT_LT(collisions_255, collisions_64);
+}
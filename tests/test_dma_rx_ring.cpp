@@ -0,0 +1,247 @@
+/**
+ * @file test_dma_rx_ring.cpp
+ * @author agent (agent@local)
+ * @brief Test of the DMA reception ring buffer and the message framing against a simulated UART with DMA
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+
+#include <array>
+#include <vector>
+
+#include "dma_rx_ring.h"
+#include "frame_sync.h"
+
+// Simulated Peripheral -----------------------------------------------------------------------------------------------
+
+constexpr uint32_t RING_SIZE = {64U};
+constexpr uint32_t MSG_SIZE = {8U};
+
+/**
+ * UART with DMA channel in circular mode and the receive path of the boards (serial ISR and raw mode
+ * message reassembly of the main loop)
+ */
+class SimSerial {
+ public:
+  /**
+   * @brief Receives byte: DMA writes it and raises the half or full transfer interrupt
+   */
+  void receiveByte(const uint8_t byte) {
+    ring.getBuffer()[RING_SIZE - ndtr] = byte;
+    ndtr--;
+    if (ndtr == 0U) {
+      ndtr = RING_SIZE;
+      serialISR(false);
+    } else if (ndtr == (RING_SIZE / 2U)) {
+      serialISR(false);
+    }
+  }
+
+  /**
+   * @brief Receives bytes without pause followed by an idle line
+   */
+  void receive(const std::vector<uint8_t>& data) {
+    for (const uint8_t byte : data) {
+      receiveByte(byte);
+    }
+    serialISR(true);
+  }
+
+  /**
+   * @brief Serial ISR of the boards (DMA transfer and idle line / receiver timeout interrupt)
+   */
+  void serialISR(const bool idle) {
+    ring.publish(ndtr);
+    if (idle) {
+      frame_sync.markGap(ring.getHead());
+    }
+  }
+
+  /**
+   * @brief Main loop: reads all available data and returns the complete messages
+   */
+  std::vector<std::array<uint8_t, MSG_SIZE>> poll() {
+    std::vector<std::array<uint8_t, MSG_SIZE>> messages;
+
+    for (;;) {
+      if (ring.checkOverrun()) {
+        frame_sync.reset();
+        msg_idx = 0U;
+      }
+
+      if (frame_sync.checkGap(ring.getTail(), msg_idx)) {
+        msg_idx = 0U;
+      }
+
+      uint8_t byte = 0U;
+      if (!ring.pop(byte)) {
+        return messages;
+      }
+
+      msg[msg_idx] = byte;
+      msg_idx++;
+      if (msg_idx >= MSG_SIZE) {
+        messages.push_back(msg);
+        msg_idx = 0U;
+      }
+    }
+  }
+
+  /**
+   * @brief Drops received data like the boards after a baud rate change (ISRs disabled)
+   */
+  void drop() {
+    ring.drop(ndtr);
+    frame_sync.reset();
+    msg_idx = 0U;
+  }
+
+  ext::DmaRxRing<RING_SIZE> ring;
+  ext::FrameSync<16U> frame_sync;
+  uint32_t ndtr = {RING_SIZE};
+
+  std::array<uint8_t, MSG_SIZE> msg = {};
+  uint32_t msg_idx = {0U};
+};
+
+static std::vector<uint8_t> createMsg(const uint8_t seed) {
+  std::vector<uint8_t> data(MSG_SIZE);
+  for (uint32_t idx = 0U; idx < MSG_SIZE; idx++) {
+    data[idx] = static_cast<uint8_t>(seed + idx);
+  }
+  return data;
+}
+
+static std::array<uint8_t, MSG_SIZE> toArray(const std::vector<uint8_t>& data) {
+  std::array<uint8_t, MSG_SIZE> msg = {};
+  std::copy(data.begin(), data.end(), msg.begin());
+  return msg;
+}
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+TEST(DmaRxRing, MessagesAcrossWrapAround) {
+  SimSerial serial;
+
+  for (uint32_t msg_idx = 0U; msg_idx < 100U; msg_idx++) {
+    const auto data = createMsg(static_cast<uint8_t>(msg_idx * 3U));
+    serial.receive(data);
+
+    const auto messages = serial.poll();
+    ASSERT_EQ(messages.size(), 1U);
+    EXPECT_EQ(messages[0U], toArray(data));
+  }
+
+  EXPECT_EQ(serial.ring.getHead(), 100U * MSG_SIZE);
+  EXPECT_EQ(serial.ring.getTail(), 100U * MSG_SIZE);
+}
+
+TEST(DmaRxRing, PublishAtHalfAndFullTransferOnly) {
+  SimSerial serial;
+
+  // Without idle line interrupt only complete halves of the buffer are published
+  for (uint32_t idx = 0U; idx < ((RING_SIZE / 2U) - 1U); idx++) {
+    serial.receiveByte(static_cast<uint8_t>(idx));
+  }
+  EXPECT_EQ(serial.ring.getHead(), 0U);
+
+  serial.receiveByte(0xFFU);
+  EXPECT_EQ(serial.ring.getHead(), RING_SIZE / 2U);
+
+  for (uint32_t idx = 0U; idx < (RING_SIZE / 2U); idx++) {
+    serial.receiveByte(static_cast<uint8_t>(idx));
+  }
+  EXPECT_EQ(serial.ring.getHead(), RING_SIZE);
+  EXPECT_EQ(serial.poll().size(), RING_SIZE / MSG_SIZE);
+}
+
+TEST(DmaRxRing, StalledMainLoopKeepsData) {
+  SimSerial serial;
+
+  // Main loop is stalled (flash erase) while a full buffer of back to back messages is received
+  std::vector<std::vector<uint8_t>> sent;
+  for (uint32_t msg_idx = 0U; msg_idx < (RING_SIZE / MSG_SIZE); msg_idx++) {
+    sent.push_back(createMsg(static_cast<uint8_t>(msg_idx * 16U)));
+    for (const uint8_t byte : sent.back()) {
+      serial.receiveByte(byte);
+    }
+  }
+  serial.serialISR(true);
+
+  const auto messages = serial.poll();
+  ASSERT_EQ(messages.size(), sent.size());
+  for (uint32_t msg_idx = 0U; msg_idx < sent.size(); msg_idx++) {
+    EXPECT_EQ(messages[msg_idx], toArray(sent[msg_idx]));
+  }
+}
+
+TEST(DmaRxRing, OverrunDropsDataAndResyncs) {
+  SimSerial serial;
+
+  // More than the buffer size is received while the main loop is stalled
+  for (uint32_t idx = 0U; idx < (RING_SIZE + RING_SIZE / 2U); idx++) {
+    serial.receiveByte(static_cast<uint8_t>(idx));
+  }
+  serial.serialISR(true);
+
+  EXPECT_TRUE(serial.poll().empty());
+  EXPECT_EQ(serial.ring.getTail(), serial.ring.getHead());
+
+  // Next message after the gap is received
+  const auto data = createMsg(0x40U);
+  serial.receive(data);
+  const auto messages = serial.poll();
+  ASSERT_EQ(messages.size(), 1U);
+  EXPECT_EQ(messages[0U], toArray(data));
+}
+
+TEST(DmaRxRing, IncompleteMessageDroppedAtGap) {
+  SimSerial serial;
+
+  // Lost bytes: the host sent 8 bytes, 3 arrived
+  serial.receive({0x01U, 0x02U, 0x03U});
+  EXPECT_TRUE(serial.poll().empty());
+  EXPECT_EQ(serial.msg_idx, 0U);
+
+  // Next message starts after the gap, not with the 3 bytes of the incomplete one
+  const auto data = createMsg(0x80U);
+  serial.receive(data);
+  const auto messages = serial.poll();
+  ASSERT_EQ(messages.size(), 1U);
+  EXPECT_EQ(messages[0U], toArray(data));
+}
+
+TEST(DmaRxRing, IncompleteMessageDroppedBeforeReading) {
+  SimSerial serial;
+
+  // Main loop reads the incomplete message and the next one in one go
+  serial.receive({0x01U, 0x02U, 0x03U});
+  const auto data = createMsg(0x20U);
+  serial.receive(data);
+
+  const auto messages = serial.poll();
+  ASSERT_EQ(messages.size(), 1U);
+  EXPECT_EQ(messages[0U], toArray(data));
+}
+
+TEST(DmaRxRing, DropDiscardsUnpublishedBytes) {
+  SimSerial serial;
+
+  // Bytes written by the DMA but not published yet (no interrupt) are dropped as well
+  for (uint32_t idx = 0U; idx < 5U; idx++) {
+    serial.receiveByte(0xAAU);
+  }
+  serial.drop();
+
+  const auto data = createMsg(0x10U);
+  serial.receive(data);
+  const auto messages = serial.poll();
+  ASSERT_EQ(messages.size(), 1U);
+  EXPECT_EQ(messages[0U], toArray(data));
+}
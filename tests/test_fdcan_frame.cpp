@@ -0,0 +1,128 @@
+/**
+ * @file test_fdcan_frame.cpp
+ * @author agent (agent@local)
+ * @brief Test of the packing of bootloader messages into CAN-FD frames
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+
+#include <array>
+
+#include "fdcan_frame.h"
+
+// Helpers ------------------------------------------------------------------------------------------------------------
+
+using Frame = std::array<uint8_t, fdcan_frame::MAX_FRAME_SIZE>;
+
+/**
+ * @brief Packs the given number of messages like the FDCAN transport and returns the DLC
+ */
+static uint32_t packMessages(Frame& frame, const uint32_t num_msgs) {
+  frame.fill(0xEEU);
+  for (uint32_t slot_idx = 0U; slot_idx < num_msgs; slot_idx++) {
+    for (uint32_t idx = 0U; idx < fdcan_frame::SLOT_SIZE; idx++) {
+      frame[slot_idx * fdcan_frame::SLOT_SIZE + idx] = static_cast<uint8_t>(slot_idx + 1U);
+    }
+  }
+  return fdcan_frame::padFrame(frame.data(), num_msgs * fdcan_frame::SLOT_SIZE);
+}
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+TEST(FdcanFrame, LengthToDLCRoundsUp) {
+  for (uint32_t length = 0U; length <= fdcan_frame::MAX_FRAME_SIZE; length++) {
+    const uint32_t dlc = fdcan_frame::lengthToDLC(length);
+    EXPECT_GE(fdcan_frame::dlcToLength(dlc), length);
+    if (dlc > 0U) {
+      EXPECT_LT(fdcan_frame::dlcToLength(dlc - 1U), length);
+    }
+  }
+}
+
+TEST(FdcanFrame, PadFrameZerosUpToValidLength) {
+  Frame frame;
+
+  // 5 messages (40 bytes) are transmitted as 48 bytes, 7 messages (56 bytes) as 64 bytes
+  const std::array<std::pair<uint32_t, uint32_t>, 8U> expected = {
+      {{1U, 8U}, {2U, 16U}, {3U, 24U}, {4U, 32U}, {5U, 48U}, {6U, 48U}, {7U, 64U}, {8U, 64U}}};
+
+  for (const auto& [num_msgs, length] : expected) {
+    const uint32_t dlc = packMessages(frame, num_msgs);
+    ASSERT_EQ(fdcan_frame::dlcToLength(dlc), length) << num_msgs << " messages";
+
+    for (uint32_t idx = num_msgs * fdcan_frame::SLOT_SIZE; idx < length; idx++) {
+      EXPECT_EQ(frame[idx], 0U) << "padding byte " << idx;
+    }
+    for (uint32_t idx = length; idx < frame.size(); idx++) {
+      EXPECT_EQ(frame[idx], 0xEEU) << "byte " << idx << " after the frame";
+    }
+  }
+}
+
+TEST(FdcanFrame, CountMsgSlotsOfPaddedFrames) {
+  Frame frame;
+
+  for (uint32_t num_msgs = 1U; num_msgs <= fdcan_frame::MAX_SLOTS; num_msgs++) {
+    const uint32_t dlc = packMessages(frame, num_msgs);
+    EXPECT_EQ(fdcan_frame::countMsgSlots(frame.data(), fdcan_frame::dlcToLength(dlc)), num_msgs);
+  }
+}
+
+TEST(FdcanFrame, CountMsgSlotsStopsAtEmptySlot) {
+  Frame frame = {};
+  frame[0U] = 0x01U;
+  frame[8U] = 0x00U;
+  frame[9U] = 0x02U;  // Request 0x0200
+  frame[24U] = 0x03U;  // Message after an empty slot is ignored
+
+  EXPECT_EQ(fdcan_frame::countMsgSlots(frame.data(), 32U), 2U);
+}
+
+TEST(FdcanFrame, CountMsgSlotsIgnoresPartialSlot) {
+  Frame frame;
+  frame.fill(0x11U);
+
+  EXPECT_EQ(fdcan_frame::countMsgSlots(frame.data(), 0U), 0U);
+  EXPECT_EQ(fdcan_frame::countMsgSlots(frame.data(), 7U), 0U);
+  EXPECT_EQ(fdcan_frame::countMsgSlots(frame.data(), 12U), 1U);
+  EXPECT_EQ(fdcan_frame::countMsgSlots(frame.data(), 20U), 2U);
+  EXPECT_EQ(fdcan_frame::countMsgSlots(frame.data(), 100U), fdcan_frame::MAX_SLOTS);
+}
+
+TEST(FdcanFrame, CountStreamSlotsIgnoresPadding) {
+  Frame frame;
+
+  // Raw blocks and trailer of a page stream, the padding slots must not be taken as blocks
+  for (uint32_t num_blocks = 1U; num_blocks <= fdcan_frame::MAX_SLOTS; num_blocks++) {
+    const uint32_t dlc = packMessages(frame, num_blocks);
+    EXPECT_EQ(fdcan_frame::countStreamSlots(fdcan_frame::dlcToLength(dlc), num_blocks), num_blocks);
+  }
+}
+
+TEST(FdcanFrame, CountStreamSlotsOverSeveralFrames) {
+  Frame frame;
+
+  // 11 raw blocks and the trailer are sent in frames of 8 and 4 blocks
+  uint32_t num_pending = 12U;
+  for (const uint32_t num_blocks : {8U, 4U}) {
+    const uint32_t dlc = packMessages(frame, num_blocks);
+    const uint32_t num_slots = fdcan_frame::countStreamSlots(fdcan_frame::dlcToLength(dlc), num_pending);
+    EXPECT_EQ(num_slots, num_blocks);
+    num_pending -= num_slots;
+  }
+  EXPECT_EQ(num_pending, 0U);
+}
+
+TEST(FdcanFrame, CountStreamSlotsStartingWithZeroBytes) {
+  // Raw blocks may start with zero bytes, they do not end the frame like empty message slots
+  const Frame frame = {};
+  EXPECT_EQ(fdcan_frame::countMsgSlots(frame.data(), 24U), 0U);
+  EXPECT_EQ(fdcan_frame::countStreamSlots(24U, 3U), 3U);
+  EXPECT_EQ(fdcan_frame::countStreamSlots(100U, 20U), fdcan_frame::MAX_SLOTS);
+}
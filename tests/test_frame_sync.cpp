@@ -0,0 +1,267 @@
+/**
+ * @file test_frame_sync.cpp
+ * @author agent (agent@local)
+ * @brief Test of the message framing at idle gaps (partial message drop, resync and gap overrun counters)
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "frame_sync.h"
+
+// Helpers ------------------------------------------------------------------------------------------------------------
+
+constexpr uint32_t MSG_SIZE = {8U};
+constexpr uint32_t NUM_GAPS = {4U};
+
+using Message = std::array<uint8_t, MSG_SIZE>;
+
+/**
+ * Byte stream of the UART ISR and the message reassembly of the main loop
+ */
+class SimStream {
+ public:
+  explicit SimStream(const uint32_t start_cnt = 0U) : _rx_cnt(start_cnt), _read_cnt(start_cnt) {}
+
+  /**
+   * @brief Receives bytes without pause (no gap)
+   */
+  void receive(const std::vector<uint8_t>& data) {
+    _stream.insert(_stream.end(), data.begin(), data.end());
+    _rx_cnt += static_cast<uint32_t>(data.size());
+  }
+
+  /**
+   * @brief Idle line after the received bytes (UART ISR)
+   */
+  void gap() { sync.markGap(_rx_cnt); }
+
+  /**
+   * @brief Main loop: reads all received bytes and returns the complete messages
+   */
+  std::vector<Message> poll() {
+    std::vector<Message> messages;
+
+    for (;;) {
+      if (sync.checkGap(_read_cnt, msg_idx)) {
+        msg_idx = 0U;
+      }
+
+      if (_read_cnt == _rx_cnt) {
+        return messages;
+      }
+
+      _msg[msg_idx] = _stream[_stream.size() - (_rx_cnt - _read_cnt)];
+      _read_cnt++;
+      msg_idx++;
+      if (msg_idx >= MSG_SIZE) {
+        messages.push_back(_msg);
+        msg_idx = 0U;
+      }
+    }
+  }
+
+  /**
+   * @brief Drops all received data like the boards after an overrun or a baud rate change
+   */
+  void drop() {
+    _read_cnt = _rx_cnt;
+    sync.reset();
+    msg_idx = 0U;
+  }
+
+  ext::FrameSync<NUM_GAPS> sync;
+  uint32_t msg_idx = {0U};
+
+ private:
+  std::vector<uint8_t> _stream;
+  uint32_t _rx_cnt;
+  uint32_t _read_cnt;
+  Message _msg = {};
+};
+
+static std::vector<uint8_t> createMsg(const uint8_t seed, const uint32_t size = MSG_SIZE) {
+  std::vector<uint8_t> data(size);
+  for (uint32_t idx = 0U; idx < size; idx++) {
+    data[idx] = static_cast<uint8_t>(seed + idx);
+  }
+  return data;
+}
+
+static Message toMessage(const std::vector<uint8_t>& data) {
+  Message msg = {};
+  std::copy(data.begin(), data.end(), msg.begin());
+  return msg;
+}
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+TEST(FrameSync, GapAfterCompleteMessageIsNoResync) {
+  SimStream stream;
+
+  for (uint8_t seed = 0U; seed < 3U; seed++) {
+    stream.receive(createMsg(seed * 0x10U));
+    stream.gap();
+  }
+
+  const auto messages = stream.poll();
+  ASSERT_EQ(messages.size(), 3U);
+  EXPECT_EQ(messages[2U], toMessage(createMsg(0x20U)));
+  EXPECT_EQ(stream.sync.getNumGaps(), 3U);
+  EXPECT_EQ(stream.sync.getNumResyncs(), 0U);
+}
+
+TEST(FrameSync, BackToBackMessagesAreSplitBySize) {
+  SimStream stream;
+
+  for (uint8_t seed = 0U; seed < 4U; seed++) {
+    stream.receive(createMsg(seed * 0x10U));
+  }
+  stream.gap();
+
+  const auto messages = stream.poll();
+  ASSERT_EQ(messages.size(), 4U);
+  for (uint8_t seed = 0U; seed < 4U; seed++) {
+    EXPECT_EQ(messages[seed], toMessage(createMsg(seed * 0x10U)));
+  }
+  EXPECT_EQ(stream.sync.getNumResyncs(), 0U);
+}
+
+TEST(FrameSync, PartialMessageDroppedAtGap) {
+  SimStream stream;
+
+  // Host sent 8 bytes, 3 arrived
+  stream.receive(createMsg(0xA0U, 3U));
+  stream.gap();
+  stream.receive(createMsg(0x10U));
+  stream.gap();
+
+  const auto messages = stream.poll();
+  ASSERT_EQ(messages.size(), 1U);
+  EXPECT_EQ(messages[0U], toMessage(createMsg(0x10U)));
+  EXPECT_EQ(stream.sync.getNumResyncs(), 1U);
+  EXPECT_EQ(stream.msg_idx, 0U);
+}
+
+TEST(FrameSync, PartialMessageAfterBackToBackMessages) {
+  SimStream stream;
+
+  // Request window: two complete messages and the first 5 bytes of a third one before the gap
+  stream.receive(createMsg(0x00U));
+  stream.receive(createMsg(0x10U));
+  stream.receive(createMsg(0x20U, 5U));
+  stream.gap();
+  stream.receive(createMsg(0x30U));
+  stream.gap();
+
+  const auto messages = stream.poll();
+  ASSERT_EQ(messages.size(), 3U);
+  EXPECT_EQ(messages[0U], toMessage(createMsg(0x00U)));
+  EXPECT_EQ(messages[1U], toMessage(createMsg(0x10U)));
+  EXPECT_EQ(messages[2U], toMessage(createMsg(0x30U)));
+  EXPECT_EQ(stream.sync.getNumResyncs(), 1U);
+}
+
+TEST(FrameSync, GapAfterBytesAlreadyRead) {
+  SimStream stream;
+
+  // Main loop reads the partial message before the UART detects the idle line
+  stream.receive(createMsg(0xA0U, 6U));
+  EXPECT_TRUE(stream.poll().empty());
+  EXPECT_EQ(stream.msg_idx, 6U);
+
+  stream.gap();
+  stream.receive(createMsg(0x40U));
+  stream.gap();
+
+  const auto messages = stream.poll();
+  ASSERT_EQ(messages.size(), 1U);
+  EXPECT_EQ(messages[0U], toMessage(createMsg(0x40U)));
+  EXPECT_EQ(stream.sync.getNumResyncs(), 1U);
+}
+
+TEST(FrameSync, RepeatedGapAtSamePositionResyncsOnce) {
+  SimStream stream;
+
+  // Idle line and receiver timeout at the same position
+  stream.receive(createMsg(0xA0U, 2U));
+  stream.gap();
+  stream.gap();
+  stream.receive(createMsg(0x50U));
+  stream.gap();
+
+  const auto messages = stream.poll();
+  ASSERT_EQ(messages.size(), 1U);
+  EXPECT_EQ(messages[0U], toMessage(createMsg(0x50U)));
+  EXPECT_EQ(stream.sync.getNumGaps(), 3U);
+  EXPECT_EQ(stream.sync.getNumResyncs(), 1U);
+}
+
+TEST(FrameSync, DropDiscardsRecordedGaps) {
+  SimStream stream;
+
+  stream.receive(createMsg(0xA0U, 3U));
+  stream.gap();
+  stream.drop();
+
+  stream.receive(createMsg(0x60U));
+  stream.gap();
+
+  const auto messages = stream.poll();
+  ASSERT_EQ(messages.size(), 1U);
+  EXPECT_EQ(messages[0U], toMessage(createMsg(0x60U)));
+  EXPECT_EQ(stream.sync.getNumResyncs(), 0U);
+}
+
+TEST(FrameSync, GapOverrunIsCountedAndRecovers) {
+  SimStream stream;
+
+  // Main loop stalled: more gaps than buffered, the last partial message is not detected
+  for (uint8_t seed = 0U; seed < NUM_GAPS; seed++) {
+    stream.receive(createMsg(seed * 0x10U));
+    stream.gap();
+  }
+  stream.receive(createMsg(0xA0U, 3U));
+  stream.gap();
+  EXPECT_EQ(stream.sync.getNumGaps(), NUM_GAPS);
+  EXPECT_EQ(stream.sync.getNumGapOverruns(), 1U);
+
+  EXPECT_EQ(stream.poll().size(), NUM_GAPS);
+  EXPECT_EQ(stream.msg_idx, 3U);
+
+  // Messages are misaligned up to the next recorded gap, where the framing resyncs
+  stream.receive(createMsg(0x70U));
+  stream.gap();
+  stream.receive(createMsg(0x80U));
+  stream.gap();
+
+  const auto messages = stream.poll();
+  ASSERT_EQ(messages.size(), 2U);
+  EXPECT_NE(messages[0U], toMessage(createMsg(0x70U)));
+  EXPECT_EQ(messages[1U], toMessage(createMsg(0x80U)));
+  EXPECT_EQ(stream.sync.getNumResyncs(), 1U);
+  EXPECT_EQ(stream.msg_idx, 0U);
+}
+
+TEST(FrameSync, PartialMessageDroppedAcrossCounterWrapAround) {
+  SimStream stream(0xFFFFFFFCU);
+
+  stream.receive(createMsg(0xA0U, 6U));
+  stream.gap();
+  stream.receive(createMsg(0x90U));
+  stream.gap();
+
+  const auto messages = stream.poll();
+  ASSERT_EQ(messages.size(), 1U);
+  EXPECT_EQ(messages[0U], toMessage(createMsg(0x90U)));
+  EXPECT_EQ(stream.sync.getNumResyncs(), 1U);
+}
@@ -0,0 +1,186 @@
+/**
+ * @file test_isr_queue.cpp
+ * @author agent (agent@local)
+ * @brief Test of the queue between main loop and ISR (index arithmetic, TX drop and RX overrun handling)
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "isr_queue.h"
+
+// Helpers ------------------------------------------------------------------------------------------------------------
+
+constexpr uint32_t QUEUE_SIZE = {8U};
+
+using TestQueue = ext::IsrQueue<uint32_t, QUEUE_SIZE>;
+
+/**
+ * Response path of the L431: TX queue in front of three CAN TX mailboxes, a response is dropped if no slot
+ * gets free before the timeout
+ */
+class SimCanTx {
+ public:
+  static constexpr uint32_t NUM_MAILBOXES = {3U};
+
+  /**
+   * @brief Queues response like transmitResponse() (a stalled bus never frees a slot within the timeout)
+   */
+  void transmit(const uint32_t frame) {
+    if (queue.isFull()) {
+      num_dropped++;
+      return;
+    }
+
+    queue.push(frame);
+    fillMailboxes();
+  }
+
+  /**
+   * @brief Moves queued frames into empty mailboxes like txQueueFillMailboxes()
+   */
+  void fillMailboxes() {
+    while (!queue.isEmpty() && (mailboxes.size() < NUM_MAILBOXES)) {
+      mailboxes.push_back(queue.front());
+      queue.pop();
+    }
+  }
+
+  /**
+   * @brief Bus transmits all mailboxes, the TX ISR refills them
+   */
+  void busIdle() {
+    while (!mailboxes.empty()) {
+      transmitted.insert(transmitted.end(), mailboxes.begin(), mailboxes.end());
+      mailboxes.clear();
+      fillMailboxes();
+    }
+  }
+
+  ext::IsrQueue<uint32_t, QUEUE_SIZE> queue;
+  std::vector<uint32_t> mailboxes;
+  std::vector<uint32_t> transmitted;
+  uint32_t num_dropped = {0U};
+};
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+TEST(IsrQueue, EmptyAndFull) {
+  TestQueue queue;
+  EXPECT_TRUE(queue.isEmpty());
+  EXPECT_FALSE(queue.isFull());
+  EXPECT_EQ(queue.getNumQueued(), 0U);
+
+  for (uint32_t idx = 0U; idx < QUEUE_SIZE; idx++) {
+    EXPECT_TRUE(queue.push(idx));
+  }
+  EXPECT_TRUE(queue.isFull());
+  EXPECT_EQ(queue.getNumQueued(), QUEUE_SIZE);
+
+  // All slots are usable, the element pushed to a full queue is not queued
+  EXPECT_FALSE(queue.push(100U));
+  EXPECT_EQ(queue.getNumQueued(), QUEUE_SIZE);
+
+  for (uint32_t idx = 0U; idx < QUEUE_SIZE; idx++) {
+    ASSERT_FALSE(queue.isEmpty());
+    EXPECT_EQ(queue.front(), idx);
+    queue.pop();
+  }
+  EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST(IsrQueue, OrderAcrossSlotWrapAround) {
+  TestQueue queue;
+  uint32_t next_push = 0U;
+  uint32_t next_pop = 0U;
+
+  // Fill level moves between 1 and QUEUE_SIZE, the counters pass the end of the buffer many times
+  for (uint32_t round = 0U; round < 100U; round++) {
+    while (!queue.isFull()) {
+      queue.back() = next_push;
+      queue.push();
+      next_push++;
+    }
+
+    const uint32_t num_pop = 1U + (round % (QUEUE_SIZE - 1U));
+    for (uint32_t idx = 0U; idx < num_pop; idx++) {
+      ASSERT_EQ(queue.front(), next_pop);
+      queue.pop();
+      next_pop++;
+    }
+    EXPECT_EQ(queue.getNumQueued(), next_push - next_pop);
+  }
+}
+
+TEST(IsrQueue, ClearAndReset) {
+  TestQueue queue;
+  for (uint32_t idx = 0U; idx < 5U; idx++) {
+    queue.push(idx);
+  }
+  queue.pop();
+
+  // Consumer drops the pending elements (e.g. responses of a previous node ID), producer continues
+  queue.clear();
+  EXPECT_TRUE(queue.isEmpty());
+  queue.push(42U);
+  EXPECT_EQ(queue.getNumQueued(), 1U);
+  EXPECT_EQ(queue.front(), 42U);
+
+  queue.reset();
+  EXPECT_TRUE(queue.isEmpty());
+  EXPECT_EQ(queue.getNumQueued(), 0U);
+}
+
+TEST(IsrQueue, TxQueueDropsOnStalledBus) {
+  SimCanTx tx;
+
+  // Nobody acknowledges: three frames wait in the mailboxes, QUEUE_SIZE in the queue, the rest is dropped
+  for (uint32_t frame = 0U; frame < 20U; frame++) {
+    tx.transmit(frame);
+  }
+  EXPECT_EQ(tx.mailboxes.size(), SimCanTx::NUM_MAILBOXES);
+  EXPECT_TRUE(tx.queue.isFull());
+  EXPECT_EQ(tx.num_dropped, 20U - SimCanTx::NUM_MAILBOXES - QUEUE_SIZE);
+
+  // Queued frames are sent in order once the bus recovers, the queue accepts frames again
+  tx.busIdle();
+  ASSERT_EQ(tx.transmitted.size(), SimCanTx::NUM_MAILBOXES + QUEUE_SIZE);
+  for (uint32_t idx = 0U; idx < tx.transmitted.size(); idx++) {
+    EXPECT_EQ(tx.transmitted[idx], idx);
+  }
+
+  tx.transmit(100U);
+  tx.busIdle();
+  EXPECT_EQ(tx.transmitted.back(), 100U);
+  EXPECT_TRUE(tx.queue.isEmpty());
+}
+
+TEST(IsrQueue, RxRingKeepsOldestFramesOnOverrun) {
+  TestQueue ring;
+  uint32_t num_overruns = 0U;
+
+  // RX ISR while the main loop is blocked: frames received after the ring is full are counted and lost
+  for (uint32_t frame = 0U; frame < (QUEUE_SIZE + 3U); frame++) {
+    if (!ring.isFull()) {
+      ring.back() = frame;
+      ring.push();
+    } else {
+      num_overruns++;
+    }
+  }
+  EXPECT_EQ(num_overruns, 3U);
+
+  for (uint32_t idx = 0U; idx < QUEUE_SIZE; idx++) {
+    ASSERT_FALSE(ring.isEmpty());
+    EXPECT_EQ(ring.front(), idx);
+    ring.pop();
+  }
+  EXPECT_TRUE(ring.isEmpty());
+}
@@ -0,0 +1,270 @@
+/**
+ * @file test_node_id.cpp
+ * @author agent (agent@local)
+ * @brief Test of the node ID assignment (default node ID, stored records, limits of the write once storage)
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+
+#include <array>
+
+#include "node_id.h"
+
+using namespace franklyboot;
+
+// Helpers ------------------------------------------------------------------------------------------------------------
+
+constexpr uint32_t NUM_NODE_IDS = {63U};
+constexpr uint32_t NUM_RECORDS = {4U};
+constexpr uint32_t UID_HASH = {0x12345678U};
+constexpr uint32_t DEFAULT_NODE_ID = {1U};
+
+using TestNodeID = ext::NodeID<NUM_NODE_IDS, NUM_RECORDS>;
+
+/**
+ * Write once record memory (erased: all bits set)
+ */
+struct SimRecords {
+  SimRecords() {
+    for (auto& record : records) {
+      record = {0xFFFFFFFFU, 0xFFFFFFFFU};
+    }
+  }
+
+  /**
+   * @brief Executes an assignment like the board
+   *
+   * @return Response to the assignment
+   */
+  msg::Msg assign(TestNodeID& node_id, const uint8_t node, const uint32_t uid_hash = UID_HASH) {
+    const msg::Msg request = ext::createResponse(ext::REQ_EXT_NODE_ID_ASSIGN, msg::RES_NONE, node, uid_hash);
+    last_action = node_id.processBroadcast(request);
+
+    bool applied = (last_action == TestNodeID::ASSIGN_APPLY);
+    if (last_action == TestNodeID::ASSIGN_STORE) {
+      uint32_t record_idx = 0U;
+      ext::NodeIDRecord record = {};
+      node_id.getRecord(record_idx, record);
+      EXPECT_EQ(records[record_idx].magic, 0xFFFFFFFFU);
+      records[record_idx] = record;
+      num_stores++;
+      applied = true;
+    }
+
+    return node_id.finishAssignment(applied);
+  }
+
+  std::array<ext::NodeIDRecord, NUM_RECORDS> records;
+  TestNodeID::AssignAction last_action = {TestNodeID::ASSIGN_NONE};
+  uint32_t num_stores = {0U};
+};
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+TEST(NodeID, DefaultWithoutStoredRecord) {
+  SimRecords sim;
+  TestNodeID node_id;
+
+  EXPECT_EQ(node_id.load(sim.records.data(), UID_HASH, DEFAULT_NODE_ID), DEFAULT_NODE_ID);
+  EXPECT_EQ(node_id.load(nullptr, UID_HASH, 42U), 42U);
+}
+
+TEST(NodeID, AssignmentOfOtherNodeIsIgnored) {
+  SimRecords sim;
+  TestNodeID node_id;
+  node_id.load(sim.records.data(), UID_HASH, DEFAULT_NODE_ID);
+
+  sim.assign(node_id, 5U, UID_HASH + 1U);
+  EXPECT_EQ(sim.last_action, TestNodeID::ASSIGN_IGNORE);
+  EXPECT_EQ(node_id.getNodeID(), DEFAULT_NODE_ID);
+
+  const msg::Msg other = ext::createResponse(ext::REQ_EXT_DISCOVER, msg::RES_NONE, 0U, 0U);
+  EXPECT_EQ(node_id.processBroadcast(other), TestNodeID::ASSIGN_NONE);
+}
+
+TEST(NodeID, AssignmentWithoutStorageHoldsUntilReset) {
+  TestNodeID node_id;
+  node_id.load(nullptr, UID_HASH, DEFAULT_NODE_ID);
+
+  SimRecords sim;
+  const msg::Msg response = sim.assign(node_id, 7U);
+  EXPECT_EQ(sim.last_action, TestNodeID::ASSIGN_APPLY);
+  EXPECT_EQ(response.result, msg::RES_OK);
+  EXPECT_EQ(response.packet_id, 7U);
+  EXPECT_EQ(ext::getDataWord(response), UID_HASH);
+  EXPECT_EQ(node_id.getNodeID(), 7U);
+
+  EXPECT_EQ(node_id.load(nullptr, UID_HASH, DEFAULT_NODE_ID), DEFAULT_NODE_ID);
+}
+
+TEST(NodeID, StoredAssignmentIsLoaded) {
+  SimRecords sim;
+  TestNodeID node_id;
+  node_id.load(sim.records.data(), UID_HASH, DEFAULT_NODE_ID);
+
+  const msg::Msg response = sim.assign(node_id, 9U);
+  EXPECT_EQ(sim.last_action, TestNodeID::ASSIGN_STORE);
+  EXPECT_EQ(response.result, msg::RES_OK);
+  EXPECT_EQ(node_id.getNodeID(), 9U);
+
+  TestNodeID rebooted;
+  EXPECT_EQ(rebooted.load(sim.records.data(), UID_HASH, DEFAULT_NODE_ID), 9U);
+
+  // Return to the default node ID takes a record as well
+  sim.assign(rebooted, static_cast<uint8_t>(ext::NODE_ID_DEFAULT));
+  EXPECT_EQ(sim.last_action, TestNodeID::ASSIGN_STORE);
+  EXPECT_EQ(rebooted.getNodeID(), DEFAULT_NODE_ID);
+
+  TestNodeID rebooted_again;
+  EXPECT_EQ(rebooted_again.load(sim.records.data(), UID_HASH, DEFAULT_NODE_ID), DEFAULT_NODE_ID);
+  EXPECT_EQ(sim.num_stores, 2U);
+}
+
+TEST(NodeID, UnchangedAssignmentIsNotStored) {
+  SimRecords sim;
+  TestNodeID node_id;
+  node_id.load(sim.records.data(), UID_HASH, DEFAULT_NODE_ID);
+
+  // Default node ID without record and the stored node ID after the next reset
+  sim.assign(node_id, static_cast<uint8_t>(ext::NODE_ID_DEFAULT));
+  EXPECT_EQ(sim.last_action, TestNodeID::ASSIGN_APPLY);
+
+  sim.assign(node_id, 3U);
+  TestNodeID rebooted;
+  rebooted.load(sim.records.data(), UID_HASH, DEFAULT_NODE_ID);
+  const msg::Msg response = sim.assign(rebooted, 3U);
+  EXPECT_EQ(sim.last_action, TestNodeID::ASSIGN_APPLY);
+  EXPECT_EQ(response.result, msg::RES_OK);
+  EXPECT_EQ(sim.num_stores, 1U);
+}
+
+TEST(NodeID, OneStorePerPowerCycle) {
+  SimRecords sim;
+  TestNodeID node_id;
+  node_id.load(sim.records.data(), UID_HASH, DEFAULT_NODE_ID);
+
+  sim.assign(node_id, 3U);
+  const msg::Msg response = sim.assign(node_id, 4U);
+  EXPECT_EQ(sim.last_action, TestNodeID::ASSIGN_REJECT);
+  EXPECT_EQ(response.result, msg::RES_ERR);
+  EXPECT_EQ(response.packet_id, 3U);
+  EXPECT_EQ(node_id.getNodeID(), 3U);
+  EXPECT_EQ(sim.num_stores, TestNodeID::MAX_STORES_PER_BOOT);
+}
+
+TEST(NodeID, AllRecordsUsed) {
+  SimRecords sim;
+
+  for (uint32_t idx = 0U; idx < NUM_RECORDS; idx++) {
+    TestNodeID node_id;
+    node_id.load(sim.records.data(), UID_HASH, DEFAULT_NODE_ID);
+    sim.assign(node_id, static_cast<uint8_t>(10U + idx));
+    EXPECT_EQ(sim.last_action, TestNodeID::ASSIGN_STORE);
+  }
+
+  TestNodeID node_id;
+  EXPECT_EQ(node_id.load(sim.records.data(), UID_HASH, DEFAULT_NODE_ID), 10U + NUM_RECORDS - 1U);
+  const msg::Msg response = sim.assign(node_id, 20U);
+  EXPECT_EQ(sim.last_action, TestNodeID::ASSIGN_REJECT);
+  EXPECT_EQ(response.result, msg::RES_ERR);
+  EXPECT_EQ(node_id.getNodeID(), 10U + NUM_RECORDS - 1U);
+}
+
+TEST(NodeID, InvalidNodeIDIsRejected) {
+  SimRecords sim;
+  TestNodeID node_id;
+  node_id.load(sim.records.data(), UID_HASH, DEFAULT_NODE_ID);
+
+  sim.assign(node_id, static_cast<uint8_t>(NUM_NODE_IDS));
+  EXPECT_EQ(sim.last_action, TestNodeID::ASSIGN_REJECT);
+  EXPECT_EQ(node_id.getNodeID(), DEFAULT_NODE_ID);
+  EXPECT_EQ(sim.num_stores, 0U);
+}
+
+TEST(NodeID, InterruptedRecordIsSkipped) {
+  SimRecords sim;
+  sim.records[0U] = {ext::NODE_ID_RECORD_MAGIC, 5U | ((~5U & 0xFFFFU) << 16U)};
+  sim.records[1U] = {ext::NODE_ID_RECORD_MAGIC, 0xFFFFFFFFU};
+
+  TestNodeID node_id;
+  EXPECT_EQ(node_id.load(sim.records.data(), UID_HASH, DEFAULT_NODE_ID), 5U);
+
+  // Next assignment takes the record after the interrupted one
+  sim.assign(node_id, 6U);
+  EXPECT_EQ(sim.records[2U].value & 0xFFFFU, 6U);
+}
+
+TEST(NodeID, LastValidRecordIsUsed) {
+  SimRecords sim;
+  sim.records[0U] = {ext::NODE_ID_RECORD_MAGIC, 5U | ((~5U & 0xFFFFU) << 16U)};
+  sim.records[1U] = {ext::NODE_ID_RECORD_MAGIC, 8U | ((~8U & 0xFFFFU) << 16U)};
+  sim.records[2U] = {0x12345678U, 9U | ((~9U & 0xFFFFU) << 16U)};
+  sim.records[3U] = {ext::NODE_ID_RECORD_MAGIC, 9U | ((~10U & 0xFFFFU) << 16U)};
+
+  // Records with wrong magic or complement are skipped, but count as used
+  TestNodeID node_id;
+  EXPECT_EQ(node_id.load(sim.records.data(), UID_HASH, DEFAULT_NODE_ID), 8U);
+  sim.assign(node_id, 11U);
+  EXPECT_EQ(sim.last_action, TestNodeID::ASSIGN_REJECT);
+  EXPECT_EQ(node_id.getNodeID(), 8U);
+}
+
+TEST(NodeID, ScanStopsAtErasedRecord) {
+  SimRecords sim;
+  sim.records[0U] = {ext::NODE_ID_RECORD_MAGIC, 5U | ((~5U & 0xFFFFU) << 16U)};
+  sim.records[2U] = {ext::NODE_ID_RECORD_MAGIC, 7U | ((~7U & 0xFFFFU) << 16U)};
+
+  // Records after the first erased record are not used, the next assignment takes the erased record
+  TestNodeID node_id;
+  EXPECT_EQ(node_id.load(sim.records.data(), UID_HASH, DEFAULT_NODE_ID), 5U);
+
+  uint32_t record_idx = 0U;
+  ext::NodeIDRecord record = {};
+  const msg::Msg request = ext::createResponse(ext::REQ_EXT_NODE_ID_ASSIGN, msg::RES_NONE, 6U, UID_HASH);
+  EXPECT_EQ(node_id.processBroadcast(request), TestNodeID::ASSIGN_STORE);
+  node_id.getRecord(record_idx, record);
+  EXPECT_EQ(record_idx, 1U);
+  EXPECT_EQ(record.magic, ext::NODE_ID_RECORD_MAGIC);
+  EXPECT_EQ(record.value, 6U | ((~6U & 0xFFFFU) << 16U));
+}
+
+TEST(NodeID, StoredNodeIDOutOfRangeUsesDefault) {
+  SimRecords sim;
+  sim.records[0U] = {ext::NODE_ID_RECORD_MAGIC, NUM_NODE_IDS | ((~NUM_NODE_IDS & 0xFFFFU) << 16U)};
+
+  TestNodeID node_id;
+  EXPECT_EQ(node_id.load(sim.records.data(), UID_HASH, DEFAULT_NODE_ID), DEFAULT_NODE_ID);
+
+  // Default node ID is stored already: no further record is needed to return to it
+  sim.assign(node_id, static_cast<uint8_t>(ext::NODE_ID_DEFAULT));
+  EXPECT_EQ(sim.last_action, TestNodeID::ASSIGN_APPLY);
+}
+
+TEST(NodeID, FailedStoreKeepsNodeIDAndUsesRecord) {
+  SimRecords sim;
+  TestNodeID node_id;
+  node_id.load(sim.records.data(), UID_HASH, DEFAULT_NODE_ID);
+
+  const msg::Msg request = ext::createResponse(ext::REQ_EXT_NODE_ID_ASSIGN, msg::RES_NONE, 4U, UID_HASH);
+  EXPECT_EQ(node_id.processBroadcast(request), TestNodeID::ASSIGN_STORE);
+  const msg::Msg response = node_id.finishAssignment(false);
+  EXPECT_EQ(response.result, msg::RES_ERR);
+  EXPECT_EQ(response.packet_id, DEFAULT_NODE_ID);
+  EXPECT_EQ(node_id.getNodeID(), DEFAULT_NODE_ID);
+
+  // Failed store counts for the power cycle, the next boot takes the record after the failed one
+  EXPECT_EQ(node_id.processBroadcast(request), TestNodeID::ASSIGN_REJECT);
+
+  sim.records[0U] = {ext::NODE_ID_RECORD_MAGIC, 0xFFFFFFFFU};
+  TestNodeID rebooted;
+  EXPECT_EQ(rebooted.load(sim.records.data(), UID_HASH, DEFAULT_NODE_ID), DEFAULT_NODE_ID);
+  sim.assign(rebooted, 4U);
+  EXPECT_EQ(sim.last_action, TestNodeID::ASSIGN_STORE);
+  EXPECT_EQ(sim.records[1U].value & 0xFFFFU, 4U);
+}
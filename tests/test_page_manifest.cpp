@@ -0,0 +1,181 @@
+/**
+ * @file test_page_manifest.cpp
+ * @author agent (agent@local)
+ * @brief Test of the per-page CRC manifest against a simulated application flash
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "page_manifest.h"
+
+// Simulated Flash ----------------------------------------------------------------------------------------------------
+
+constexpr uint32_t APP_START_ADDR = {0x10004000U};
+constexpr uint32_t PAGE_SIZE = {256U};
+constexpr uint32_t NUM_PAGES = {16U};
+
+using Manifest = ext::PageManifest<APP_START_ADDR, PAGE_SIZE, NUM_PAGES>;
+
+/**
+ * Application flash with the application CRC word in the last 4 bytes
+ */
+class SimFlash {
+ public:
+  explicit SimFlash(const uint32_t seed) : bytes(PAGE_SIZE * NUM_PAGES) {
+    std::mt19937 rng(seed);
+    for (uint8_t& byte : bytes) {
+      byte = static_cast<uint8_t>(rng());
+    }
+    writeAppCRC();
+  }
+
+  void writeAppCRC() {
+    const uint32_t app_crc = getZlibAppCRC();
+    memcpy(&bytes[bytes.size() - 4U], &app_crc, sizeof(app_crc));
+  }
+
+  uint32_t getAppCRC() const {
+    uint32_t app_crc = 0U;
+    memcpy(&app_crc, &bytes[bytes.size() - 4U], sizeof(app_crc));
+    return app_crc;
+  }
+
+  uint32_t getZlibAppCRC() const { return static_cast<uint32_t>(::crc32(0UL, bytes.data(), bytes.size() - 4U)); }
+
+  /**
+   * @brief CRC function of the boards: CRC-32 of (address, length), counts the hashed pages
+   */
+  uint32_t calcCRC(const uint32_t address, const uint32_t length) {
+    hashed_addresses.push_back(address);
+    return crc::calculate(&bytes[address - APP_START_ADDR], length);
+  }
+
+  auto getCalcCRC() {
+    return [this](const uint32_t address, const uint32_t length) { return calcCRC(address, length); };
+  }
+
+  std::vector<uint8_t> bytes;
+  std::vector<uint32_t> hashed_addresses;
+};
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+TEST(PageManifest, CombinedPageCRCsMatchZlib) {
+  for (uint32_t seed = 0U; seed < 20U; seed++) {
+    SimFlash flash(seed);
+    Manifest manifest;
+    const Manifest::Data& data = manifest.update(flash.getCalcCRC());
+
+    EXPECT_EQ(Manifest::combinePageCRCs(data), flash.getZlibAppCRC());
+    EXPECT_EQ(Manifest::combinePageCRCs(data), flash.getAppCRC());
+  }
+}
+
+TEST(PageManifest, UpdateHashesOnlyUnknownPages) {
+  SimFlash flash(1U);
+  Manifest manifest;
+
+  const Manifest::Data stored = manifest.update(flash.getCalcCRC());
+  EXPECT_EQ(flash.hashed_addresses.size(), NUM_PAGES);
+  EXPECT_TRUE(Manifest::isValid(stored));
+  EXPECT_FALSE(manifest.isDirty());
+
+  // Next update session: two pages are written, the stored manifest is invalidated with the first change
+  Manifest next;
+  ASSERT_TRUE(next.load(stored));
+  EXPECT_FALSE(next.isDirty());
+  flash.bytes[3U * PAGE_SIZE] ^= 0x01U;
+  flash.bytes[(NUM_PAGES - 1U) * PAGE_SIZE] ^= 0x01U;
+  flash.writeAppCRC();
+  EXPECT_TRUE(next.invalidatePage(3U));
+  EXPECT_FALSE(next.invalidatePage(NUM_PAGES - 1U));
+  EXPECT_TRUE(next.isDirty());
+
+  flash.hashed_addresses.clear();
+  const Manifest::Data& updated = next.update(flash.getCalcCRC());
+  const std::vector<uint32_t> expected = {Manifest::getPageAddress(3U), Manifest::getPageAddress(NUM_PAGES - 1U)};
+  EXPECT_EQ(flash.hashed_addresses, expected);
+  EXPECT_EQ(Manifest::combinePageCRCs(updated), flash.getAppCRC());
+  EXPECT_TRUE(Manifest::verify(updated, flash.getAppCRC(), flash.getCalcCRC(), 0U, NUM_PAGES));
+}
+
+TEST(PageManifest, LoadOfInvalidManifestMarksAllPagesUnknown) {
+  SimFlash flash(2U);
+  Manifest manifest;
+  Manifest::Data erased;
+  memset(&erased, 0xFF, sizeof(erased));
+
+  EXPECT_FALSE(manifest.load(erased));
+  EXPECT_TRUE(manifest.isDirty());
+  manifest.update(flash.getCalcCRC());
+  EXPECT_EQ(flash.hashed_addresses.size(), NUM_PAGES);
+}
+
+TEST(PageManifest, VerifyAcceptsMatchingApplication) {
+  SimFlash flash(3U);
+  Manifest manifest;
+  const Manifest::Data data = manifest.update(flash.getCalcCRC());
+
+  flash.hashed_addresses.clear();
+  EXPECT_TRUE(Manifest::verify(data, flash.getAppCRC(), flash.getCalcCRC(), 1234U, 8U));
+  EXPECT_EQ(flash.hashed_addresses.size(), 8U);
+}
+
+TEST(PageManifest, VerifyRejectsCorruptedManifest) {
+  SimFlash flash(4U);
+  Manifest manifest;
+  const Manifest::Data data = manifest.update(flash.getCalcCRC());
+
+  // Every changed bit of the stored manifest is detected by the manifest CRC
+  for (uint32_t byte_idx = 0U; byte_idx < sizeof(Manifest::Data); byte_idx++) {
+    Manifest::Data corrupted = data;
+    reinterpret_cast<uint8_t*>(&corrupted)[byte_idx] ^= 0x10U;
+    EXPECT_FALSE(Manifest::verify(corrupted, flash.getAppCRC(), flash.getCalcCRC(), 0U, 0U)) << "byte " << byte_idx;
+  }
+}
+
+TEST(PageManifest, VerifyRejectsOtherApplicationCRC) {
+  SimFlash flash(5U);
+  Manifest manifest;
+  const Manifest::Data data = manifest.update(flash.getCalcCRC());
+
+  // Application written without updating the manifest (e.g. by a debugger)
+  flash.bytes[PAGE_SIZE + 7U] ^= 0x80U;
+  flash.writeAppCRC();
+  EXPECT_FALSE(Manifest::verify(data, flash.getAppCRC(), flash.getCalcCRC(), 0U, 0U));
+}
+
+TEST(PageManifest, VerifySamplesDetectChangedPage) {
+  SimFlash flash(6U);
+  Manifest manifest;
+  const Manifest::Data data = manifest.update(flash.getCalcCRC());
+
+  // Page changed, application CRC word not updated: only detected if the page is sampled
+  flash.bytes[5U * PAGE_SIZE + 17U] ^= 0x04U;
+
+  uint32_t num_detected = 0U;
+  for (uint32_t seed = 0U; seed < 1000U; seed++) {
+    flash.hashed_addresses.clear();
+    const bool valid = Manifest::verify(data, flash.getAppCRC(), flash.getCalcCRC(), seed, 4U);
+    const bool sampled = std::find(flash.hashed_addresses.begin(), flash.hashed_addresses.end(),
+                                   Manifest::getPageAddress(5U)) != flash.hashed_addresses.end();
+    EXPECT_EQ(valid, !sampled) << "seed " << seed;
+    num_detected += valid ? 0U : 1U;
+  }
+
+  // 4 of 16 pages are sampled: about 1 - (15/16)^4 = 23 % of the boots detect the change
+  EXPECT_GT(num_detected, 150U);
+  EXPECT_LT(num_detected, 320U);
+}
@@ -0,0 +1,462 @@
+/**
+ * @file test_page_patch.cpp
+ * @author agent (agent@local)
+ * @brief Test of the patch applier with patches of tools/franklyboot_patch.py against a simulated flash
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ * The patches are generated by the patch tool (PYTHON_EXECUTABLE, PATCH_TOOL), applied with PagePatch and
+ * the resulting flash is compared bit-exactly with the new image.
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "crc32.h"
+#include "page_patch.h"
+
+using namespace franklyboot;
+
+// Simulated Device ---------------------------------------------------------------------------------------------------
+
+// Flash and RAM are mapped to 32 bit addresses, the applier passes addresses of both to the CRC function
+constexpr uint32_t FLASH_START_ADDR = {0x08000000U};
+constexpr uint32_t RAM_START_ADDR = {0x20000000U};
+constexpr uint32_t APP_FIRST_PAGE = {4U};
+constexpr uint32_t PAGE_SIZE = {1024U};
+constexpr uint32_t FLASH_SIZE = {16U * PAGE_SIZE};
+constexpr uint32_t APP_SIZE = {FLASH_SIZE - APP_FIRST_PAGE * PAGE_SIZE};
+
+using TestPagePatch = ext::PagePatch<FLASH_START_ADDR, APP_FIRST_PAGE, FLASH_SIZE, PAGE_SIZE>;
+
+static uint32_t num_erased_pages = {0U};  // Erase counter of the simulated flash
+
+namespace franklyboot::hwi {
+
+uint32_t calculateCRC(const uint32_t src_address, const uint32_t num_bytes) {
+  return crc::calculate(reinterpret_cast<const uint8_t*>(static_cast<uintptr_t>(src_address)), num_bytes);
+}
+
+bool eraseFlashPage(const uint32_t page_id) {
+  memset(reinterpret_cast<void*>(static_cast<uintptr_t>(FLASH_START_ADDR + page_id * PAGE_SIZE)), 0xFF, PAGE_SIZE);
+  num_erased_pages++;
+  return true;
+}
+
+bool writeDataBufferToFlash(const uint32_t dst_address, const uint32_t dst_page_id, uint8_t* src_data_ptr,
+                            const uint32_t num_bytes) {
+  (void)dst_page_id;
+  memcpy(reinterpret_cast<void*>(static_cast<uintptr_t>(dst_address)), src_data_ptr, num_bytes);
+  return true;
+}
+
+uint8_t readByteFromFlash(const uint32_t flash_src_address) {
+  return *reinterpret_cast<const uint8_t*>(static_cast<uintptr_t>(flash_src_address));
+}
+
+};  // namespace franklyboot::hwi
+
+// Helpers ------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Returns application image of instruction like words (matches and copies are found, but not everywhere)
+ */
+std::vector<uint8_t> createImage(const uint32_t seed, const uint32_t num_bytes) {
+  std::mt19937 rng(seed);
+  std::vector<uint8_t> image;
+  while (image.size() < num_bytes) {
+    const uint32_t word = ((rng() % 4U) == 0U) ? rng() : (0x4600U | (rng() % 16U)) * 0x10001U;
+    for (uint32_t idx = 0U; (idx < 4U) && (image.size() < num_bytes); idx++) {
+      image.push_back(static_cast<uint8_t>(word >> (idx * 8U)));
+    }
+  }
+  return image;
+}
+
+/**
+ * @brief Returns new version of the image: changed constants, inserted code and a longer tail
+ */
+std::vector<uint8_t> modifyImage(std::vector<uint8_t> image) {
+  image[100U] ^= 0x5AU;
+  image[PAGE_SIZE * 5U + 17U] = 0x00U;
+
+  const std::vector<uint8_t> inserted = createImage(99U, 44U);
+  image.insert(image.begin() + PAGE_SIZE * 3U + 200U, inserted.begin(), inserted.end());
+
+  const std::vector<uint8_t> tail = createImage(100U, PAGE_SIZE / 2U);
+  image.insert(image.end(), tail.begin(), tail.end());
+  return image;
+}
+
+void writeFile(const std::string& path, const std::vector<uint8_t>& data) {
+  std::ofstream file(path, std::ios::binary);
+  file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+}
+
+std::vector<uint8_t> readFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/**
+ * @brief Generates patch with the patch tool (compressed image if the old image is empty)
+ */
+std::vector<uint8_t> generatePatch(const std::vector<uint8_t>& old_image, const std::vector<uint8_t>& new_image) {
+  const std::string dir = ::testing::TempDir();
+  const std::string old_path = dir + "franklyboot_patch_old.bin";
+  const std::string new_path = dir + "franklyboot_patch_new.bin";
+  const std::string patch_path = dir + "franklyboot_patch.bin";
+  writeFile(old_path, old_image);
+  writeFile(new_path, new_image);
+  std::remove(patch_path.c_str());
+
+  std::string command = std::string(PYTHON_EXECUTABLE) + " " + PATCH_TOOL + " --page-size " +
+                        std::to_string(PAGE_SIZE) + " --first-page " + std::to_string(APP_FIRST_PAGE);
+  if (old_image.empty()) {
+    command += " compress " + new_path + " " + patch_path;
+  } else {
+    command += " make " + old_path + " " + new_path + " " + patch_path;
+  }
+  EXPECT_EQ(std::system(command.c_str()), 0) << command;
+
+  return readFile(patch_path);
+}
+
+/**
+ * Device with flash and patch applier at 32 bit addresses
+ */
+class PagePatchTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    _flash = static_cast<uint8_t*>(mapFixed(FLASH_START_ADDR, FLASH_SIZE));
+    _patch = static_cast<TestPagePatch*>(mapFixed(RAM_START_ADDR, sizeof(TestPagePatch)));
+    if ((_flash == nullptr) || (_patch == nullptr)) {
+      GTEST_SKIP() << "Flash or RAM address is not available in this process";
+    }
+
+    _patch = new (_patch) TestPagePatch();
+    num_erased_pages = 0U;
+
+    // Bootloader pages hold a pattern, the application area is erased
+    for (uint32_t idx = 0U; idx < (APP_FIRST_PAGE * PAGE_SIZE); idx++) {
+      _flash[idx] = static_cast<uint8_t>(idx * 13U);
+    }
+    memset(getApp(), 0xFF, APP_SIZE);
+  }
+
+  void TearDown() override {
+    if (_patch != nullptr) {
+      munmap(_patch, sizeof(TestPagePatch));
+    }
+    if (_flash != nullptr) {
+      munmap(_flash, FLASH_SIZE);
+    }
+  }
+
+  static void* mapFixed(const uint32_t address, const uint32_t num_bytes) {
+    void* const addr = reinterpret_cast<void*>(static_cast<uintptr_t>(address));
+    void* mapping = mmap(addr, num_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE,
+                         -1, 0);
+    if (mapping == addr) {
+      return mapping;
+    }
+    if (mapping != MAP_FAILED) {
+      munmap(mapping, num_bytes);
+    }
+    return nullptr;
+  }
+
+  uint8_t* getApp() { return &_flash[APP_FIRST_PAGE * PAGE_SIZE]; }
+
+  void programApp(const std::vector<uint8_t>& image) { memcpy(getApp(), image.data(), image.size()); }
+
+  /**
+   * @brief Returns application area expected after the update (erased pages behind the new image stay untouched)
+   */
+  std::vector<uint8_t> getExpectedApp(const std::vector<uint8_t>& new_image) {
+    std::vector<uint8_t> expected(getApp(), getApp() + APP_SIZE);
+    const uint32_t num_bytes = ((new_image.size() + PAGE_SIZE - 1U) / PAGE_SIZE) * PAGE_SIZE;
+    memset(expected.data(), 0xFF, num_bytes);
+    memcpy(expected.data(), new_image.data(), new_image.size());
+    return expected;
+  }
+
+  /**
+   * @brief Sends patch like the host: open with the patch size, then 4 bytes per request
+   *
+   * @return Response to the last request, the sequence stops at the first error
+   */
+  msg::Msg sendPatch(const std::vector<uint8_t>& patch, const uint32_t patch_size) {
+    msg::Msg response;
+    uint8_t packet_id = 0U;
+    EXPECT_TRUE(_patch->processRequest(
+        ext::createResponse(ext::REQ_EXT_PATCH_OPEN, msg::RES_NONE, packet_id++, patch_size), response));
+    EXPECT_EQ(response.result, msg::RES_OK);
+    EXPECT_EQ(ext::getDataWord(response), patch_size);
+
+    for (uint32_t offset = 0U; offset < patch.size(); offset += 4U) {
+      uint32_t word = 0U;
+      for (uint32_t idx = 0U; (idx < 4U) && ((offset + idx) < patch.size()); idx++) {
+        word |= static_cast<uint32_t>(patch[offset + idx]) << (idx * 8U);
+      }
+
+      const msg::Msg request = ext::createResponse(ext::REQ_EXT_PATCH_DATA, msg::RES_NONE, packet_id++, word);
+      EXPECT_TRUE(_patch->processRequest(request, response));
+      EXPECT_EQ(response.packet_id, request.packet_id);
+      if (response.result != msg::RES_OK) {
+        break;
+      }
+    }
+    return response;
+  }
+
+  msg::Msg sendPatch(const std::vector<uint8_t>& patch) {
+    return sendPatch(patch, static_cast<uint32_t>(patch.size()));
+  }
+
+  uint8_t* _flash = {nullptr};
+  TestPagePatch* _patch = {nullptr};
+};
+
+/**
+ * @brief Appends varint (LEB128)
+ */
+void appendVarint(std::vector<uint8_t>& patch, uint32_t value) {
+  while (value >= 0x80U) {
+    patch.push_back(static_cast<uint8_t>(value | 0x80U));
+    value >>= 7U;
+  }
+  patch.push_back(static_cast<uint8_t>(value));
+}
+
+void appendWord(std::vector<uint8_t>& patch, const uint32_t value) {
+  for (uint32_t idx = 0U; idx < 4U; idx++) {
+    patch.push_back(static_cast<uint8_t>(value >> (idx * 8U)));
+  }
+}
+
+/**
+ * @brief Appends operation token (lengths from 31 on are followed by a varint)
+ */
+void appendToken(std::vector<uint8_t>& patch, const uint8_t op, const uint32_t length) {
+  patch.push_back(static_cast<uint8_t>((op << 5U) | std::min(length, 31U)));
+  if (length >= 31U) {
+    appendVarint(patch, length - 31U);
+  }
+}
+
+/**
+ * @brief Returns zigzag encoded offset
+ */
+uint32_t zigzag(const int32_t offset) {
+  return (offset >= 0) ? (static_cast<uint32_t>(offset) << 1U) : ((static_cast<uint32_t>(-offset) << 1U) - 1U);
+}
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+TEST_F(PagePatchTest, DeltaPatchReproducesNewImage) {
+  const std::vector<uint8_t> old_image = createImage(1U, PAGE_SIZE * 8U);
+  const std::vector<uint8_t> new_image = modifyImage(old_image);
+  programApp(old_image);
+  const std::vector<uint8_t> expected = getExpectedApp(new_image);
+  const std::vector<uint8_t> bootloader(_flash, getApp());
+
+  const std::vector<uint8_t> patch = generatePatch(old_image, new_image);
+  ASSERT_GT(patch.size(), TestPagePatch::HEADER_SIZE);
+  EXPECT_LT(patch.size(), new_image.size() / 2U);
+
+  // Only changed pages are written (the inserted code shifts all pages behind it)
+  uint32_t num_changed_pages = 0U;
+  for (uint32_t offset = 0U; offset < APP_SIZE; offset += PAGE_SIZE) {
+    if (memcmp(&expected[offset], getApp() + offset, PAGE_SIZE) != 0) {
+      num_changed_pages++;
+    }
+  }
+  EXPECT_LT(num_changed_pages, (new_image.size() + PAGE_SIZE - 1U) / PAGE_SIZE);
+
+  const msg::Msg response = sendPatch(patch);
+  EXPECT_EQ(response.result, msg::RES_OK);
+  EXPECT_EQ(ext::getDataWord(response), num_changed_pages);
+  EXPECT_EQ(num_erased_pages, num_changed_pages);
+  EXPECT_EQ(std::vector<uint8_t>(getApp(), getApp() + APP_SIZE), expected);
+  EXPECT_EQ(std::vector<uint8_t>(_flash, getApp()), bootloader);
+}
+
+TEST_F(PagePatchTest, CompressedImageReproducesNewImage) {
+  // Old application is replaced completely, its content is not used
+  programApp(createImage(2U, PAGE_SIZE * 6U));
+  std::vector<uint8_t> new_image = createImage(3U, PAGE_SIZE * 7U + 300U);
+  new_image.insert(new_image.end(), 1000U, 0x00U);
+  const std::vector<uint8_t> expected = getExpectedApp(new_image);
+
+  const std::vector<uint8_t> patch = generatePatch({}, new_image);
+  EXPECT_LT(patch.size(), new_image.size());
+
+  const msg::Msg response = sendPatch(patch);
+  EXPECT_EQ(response.result, msg::RES_OK);
+  EXPECT_EQ(ext::getDataWord(response), 9U);
+  EXPECT_EQ(std::vector<uint8_t>(getApp(), getApp() + APP_SIZE), expected);
+}
+
+TEST_F(PagePatchTest, TruncatedPatchIsRejected) {
+  const std::vector<uint8_t> old_image = createImage(1U, PAGE_SIZE * 8U);
+  const std::vector<uint8_t> new_image = modifyImage(old_image);
+  programApp(old_image);
+  const std::vector<uint8_t> patch = generatePatch(old_image, new_image);
+
+  // Stream ends within the last page record
+  const std::vector<uint8_t> truncated(patch.begin(), patch.end() - 5);
+  const msg::Msg response = sendPatch(truncated);
+  EXPECT_EQ(response.result, msg::RES_ERR);
+  EXPECT_EQ(ext::getDataWord(response), truncated.size());
+
+  // Patch shorter than the header
+  EXPECT_EQ(sendPatch(std::vector<uint8_t>(patch.begin(), patch.begin() + 8), 8U).result, msg::RES_ERR);
+}
+
+TEST_F(PagePatchTest, CorruptedPatchIsRejected) {
+  const std::vector<uint8_t> old_image = createImage(1U, PAGE_SIZE * 8U);
+  const std::vector<uint8_t> new_image = modifyImage(old_image);
+  programApp(old_image);
+  const std::vector<uint8_t> patch = generatePatch(old_image, new_image);
+
+  // CRC of the last page does not match: error at its last byte, the page is not written
+  std::vector<uint8_t> corrupted = patch;
+  corrupted.back() ^= 0x01U;
+  msg::Msg response = sendPatch(corrupted);
+  EXPECT_EQ(response.result, msg::RES_ERR);
+  EXPECT_EQ(ext::getDataWord(response), corrupted.size() - 1U);
+
+  // Wrong magic is detected with the header, before anything is written
+  programApp(old_image);
+  num_erased_pages = 0U;
+  corrupted = patch;
+  corrupted[0U] ^= 0x01U;
+  response = sendPatch(corrupted);
+  EXPECT_EQ(response.result, msg::RES_ERR);
+  EXPECT_EQ(ext::getDataWord(response), TestPagePatch::HEADER_SIZE - 1U);
+  EXPECT_EQ(num_erased_pages, 0U);
+
+  // Invalid operation
+  corrupted = patch;
+  corrupted[TestPagePatch::HEADER_SIZE + 1U] = 0xE0U;
+  EXPECT_EQ(sendPatch(corrupted).result, msg::RES_ERR);
+}
+
+TEST_F(PagePatchTest, BadOldImageCRCIsRejected) {
+  const std::vector<uint8_t> old_image = createImage(1U, PAGE_SIZE * 8U);
+  const std::vector<uint8_t> new_image = modifyImage(old_image);
+  const std::vector<uint8_t> patch = generatePatch(old_image, new_image);
+
+  // Device holds another application than the patch was made for
+  std::vector<uint8_t> other_image = old_image;
+  other_image[PAGE_SIZE * 7U] ^= 0x01U;
+  programApp(other_image);
+
+  const msg::Msg response = sendPatch(patch);
+  EXPECT_EQ(response.result, msg::RES_ERR);
+  EXPECT_EQ(ext::getDataWord(response), TestPagePatch::HEADER_SIZE - 1U);
+  EXPECT_EQ(num_erased_pages, 0U);
+  EXPECT_EQ(std::vector<uint8_t>(getApp(), getApp() + other_image.size()), other_image);
+}
+
+TEST_F(PagePatchTest, CopyBeyondOldSizeIsRejected) {
+  const std::vector<uint8_t> old_image = createImage(1U, PAGE_SIZE * 2U);
+  programApp(old_image);
+
+  // Second application page copies from the page behind the old image
+  std::vector<uint8_t> patch;
+  appendWord(patch, TestPagePatch::MAGIC);
+  appendWord(patch, PAGE_SIZE);
+  appendWord(patch, static_cast<uint32_t>(old_image.size()));
+  appendWord(patch, crc::calculate(old_image.data(), static_cast<uint32_t>(old_image.size())));
+  appendVarint(patch, APP_FIRST_PAGE + 1U);
+  patch.push_back(static_cast<uint8_t>((TestPagePatch::OP_COPY << 5U) | 16U));
+  const uint32_t offset_pos = static_cast<uint32_t>(patch.size());
+  appendVarint(patch, PAGE_SIZE * 2U);  // zigzag of +PAGE_SIZE
+
+  msg::Msg response = sendPatch(patch);
+  EXPECT_EQ(response.result, msg::RES_ERR);
+  EXPECT_EQ(ext::getDataWord(response), offset_pos + 1U);
+
+  // Same copy from the old image is accepted
+  patch.resize(offset_pos);
+  appendVarint(patch, 0U);
+  patch.push_back(static_cast<uint8_t>((TestPagePatch::OP_FILL << 5U) | 31U));
+  appendVarint(patch, PAGE_SIZE - 16U - 31U);
+  patch.push_back(0xFFU);
+  std::vector<uint8_t> page(old_image.begin() + PAGE_SIZE, old_image.begin() + PAGE_SIZE + 16);
+  page.resize(PAGE_SIZE, 0xFFU);
+  patch.push_back(TestPagePatch::OP_END);
+  appendWord(patch, crc::calculate(page.data(), PAGE_SIZE));
+
+  response = sendPatch(patch);
+  EXPECT_EQ(response.result, msg::RES_OK);
+  EXPECT_EQ(ext::getDataWord(response), 1U);
+  EXPECT_EQ(std::vector<uint8_t>(getApp() + PAGE_SIZE, getApp() + PAGE_SIZE * 2U), page);
+}
+
+TEST_F(PagePatchTest, CompressedMatchesRepeatPatternAndReadWrittenPages) {
+  // Old application must not be used in the compressed mode
+  programApp(createImage(4U, APP_SIZE));
+  const std::vector<uint8_t> pattern = {'F', 'R', 'A', 'N', 'C', 'O', 'R'};
+
+  std::vector<uint8_t> patch;
+  appendWord(patch, TestPagePatch::MAGIC);
+  appendWord(patch, PAGE_SIZE);
+  appendWord(patch, 0U);
+  appendWord(patch, 0U);
+
+  // First page: literal pattern, overlapping match repeats it up to the end of the page
+  std::vector<uint8_t> page;
+  while (page.size() < PAGE_SIZE) {
+    page.push_back(pattern[page.size() % pattern.size()]);
+  }
+  appendVarint(patch, APP_FIRST_PAGE);
+  appendToken(patch, TestPagePatch::OP_LITERAL, static_cast<uint32_t>(pattern.size()));
+  patch.insert(patch.end(), pattern.begin(), pattern.end());
+  appendToken(patch, TestPagePatch::OP_MATCH, PAGE_SIZE - static_cast<uint32_t>(pattern.size()));
+  appendVarint(patch, zigzag(-static_cast<int32_t>(pattern.size())));
+  appendToken(patch, TestPagePatch::OP_END, 0U);
+  appendWord(patch, crc::calculate(page.data(), PAGE_SIZE));
+
+  // Third page: match of the first page, which is written before
+  appendVarint(patch, APP_FIRST_PAGE + 2U);
+  appendToken(patch, TestPagePatch::OP_MATCH, PAGE_SIZE);
+  appendVarint(patch, zigzag(-2 * static_cast<int32_t>(PAGE_SIZE)));
+  appendToken(patch, TestPagePatch::OP_END, 0U);
+  appendWord(patch, crc::calculate(page.data(), PAGE_SIZE));
+
+  msg::Msg response = sendPatch(patch);
+  EXPECT_EQ(response.result, msg::RES_OK);
+  EXPECT_EQ(ext::getDataWord(response), 2U);
+  EXPECT_EQ(std::vector<uint8_t>(getApp(), getApp() + PAGE_SIZE), page);
+  EXPECT_EQ(std::vector<uint8_t>(getApp() + PAGE_SIZE * 2U, getApp() + PAGE_SIZE * 3U), page);
+
+  // Fourth page: match of the second page, which holds the old application and is not written by the patch
+  programApp(createImage(4U, APP_SIZE));
+  appendVarint(patch, APP_FIRST_PAGE + 3U);
+  appendToken(patch, TestPagePatch::OP_MATCH, PAGE_SIZE);
+  appendVarint(patch, zigzag(-2 * static_cast<int32_t>(PAGE_SIZE)));
+  const uint32_t error_offset = static_cast<uint32_t>(patch.size()) - 1U;
+  appendToken(patch, TestPagePatch::OP_END, 0U);
+  appendWord(patch, crc::calculate(getApp() + PAGE_SIZE, PAGE_SIZE));
+
+  response = sendPatch(patch);
+  EXPECT_EQ(response.result, msg::RES_ERR);
+  EXPECT_EQ(ext::getDataWord(response), error_offset);
+}
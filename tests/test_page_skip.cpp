@@ -0,0 +1,228 @@
+/**
+ * @file test_page_skip.cpp
+ * @author agent (agent@local)
+ * @brief Test of the page skip decisions (identical, erased, cleared bits, partial units) and the deferred erase
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+
+#include <vector>
+
+#include "page_skip.h"
+
+using namespace franklyboot;
+
+// Helpers ------------------------------------------------------------------------------------------------------------
+
+// Simulated flash is mapped to the flash address of the STM32, prepareWrite() reads it via the 32 bit address
+constexpr uint32_t FLASH_START_ADDR = {0x08000000U};
+constexpr uint32_t PAGE_SIZE = {2048U};
+constexpr uint32_t NUM_PAGES = {4U};
+constexpr uint32_t DOUBLE_WORD = {8U};
+
+using TestPageSkip = ext::PageSkip<FLASH_START_ADDR, PAGE_SIZE, DOUBLE_WORD>;
+
+/**
+ * Flash at FLASH_START_ADDR, all pages hold a programmed pattern
+ */
+class PageSkipTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    void* mapping = mmap(reinterpret_cast<void*>(static_cast<uintptr_t>(FLASH_START_ADDR)), PAGE_SIZE * NUM_PAGES,
+                         PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (mapping != reinterpret_cast<void*>(static_cast<uintptr_t>(FLASH_START_ADDR))) {
+      if (mapping != MAP_FAILED) {
+        munmap(mapping, PAGE_SIZE * NUM_PAGES);
+      }
+      GTEST_SKIP() << "Flash address is not available in this process";
+    }
+
+    _flash = static_cast<uint8_t*>(mapping);
+    for (uint32_t idx = 0U; idx < (PAGE_SIZE * NUM_PAGES); idx++) {
+      _flash[idx] = static_cast<uint8_t>(idx * 7U + 3U);
+    }
+  }
+
+  void TearDown() override {
+    if (_flash != nullptr) {
+      munmap(_flash, PAGE_SIZE * NUM_PAGES);
+    }
+  }
+
+  uint8_t* getPage(const uint32_t page_id) { return &_flash[page_id * PAGE_SIZE]; }
+
+  static uint32_t getPageAddress(const uint32_t page_id) { return FLASH_START_ADDR + page_id * PAGE_SIZE; }
+
+  /**
+   * @brief Returns page buffer with the current content of the page
+   */
+  std::vector<uint8_t> readPage(const uint32_t page_id) {
+    return std::vector<uint8_t>(getPage(page_id), getPage(page_id) + PAGE_SIZE);
+  }
+
+  /**
+   * @brief Writes page like the board: erase request, then write request of the complete page
+   */
+  TestPageSkip::WriteAction writePage(const uint32_t page_id, const std::vector<uint8_t>& data) {
+    EXPECT_EQ(_page_skip.deferErase(page_id), TestPageSkip::NO_PAGE);
+    EXPECT_EQ(_page_skip.takeDeferredErase(page_id), TestPageSkip::NO_PAGE);
+    return _page_skip.prepareWrite(page_id, getPageAddress(page_id), data.data(), PAGE_SIZE);
+  }
+
+  /**
+   * @brief Returns skip statistics (skipped pages, pages programmed without erase)
+   */
+  std::pair<uint32_t, uint32_t> getStats() {
+    const msg::Msg request = ext::createResponse(ext::REQ_EXT_FLASH_SKIP_STATS, msg::RES_NONE, 5U, 0U);
+    msg::Msg response;
+    EXPECT_TRUE(_page_skip.processRequest(request, response));
+    EXPECT_EQ(response.result, msg::RES_OK);
+    EXPECT_EQ(response.packet_id, 5U);
+
+    const uint32_t stats = ext::getDataWord(response);
+    return {stats & 0xFFFFU, stats >> 16U};
+  }
+
+  uint8_t* _flash = {nullptr};
+  TestPageSkip _page_skip;
+};
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+TEST(ComparePage, IdenticalPage) {
+  std::vector<uint8_t> flash(PAGE_SIZE, 0x5AU);
+  const std::vector<uint8_t> data = flash;
+
+  EXPECT_EQ(ext::comparePage<8U>(flash.data(), data.data(), PAGE_SIZE), ext::PAGE_IDENTICAL);
+  EXPECT_EQ(ext::comparePage<2U>(flash.data(), data.data(), PAGE_SIZE), ext::PAGE_IDENTICAL);
+  EXPECT_EQ(ext::comparePage<0U>(flash.data(), data.data(), PAGE_SIZE), ext::PAGE_IDENTICAL);
+}
+
+TEST(ComparePage, ErasedPage) {
+  const std::vector<uint8_t> flash(PAGE_SIZE, 0xFFU);
+  std::vector<uint8_t> data(PAGE_SIZE);
+  for (uint32_t idx = 0U; idx < PAGE_SIZE; idx++) {
+    data[idx] = static_cast<uint8_t>(idx);
+  }
+
+  EXPECT_EQ(ext::comparePage<8U>(flash.data(), data.data(), PAGE_SIZE), ext::PAGE_PROGRAM_ONLY);
+  EXPECT_EQ(ext::comparePage<2U>(flash.data(), data.data(), PAGE_SIZE), ext::PAGE_PROGRAM_ONLY);
+  EXPECT_EQ(ext::comparePage<0U>(flash.data(), data.data(), PAGE_SIZE), ext::PAGE_PROGRAM_ONLY);
+}
+
+TEST(ComparePage, ZeroOnlyChange) {
+  std::vector<uint8_t> flash(PAGE_SIZE, 0xA5U);
+  std::vector<uint8_t> data = flash;
+
+  // Programming a complete unit to zero is possible without erase
+  for (uint32_t idx = 64U; idx < 72U; idx++) {
+    data[idx] = 0x00U;
+  }
+  EXPECT_EQ(ext::comparePage<8U>(flash.data(), data.data(), PAGE_SIZE), ext::PAGE_PROGRAM_ONLY);
+  EXPECT_EQ(ext::comparePage<2U>(flash.data(), data.data(), PAGE_SIZE), ext::PAGE_PROGRAM_ONLY);
+
+  // Clearing single bits of a programmed unit is only possible on NOR flash
+  data = flash;
+  data[100U] = 0x01U;
+  EXPECT_EQ(ext::comparePage<8U>(flash.data(), data.data(), PAGE_SIZE), ext::PAGE_ERASE_REQUIRED);
+  EXPECT_EQ(ext::comparePage<0U>(flash.data(), data.data(), PAGE_SIZE), ext::PAGE_PROGRAM_ONLY);
+
+  // Setting a bit always requires the erase
+  data[100U] = 0xFFU;
+  EXPECT_EQ(ext::comparePage<0U>(flash.data(), data.data(), PAGE_SIZE), ext::PAGE_ERASE_REQUIRED);
+}
+
+TEST(ComparePage, PartialDoubleWordChange) {
+  std::vector<uint8_t> flash(PAGE_SIZE, 0xFFU);
+  for (uint32_t idx = 0U; idx < 4U; idx++) {
+    flash[256U + idx] = 0x11U;
+  }
+
+  // First half-word of the double word is programmed, the data changes the erased second half-word
+  std::vector<uint8_t> data = flash;
+  for (uint32_t idx = 4U; idx < 8U; idx++) {
+    data[256U + idx] = 0x22U;
+  }
+  EXPECT_EQ(ext::comparePage<8U>(flash.data(), data.data(), PAGE_SIZE), ext::PAGE_ERASE_REQUIRED);
+  EXPECT_EQ(ext::comparePage<4U>(flash.data(), data.data(), PAGE_SIZE), ext::PAGE_PROGRAM_ONLY);
+  EXPECT_EQ(ext::comparePage<2U>(flash.data(), data.data(), PAGE_SIZE), ext::PAGE_PROGRAM_ONLY);
+
+  // Sizes which are not a multiple of the compare width are never skipped
+  EXPECT_EQ(ext::comparePage<8U>(flash.data(), flash.data(), 12U), ext::PAGE_ERASE_REQUIRED);
+}
+
+TEST_F(PageSkipTest, IdenticalPageIsSkipped) {
+  EXPECT_EQ(writePage(1U, readPage(1U)), TestPageSkip::WRITE_SKIP);
+  EXPECT_EQ(getStats(), std::make_pair(1U, 0U));
+}
+
+TEST_F(PageSkipTest, ErasedPageIsProgrammedWithoutErase) {
+  memset(getPage(2U), 0xFF, PAGE_SIZE);
+  const std::vector<uint8_t> data = readPage(0U);
+
+  EXPECT_EQ(writePage(2U, data), TestPageSkip::WRITE_PROGRAM);
+  EXPECT_EQ(getStats(), std::make_pair(0U, 1U));
+}
+
+TEST_F(PageSkipTest, ZeroOnlyChangeIsProgrammedWithoutErase) {
+  std::vector<uint8_t> data = readPage(1U);
+  memset(&data[DOUBLE_WORD * 3U], 0x00, DOUBLE_WORD);
+
+  EXPECT_EQ(writePage(1U, data), TestPageSkip::WRITE_PROGRAM);
+  EXPECT_EQ(getStats(), std::make_pair(0U, 1U));
+}
+
+TEST_F(PageSkipTest, PartialDoubleWordChangeIsErased) {
+  std::vector<uint8_t> data = readPage(1U);
+  data[DOUBLE_WORD * 3U + 1U] = 0x00U;
+
+  EXPECT_EQ(writePage(1U, data), TestPageSkip::WRITE_ERASE_PROGRAM);
+  EXPECT_EQ(getStats(), std::make_pair(0U, 0U));
+}
+
+TEST_F(PageSkipTest, PartialPageWriteIsNotSkipped) {
+  const std::vector<uint8_t> data = readPage(1U);
+
+  // Erase of the page was requested, the write covers only a part of it
+  EXPECT_EQ(_page_skip.deferErase(1U), TestPageSkip::NO_PAGE);
+  EXPECT_EQ(_page_skip.prepareWrite(1U, getPageAddress(1U), data.data(), PAGE_SIZE / 2U),
+            TestPageSkip::WRITE_ERASE_PROGRAM);
+
+  // Without erase request, data already in flash is skipped for parts of pages as well
+  EXPECT_EQ(_page_skip.prepareWrite(1U, getPageAddress(1U), data.data(), PAGE_SIZE / 2U), TestPageSkip::WRITE_SKIP);
+  EXPECT_EQ(getStats(), std::make_pair(1U, 0U));
+}
+
+TEST_F(PageSkipTest, DeferredEraseFollowedByDifferentPage) {
+  const std::vector<uint8_t> data = readPage(3U);
+
+  // Host erases page 1 and page 2 without writing page 1: the erase of page 1 is executed then
+  EXPECT_EQ(_page_skip.deferErase(1U), TestPageSkip::NO_PAGE);
+  EXPECT_EQ(_page_skip.deferErase(1U), TestPageSkip::NO_PAGE);
+  EXPECT_EQ(_page_skip.deferErase(2U), 1U);
+
+  // Write of page 3 while the erase of page 2 is deferred: page 2 is erased before the flash is read
+  EXPECT_EQ(_page_skip.takeDeferredErase(3U), 2U);
+  EXPECT_EQ(_page_skip.takeDeferredErase(3U), TestPageSkip::NO_PAGE);
+
+  // No erase of page 3 was requested, so its identical content is skipped and the statistics count it
+  EXPECT_EQ(_page_skip.prepareWrite(3U, getPageAddress(3U), data.data(), PAGE_SIZE), TestPageSkip::WRITE_SKIP);
+
+  // Other flash access (e.g. CRC) takes a deferred erase of any page
+  EXPECT_EQ(_page_skip.deferErase(0U), TestPageSkip::NO_PAGE);
+  EXPECT_EQ(_page_skip.takeDeferredErase(), 0U);
+  EXPECT_EQ(_page_skip.takeDeferredErase(), TestPageSkip::NO_PAGE);
+}
+
+TEST_F(PageSkipTest, OtherRequestIsNotProcessed) {
+  const msg::Msg request = ext::createResponse(ext::REQ_EXT_DISCOVER, msg::RES_NONE, 0U, 0U);
+  msg::Msg response;
+  EXPECT_FALSE(_page_skip.processRequest(request, response));
+}
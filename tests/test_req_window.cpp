@@ -0,0 +1,206 @@
+/**
+ * @file test_req_window.cpp
+ * @author agent (agent@local)
+ * @brief Test of the request window (ordering, reorder buffer, response cache, sequence number wrap-around)
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "req_window.h"
+
+using namespace franklyboot;
+
+// Helpers ------------------------------------------------------------------------------------------------------------
+
+constexpr uint32_t MAX_WINDOW = {8U};
+
+static msg::Msg createRequest(const uint16_t type, const uint8_t packet_id, const uint32_t data = 0U) {
+  msg::Msg request = ext::createResponse(static_cast<ext::ExtRequestType>(type), msg::RES_NONE, packet_id, data);
+  return request;
+}
+
+/**
+ * Device side of the window: records processed requests and transmitted responses
+ */
+class WindowDevice {
+ public:
+  bool receive(const msg::Msg& request) {
+    return window.processRequest(
+        request,
+        [this](const msg::Msg& req) {
+          processed.push_back(req.packet_id);
+          return ext::createResponse(static_cast<ext::ExtRequestType>(req.request), msg::RES_OK, 0U,
+                                     ext::getDataWord(req) + 1U);
+        },
+        [this](const msg::Msg& response) { transmitted.push_back(response); });
+  }
+
+  void open(const uint8_t packet_id, const uint32_t size) {
+    receive(createRequest(ext::REQ_EXT_WINDOW_OPEN, packet_id, size));
+    ASSERT_EQ(transmitted.size(), 1U);
+    ASSERT_EQ(transmitted[0U].data[0U], size);
+    transmitted.clear();
+  }
+
+  void sendData(const uint8_t packet_id) { receive(createRequest(msg::REQ_PING, packet_id, packet_id)); }
+
+  static bool isStatus(const msg::Msg& response) { return ext::isRequest(response, ext::REQ_EXT_WINDOW_STATUS); }
+
+  ext::RequestWindow<MAX_WINDOW> window;
+  std::vector<uint8_t> processed;
+  std::vector<msg::Msg> transmitted;
+};
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+TEST(RequestWindow, ClosedWindowDoesNotHandleRequests) {
+  WindowDevice device;
+
+  EXPECT_FALSE(device.receive(createRequest(msg::REQ_PING, 0U)));
+  EXPECT_TRUE(device.processed.empty());
+  EXPECT_TRUE(device.transmitted.empty());
+}
+
+TEST(RequestWindow, OpenGrantsAtMostMaxWindow) {
+  WindowDevice device;
+
+  device.receive(createRequest(ext::REQ_EXT_WINDOW_OPEN, 0x10U, 64U));
+  ASSERT_EQ(device.transmitted.size(), 1U);
+  EXPECT_EQ(device.transmitted[0U].packet_id, 0x10U);
+  EXPECT_EQ(device.transmitted[0U].data[0U], MAX_WINDOW);
+  EXPECT_TRUE(device.window.isActive());
+
+  device.receive(createRequest(ext::REQ_EXT_WINDOW_OPEN, 0x10U, 0U));
+  EXPECT_FALSE(device.window.isActive());
+}
+
+TEST(RequestWindow, InOrderAcrossSequenceWrapAround) {
+  WindowDevice device;
+  device.open(0xF0U, MAX_WINDOW);
+
+  for (uint32_t idx = 0U; idx < 40U; idx++) {
+    device.sendData(static_cast<uint8_t>(0xF1U + idx));
+  }
+
+  ASSERT_EQ(device.processed.size(), 40U);
+  ASSERT_EQ(device.transmitted.size(), 40U);
+  for (uint32_t idx = 0U; idx < 40U; idx++) {
+    const uint8_t seq = static_cast<uint8_t>(0xF1U + idx);
+    EXPECT_EQ(device.processed[idx], seq);
+    EXPECT_EQ(device.transmitted[idx].packet_id, seq);
+    EXPECT_EQ(device.transmitted[idx].result, msg::RES_OK);
+    EXPECT_EQ(ext::getDataWord(device.transmitted[idx]), seq + 1U);
+  }
+}
+
+TEST(RequestWindow, ReorderedRequestsDrainAcrossWrapAround) {
+  WindowDevice device;
+  device.open(0xFBU, MAX_WINDOW);
+
+  // Expected 0xFC is lost, 0xFD - 0x02 arrive: buffered, gap reported once
+  for (const uint8_t seq : {0xFDU, 0xFEU, 0xFFU, 0x00U, 0x01U, 0x02U}) {
+    device.sendData(seq);
+  }
+  EXPECT_TRUE(device.processed.empty());
+  ASSERT_EQ(device.transmitted.size(), 1U);
+  ASSERT_TRUE(WindowDevice::isStatus(device.transmitted[0U]));
+  EXPECT_EQ(device.transmitted[0U].packet_id, 0xFCU);
+  EXPECT_EQ(device.transmitted[0U].data[0U], MAX_WINDOW - 1U);  // First request buffered at the time of the status
+  EXPECT_EQ(device.transmitted[0U].data[1U], 0x01U);
+
+  // Polled status lists all buffered requests
+  device.transmitted.clear();
+  device.receive(createRequest(ext::REQ_EXT_WINDOW_STATUS, 0U));
+  ASSERT_EQ(device.transmitted.size(), 1U);
+  EXPECT_EQ(device.transmitted[0U].packet_id, 0xFCU);
+  EXPECT_EQ(device.transmitted[0U].data[0U], MAX_WINDOW - 6U);
+  EXPECT_EQ(device.transmitted[0U].data[1U], 0x3FU);
+
+  // Retransmission of the missing request drains the reorder buffer in order
+  device.transmitted.clear();
+  device.sendData(0xFCU);
+  const std::vector<uint8_t> expected = {0xFCU, 0xFDU, 0xFEU, 0xFFU, 0x00U, 0x01U, 0x02U};
+  EXPECT_EQ(device.processed, expected);
+  ASSERT_EQ(device.transmitted.size(), expected.size());
+  for (uint32_t idx = 0U; idx < expected.size(); idx++) {
+    EXPECT_EQ(device.transmitted[idx].packet_id, expected[idx]);
+  }
+
+  // Window continues after the wrap-around with all credits
+  device.transmitted.clear();
+  device.receive(createRequest(ext::REQ_EXT_WINDOW_STATUS, 0U));
+  EXPECT_EQ(device.transmitted[0U].packet_id, 0x03U);
+  EXPECT_EQ(device.transmitted[0U].data[0U], MAX_WINDOW);
+  EXPECT_EQ(ext::getDataWord(device.transmitted[0U]) >> 8U, 0U);
+}
+
+TEST(RequestWindow, BufferedDuplicateIsIgnored) {
+  WindowDevice device;
+  device.open(0x00U, MAX_WINDOW);
+
+  device.sendData(0x03U);
+  device.sendData(0x03U);
+  EXPECT_EQ(device.transmitted.size(), 1U);  // Status of the gap only
+
+  device.sendData(0x01U);
+  device.sendData(0x02U);
+  const std::vector<uint8_t> expected = {0x01U, 0x02U, 0x03U};
+  EXPECT_EQ(device.processed, expected);
+}
+
+TEST(RequestWindow, ProcessedDuplicateIsAnsweredFromCache) {
+  WindowDevice device;
+  device.open(0xFEU, MAX_WINDOW);
+
+  for (const uint8_t seq : {0xFFU, 0x00U, 0x01U}) {
+    device.sendData(seq);
+  }
+  device.transmitted.clear();
+
+  // Response of 0xFF lost: retransmission is answered again without processing
+  device.sendData(0xFFU);
+  EXPECT_EQ(device.processed.size(), 3U);
+  ASSERT_EQ(device.transmitted.size(), 1U);
+  EXPECT_EQ(device.transmitted[0U].packet_id, 0xFFU);
+  EXPECT_EQ(ext::getDataWord(device.transmitted[0U]), 0x100U);
+}
+
+TEST(RequestWindow, OutOfWindowRequestIsAnsweredWithStatus) {
+  WindowDevice device;
+  device.open(0x00U, 4U);
+
+  device.sendData(0x01U);
+  device.transmitted.clear();
+
+  // Ahead of the window and far behind it (older than the response cache)
+  for (const uint8_t seq : {0x06U, 0x80U, 0xF0U}) {
+    device.sendData(seq);
+    ASSERT_EQ(device.transmitted.size(), 1U);
+    EXPECT_TRUE(WindowDevice::isStatus(device.transmitted[0U]));
+    EXPECT_EQ(device.transmitted[0U].packet_id, 0x02U);
+    device.transmitted.clear();
+  }
+  EXPECT_EQ(device.processed.size(), 1U);
+}
+
+TEST(RequestWindow, ReopenDiscardsBufferedRequests) {
+  WindowDevice device;
+  device.open(0x00U, MAX_WINDOW);
+
+  device.sendData(0x02U);
+  device.transmitted.clear();
+  device.open(0x10U, MAX_WINDOW);
+  device.sendData(0x11U);
+  device.sendData(0x12U);
+
+  const std::vector<uint8_t> expected = {0x11U, 0x12U};
+  EXPECT_EQ(device.processed, expected);
+}
@@ -0,0 +1,144 @@
+/**
+ * @file test_spsc_ring.cpp
+ * @author agent (agent@local)
+ * @brief Test of the inter core ring buffer (single thread behaviour and two thread stress test)
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+// Includes -----------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+
+#include <array>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "spsc_ring.h"
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+TEST(SPSCRing, EmptyAndFull) {
+  SPSCRing<uint8_t, 8U> ring;
+  std::array<uint8_t, 16U> data = {};
+
+  EXPECT_EQ(ring.available(), 0U);
+  EXPECT_EQ(ring.freeSpace(), 8U);
+  EXPECT_EQ(ring.pop(data.data(), 1U), 0U);
+
+  // Full buffer size is usable, further elements are not pushed
+  EXPECT_EQ(ring.push(data.data(), 16U), 8U);
+  EXPECT_EQ(ring.available(), 8U);
+  EXPECT_EQ(ring.freeSpace(), 0U);
+  EXPECT_EQ(ring.push(data.data(), 1U), 0U);
+
+  EXPECT_EQ(ring.pop(data.data(), 16U), 8U);
+  EXPECT_EQ(ring.available(), 0U);
+  EXPECT_EQ(ring.freeSpace(), 8U);
+}
+
+TEST(SPSCRing, BulkPushPopAcrossWrapAround) {
+  SPSCRing<uint32_t, 8U> ring;
+  uint32_t write_value = 0U;
+  uint32_t read_value = 0U;
+
+  // Chunks of 5 elements start at every offset of the buffer and are split at its end
+  for (uint32_t iteration = 0U; iteration < 64U; iteration++) {
+    std::array<uint32_t, 5U> data = {};
+    for (uint32_t& value : data) {
+      value = write_value++;
+    }
+    ASSERT_EQ(ring.push(data.data(), data.size()), data.size());
+
+    std::array<uint32_t, 5U> result = {};
+    ASSERT_EQ(ring.pop(result.data(), result.size()), result.size());
+    for (const uint32_t value : result) {
+      EXPECT_EQ(value, read_value++);
+    }
+  }
+}
+
+TEST(SPSCRing, PartialTransfers) {
+  SPSCRing<uint16_t, 16U> ring;
+  std::vector<uint16_t> data(32U);
+  for (uint32_t idx = 0U; idx < data.size(); idx++) {
+    data[idx] = static_cast<uint16_t>(idx);
+  }
+
+  EXPECT_EQ(ring.push(data.data(), 10U), 10U);
+  EXPECT_EQ(ring.push(&data[10U], 10U), 6U);
+
+  std::vector<uint16_t> result(32U);
+  EXPECT_EQ(ring.pop(result.data(), 4U), 4U);
+  EXPECT_EQ(ring.push(&data[16U], 10U), 4U);
+  EXPECT_EQ(ring.pop(&result[4U], 32U), 16U);
+
+  for (uint32_t idx = 0U; idx < 20U; idx++) {
+    EXPECT_EQ(result[idx], idx);
+  }
+}
+
+TEST(SPSCRing, ResetEmptiesBuffer) {
+  SPSCRing<uint8_t, 4U> ring;
+  const uint8_t data[3U] = {1U, 2U, 3U};
+
+  ring.push(data, 3U);
+  ring.reset();
+  EXPECT_EQ(ring.available(), 0U);
+  EXPECT_EQ(ring.freeSpace(), 4U);
+}
+
+TEST(SPSCRing, TwoThreadStress) {
+  constexpr uint32_t NUM_ELEMENTS = {1024U * 1024U};
+  SPSCRing<uint32_t, 64U> ring;
+
+  // Producer and consumer transfer random chunk sizes, the consumer checks for lost, duplicated or
+  // reordered elements and for elements read before they were written
+  std::thread producer([&ring]() {
+    std::mt19937 rng(1U);
+    std::uniform_int_distribution<uint32_t> chunk_dist(1U, 80U);
+    std::array<uint32_t, 80U> data = {};
+
+    uint32_t value = 0U;
+    while (value < NUM_ELEMENTS) {
+      const uint32_t count = std::min(chunk_dist(rng), NUM_ELEMENTS - value);
+      for (uint32_t idx = 0U; idx < count; idx++) {
+        data[idx] = value + idx;
+      }
+
+      const uint32_t num_pushed = ring.push(data.data(), count);
+      ASSERT_LE(num_pushed, count);
+      value += num_pushed;
+      if (num_pushed == 0U) {
+        std::this_thread::yield();  // Hosts with a single CPU
+      }
+    }
+  });
+
+  std::mt19937 rng(2U);
+  std::uniform_int_distribution<uint32_t> chunk_dist(1U, 80U);
+  std::array<uint32_t, 80U> data = {};
+  uint32_t expected = 0U;
+  uint32_t num_errors = 0U;
+
+  while (expected < NUM_ELEMENTS) {
+    const uint32_t available = ring.available();
+    ASSERT_LE(available, 64U);
+
+    const uint32_t num_popped = ring.pop(data.data(), chunk_dist(rng));
+    for (uint32_t idx = 0U; idx < num_popped; idx++) {
+      num_errors += (data[idx] != expected) ? 1U : 0U;
+      expected++;
+    }
+    if (num_popped == 0U) {
+      std::this_thread::yield();
+    }
+  }
+
+  producer.join();
+  EXPECT_EQ(num_errors, 0U);
+  EXPECT_EQ(ring.available(), 0U);
+}
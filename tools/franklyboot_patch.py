@@ -0,0 +1,371 @@
+#!/usr/bin/env python3
+"""
+Delta patch and compressed image generator for application updates (see common/Inc/page_patch.h)
+
+The images are binary files of the application region, starting at the first application page.
+The patch rebuilds every page of the new image which differs from the old image from copies of the
+old image, LZ77 matches of the new image, literal data and fill runs. Pages are patched in place on
+the device, so copies only read old pages which are not written before. The page order (ascending or
+descending) resulting in the smaller patch is used. A compressed image is a patch without old image.
+
+Every generated patch is applied to the old image with the same rules as the device and compared
+with the new image, so a patch is only written if it reproduces the new image bit-exactly.
+
+Usage:
+  franklyboot_patch.py --board g431 make old.bin new.bin patch.bin
+  franklyboot_patch.py --board g431 compress new.bin image.bin
+  franklyboot_patch.py --board g431 apply old.bin patch.bin new.bin
+
+Copyright (c) 2022 - BSD-3-clause - FRANCOR e.V.
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+
+MAGIC = 0x31504246  # "FBP1"
+
+OP_END = 0
+OP_COPY = 1
+OP_LITERAL = 2
+OP_FILL = 3
+OP_MATCH = 4
+
+TOKEN_LENGTH_MASK = 0x1F  # Length in the token byte, 31 is followed by a varint
+KEY_SIZE = 4  # Size of the match index key
+MAX_CANDIDATES = 32  # Old positions per key searched for a match
+
+# Page size and first application page of the boards (see device_defines.h)
+BOARDS = {
+    "g431": {"page_size": 2048, "first_page": 4},
+    "f303": {"page_size": 2048, "first_page": 4},
+    "l431": {"page_size": 2048, "first_page": 4},
+    "pico": {"page_size": 4096, "first_page": 32},
+}
+
+
+def encode_token(op, length):
+    if length < TOKEN_LENGTH_MASK:
+        return bytes([(op << 5) | length])
+    return bytes([(op << 5) | TOKEN_LENGTH_MASK]) + encode_varint(length - TOKEN_LENGTH_MASK)
+
+
+def encode_varint(value):
+    data = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            data.append(byte | 0x80)
+        else:
+            data.append(byte)
+            return bytes(data)
+
+
+def decode_varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def zigzag(value):
+    return (value << 1) if value >= 0 else ((-value << 1) - 1)
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+class PatchGenerator:
+    def __init__(self, old, page_size, first_page):
+        self.page_size = page_size
+        self.first_page = first_page
+        self.old_size = len(old) & ~0x3
+        self.old = old[: self.old_size]
+        self.old_index = create_index(self.old)
+
+    def make(self, new):
+        new = pad_image(new, self.page_size)
+        new_index = create_index(new)
+        changed = [idx for idx in range(len(new) // self.page_size) if self._page_changed(new, idx)]
+
+        patches = [self._make_patch(new, new_index, changed), self._make_patch(new, new_index, changed[::-1])]
+        return min(patches, key=len)
+
+    def _page_changed(self, new, idx):
+        start = idx * self.page_size
+        end = start + self.page_size
+        return (end > self.old_size) or (new[start:end] != self.old[start:end])
+
+    def _make_patch(self, new, new_index, order):
+        old_crc = zlib.crc32(self.old) if self.old_size else 0
+        patch = bytearray(struct.pack("<IIII", MAGIC, self.page_size, self.old_size, old_crc))
+        written = set()
+
+        for idx in order:
+            page = new[idx * self.page_size : (idx + 1) * self.page_size]
+            patch += encode_varint(self.first_page + idx)
+            patch += self._encode_page(new, new_index, idx, written)
+            patch += encode_token(OP_END, 0) + struct.pack("<I", zlib.crc32(page))
+            written.add(idx)
+
+        return bytes(patch)
+
+    def _encode_page(self, new, new_index, idx, written):
+        data = bytearray()
+        literal = bytearray()
+        pos = idx * self.page_size
+        end = pos + self.page_size
+        state = {"copy_src": None, "match_offset": None}
+
+        def flush_literal():
+            if literal:
+                data.extend(encode_token(OP_LITERAL, len(literal)) + literal)
+                literal.clear()
+
+        while pos < end:
+            op, src, length, saving = self._find_operation(new, new_index, pos, end, idx, written, state)
+
+            # Lazy evaluation: emit a literal if the next position yields a better operation
+            if (saving > 0) and (pos + 1 < end):
+                next_saving = self._find_operation(new, new_index, pos + 1, end, idx, written, state)[3]
+                if next_saving > saving + 1:
+                    saving = 0
+
+            if saving <= 0:
+                literal.append(new[pos])
+                pos += 1
+                continue
+
+            flush_literal()
+            if op == OP_FILL:
+                data.extend(encode_token(OP_FILL, length) + bytes([new[pos]]))
+            else:
+                data.extend(encode_token(op, length) + encode_varint(zigzag(src - pos)))
+                if op == OP_COPY:
+                    state["copy_src"] = src + length
+                else:
+                    state["match_offset"] = src - pos
+            pos += length
+
+        flush_literal()
+        return data
+
+    def _find_operation(self, new, new_index, pos, end, idx, written, state):
+        """Returns operation with the highest saving compared to literal data (op, src, length, saving)"""
+        best = (OP_LITERAL, 0, 1, 0)
+
+        def consider(op, src, length):
+            nonlocal best
+            if length == 0:
+                return
+            cost = len(encode_token(op, length)) + (1 if op == OP_FILL else len(encode_varint(zigzag(src - pos))))
+            if length - cost - 1 > best[3]:
+                best = (op, src, length, length - cost - 1)
+
+        run = 1
+        while (pos + run < end) and (new[pos + run] == new[pos]):
+            run += 1
+        consider(OP_FILL, 0, run)
+
+        # Copy from old image (not overwritten pages)
+        copy_candidates = [state["copy_src"]] if state["copy_src"] is not None else []
+        copy_candidates += reversed(self.old_index.get(new[pos : pos + KEY_SIZE], [])[-MAX_CANDIDATES:])
+        for src in copy_candidates:
+            consider(OP_COPY, src, self._copy_length(new, pos, end, src, written))
+
+        # Match of new image (written pages, current page before the destination)
+        match_candidates = [pos + state["match_offset"]] if state["match_offset"] is not None else []
+        match_candidates += self._match_candidates(new, new_index, pos, idx, written)
+        for src in match_candidates:
+            consider(OP_MATCH, src, self._match_length(new, pos, end, src, idx, written))
+
+        return best
+
+    def _copy_length(self, new, pos, end, src, written):
+        length = 0
+        while (
+            (pos + length < end)
+            and (src + length < self.old_size)
+            and (((src + length) // self.page_size) not in written)
+            and (new[pos + length] == self.old[src + length])
+        ):
+            length += 1
+        return length
+
+    def _match_candidates(self, new, new_index, pos, idx, written):
+        candidates = []
+        for src in reversed(new_index.get(new[pos : pos + KEY_SIZE], [])):
+            if ((src // self.page_size) in written) or ((src // self.page_size == idx) and (src < pos)):
+                candidates.append(src)
+                if len(candidates) == MAX_CANDIDATES:
+                    break
+        return candidates
+
+    def _match_length(self, new, pos, end, src, idx, written):
+        # Sources in the current page must precede the destination, overlapping matches repeat a pattern
+        if (src < 0) or ((src // self.page_size == idx) and (src >= pos)):
+            return 0
+
+        length = 0
+        while pos + length < end:
+            src_page = (src + length) // self.page_size
+            if ((src_page not in written) and (src_page != idx)) or (new[pos + length] != new[src + length]):
+                break
+            length += 1
+        return length
+
+
+def create_index(image):
+    """Returns positions of the image by key"""
+    index = {}
+    for pos in range(len(image) - KEY_SIZE + 1):
+        index.setdefault(image[pos : pos + KEY_SIZE], []).append(pos)
+    return index
+
+
+def pad_image(image, page_size):
+    return bytes(image) + b"\xff" * (-len(image) % page_size)
+
+
+def apply_patch(old, patch, page_size, first_page):
+    """Applies the patch in place to the old image with the same checks as the device"""
+    magic, patch_page_size, old_size, old_crc = struct.unpack_from("<IIII", patch, 0)
+    if (magic != MAGIC) or (patch_page_size != page_size) or (old_size > len(old)) or (old_size % 4):
+        raise ValueError("invalid patch header")
+    if zlib.crc32(old[:old_size]) != old_crc:
+        raise ValueError("old image does not match patch")
+
+    flash = bytearray(old)
+    written = set()
+    pos = 16
+
+    while pos < len(patch):
+        page_id, pos = decode_varint(patch, pos)
+        idx = page_id - first_page
+        if (idx < 0) or (idx in written):
+            raise ValueError("invalid page id {}".format(page_id))
+
+        page = bytearray()
+        while True:
+            op = patch[pos] >> 5
+            length = patch[pos] & TOKEN_LENGTH_MASK
+            pos += 1
+            if op == OP_END:
+                if length:
+                    raise ValueError("invalid end of page {}".format(page_id))
+                break
+
+            if length == TOKEN_LENGTH_MASK:
+                extension, pos = decode_varint(patch, pos)
+                length += extension
+            if (length == 0) or (len(page) + length > page_size):
+                raise ValueError("operation exceeds page {}".format(page_id))
+
+            if op == OP_COPY:
+                offset, pos = decode_varint(patch, pos)
+                src = idx * page_size + len(page) + unzigzag(offset)
+                if (src < 0) or (src + length > old_size):
+                    raise ValueError("copy outside of old image")
+                src_pages = range(src // page_size, (src + length - 1) // page_size + 1)
+                if any(page_idx in written for page_idx in src_pages):
+                    raise ValueError("copy from page written before")
+                page += flash[src : src + length]
+            elif op == OP_LITERAL:
+                page += patch[pos : pos + length]
+                pos += length
+            elif op == OP_FILL:
+                page += bytes([patch[pos]]) * length
+                pos += 1
+            elif op == OP_MATCH:
+                offset, pos = decode_varint(patch, pos)
+                start = idx * page_size
+                src = start + len(page) + unzigzag(offset)
+                for _ in range(length):
+                    if start <= src < start + len(page):
+                        page.append(page[src - start])
+                    elif (src >= 0) and ((src // page_size) in written):
+                        page.append(flash[src])
+                    else:
+                        raise ValueError("match outside of new image written before")
+                    src += 1
+            else:
+                raise ValueError("invalid operation {}".format(op))
+
+        (page_crc,) = struct.unpack_from("<I", patch, pos)
+        pos += 4
+        if (len(page) != page_size) or (zlib.crc32(page) != page_crc):
+            raise ValueError("CRC of page {} does not match".format(page_id))
+
+        start = idx * page_size
+        if len(flash) < start + page_size:
+            flash += b"\xff" * (start + page_size - len(flash))
+        flash[start : start + page_size] = page
+        written.add(idx)
+
+    return bytes(flash)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Frankly bootloader delta patch and compressed image generator")
+    parser.add_argument("--board", choices=sorted(BOARDS.keys()), default="g431")
+    parser.add_argument("--page-size", type=int, help="override page size of the board")
+    parser.add_argument("--first-page", type=int, help="override first application page of the board")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    make_parser = commands.add_parser("make", help="create patch from old to new image")
+    make_parser.add_argument("old", help="old application image")
+    make_parser.add_argument("new", help="new application image")
+    make_parser.add_argument("patch", help="patch output")
+
+    compress_parser = commands.add_parser("compress", help="create compressed image (patch without old image)")
+    compress_parser.add_argument("new", help="new application image")
+    compress_parser.add_argument("patch", help="compressed image output")
+
+    apply_parser = commands.add_parser("apply", help="apply patch or compressed image")
+    apply_parser.add_argument("old", help="old application image (empty file for a compressed image)")
+    apply_parser.add_argument("patch", help="patch or compressed image")
+    apply_parser.add_argument("new", help="new application image output")
+
+    args = parser.parse_args()
+
+    page_size = args.page_size or BOARDS[args.board]["page_size"]
+    first_page = args.first_page if args.first_page is not None else BOARDS[args.board]["first_page"]
+
+    old = b""
+    if args.command in ("make", "apply"):
+        with open(args.old, "rb") as file:
+            old = file.read()
+
+    if args.command in ("make", "compress"):
+        with open(args.new, "rb") as file:
+            new = pad_image(file.read(), page_size)
+
+        patch = PatchGenerator(old, page_size, first_page).make(new)
+
+        # Patch must reproduce the new image bit-exactly
+        if apply_patch(old, patch, page_size, first_page)[: len(new)] != new:
+            sys.exit("error: patch does not reproduce the new image")
+
+        ratio = 100.0 * len(patch) / len(new)
+        print("patch: {} bytes, image: {} bytes ({:.1f} %)".format(len(patch), len(new), ratio))
+
+        with open(args.patch, "wb") as file:
+            file.write(patch)
+    else:
+        with open(args.patch, "rb") as file:
+            patch = file.read()
+
+        with open(args.new, "wb") as file:
+            file.write(apply_patch(old, patch, page_size, first_page))
+
+
+if __name__ == "__main__":
+    main()